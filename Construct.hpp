@@ -2,26 +2,88 @@
 
 #include <vector>
 #include <cstdint>
+#include <filesystem>
 
+#include "internal/GeneratorContext.hpp"
 #include "internal/GeneratorSetting.hpp"
 #include "internal/Mesh.hpp"
+#include "internal/MeshFile.hpp"
+#include "internal/MorphTarget.hpp"
+#include "internal/Tessellation.hpp"
 
 namespace Construct
 {
+	// Every generator is a template over the index type of the mesh, 32-bit by default.
+	// 16, 32 and 64-bit indices are instantiated, generating more vertices than the index type can address throws std::overflow_error
+	// Every generator has an overload taking a GeneratorContext first, which reuses buffers so repeated generation doesn't allocate
 	/// <summary>
 	/// Generates a Quad mesh facing the +z direction
 	/// </summary>
 	/// <param name="settings">Setting that affect how the mesh is generated</param>
 	/// <returns>Mesh data for the Quad</returns>
-	Mesh Quad(const GeneratorSetting& settings = GeneratorSetting());
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> Quad(const GeneratorSetting& settings = GeneratorSetting());
+	/// <summary>
+	/// Generates a Quad mesh facing the +z direction
+	/// </summary>
+	/// <param name="context">Context whose buffers are reused, see GeneratorContext</param>
+	/// <param name="settings">Setting that affect how the mesh is generated</param>
+	/// <returns>Mesh data for the Quad</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> Quad(GeneratorContext& context, const GeneratorSetting& settings = GeneratorSetting());
+	/// <summary>
+	/// Generates a Plane mesh facing the +y direction
+	/// </summary>
+	/// <param name="widthTiles">Number of tiles along the width</param>
+	/// <param name="heightTiles">Number of tiles along the height</param>
+	/// <param name="settings">Setting that affect how the mesh is generated</param>
+	/// <returns>Mesh data for the Plane</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> Plane(std::uint32_t widthTiles, std::uint32_t heightTiles, const GeneratorSetting& settings = GeneratorSetting());
 	/// <summary>
 	/// Generates a Plane mesh facing the +y direction
 	/// </summary>
+	/// <param name="context">Context whose buffers are reused, see GeneratorContext</param>
 	/// <param name="widthTiles">Number of tiles along the width</param>
 	/// <param name="heightTiles">Number of tiles along the height</param>
 	/// <param name="settings">Setting that affect how the mesh is generated</param>
 	/// <returns>Mesh data for the Plane</returns>
-	Mesh Plane(std::uint32_t widthTiles, std::uint32_t heightTiles, const GeneratorSetting& settings = GeneratorSetting());
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> Plane(GeneratorContext& context, std::uint32_t widthTiles, std::uint32_t heightTiles, const GeneratorSetting& settings = GeneratorSetting());
+	/// <summary>
+	/// Generates a Plane mesh with the morph target of every vertex on the Plane with half the tiles along each side, in the same pass.
+	/// Throws std::invalid_argument if either tile count is odd
+	/// </summary>
+	/// <param name="widthTiles">Number of tiles along the width, must be even</param>
+	/// <param name="heightTiles">Number of tiles along the height, must be even</param>
+	/// <param name="settings">Setting that affect how the mesh is generated</param>
+	/// <returns>Mesh data for the Plane and its morph target</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMorphMesh<IndexType> PlaneMorph(std::uint32_t widthTiles, std::uint32_t heightTiles, const GeneratorSetting& settings = GeneratorSetting());
+	/// <summary>
+	/// Generates a Plane mesh with the morph target of every vertex on the Plane with half the tiles along each side, in the same pass.
+	/// Throws std::invalid_argument if either tile count is odd
+	/// </summary>
+	/// <param name="context">Context whose buffers are reused, see GeneratorContext</param>
+	/// <param name="widthTiles">Number of tiles along the width, must be even</param>
+	/// <param name="heightTiles">Number of tiles along the height, must be even</param>
+	/// <param name="settings">Setting that affect how the mesh is generated</param>
+	/// <returns>Mesh data for the Plane and its morph target</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMorphMesh<IndexType> PlaneMorph(GeneratorContext& context, std::uint32_t widthTiles, std::uint32_t heightTiles, const GeneratorSetting& settings = GeneratorSetting());
+	/// <summary>
+	/// Generates a Plane straight into a mesh file, for planes larger than memory.
+	/// The file holds exactly what Plane would return, only windowBytes of each buffer is mapped at a time.
+	/// Throws std::system_error if the file can't be written
+	/// </summary>
+	/// <param name="widthTiles">Number of tiles along the width</param>
+	/// <param name="heightTiles">Number of tiles along the height</param>
+	/// <param name="path">Path of the mesh file, overwritten if it exists</param>
+	/// <param name="settings">Setting that affect how the mesh is generated</param>
+	/// <param name="windowBytes">Bytes of each buffer mapped at once</param>
+	/// <returns>Header of the written file</returns>
+	template <typename IndexType = std::uint32_t>
+	MeshFileHeader PlaneToFile(std::uint32_t widthTiles, std::uint32_t heightTiles, const std::filesystem::path& path, const GeneratorSetting& settings = GeneratorSetting(), std::size_t windowBytes = DefaultMeshFileWindow);
 	/// <summary>
 	/// Generates a Polygon mesh facing the +z direction.
 	/// High side counts can be used to generate circles
@@ -29,16 +91,56 @@ namespace Construct
 	/// <param name="sides">Number of sides for the polygon</param>
 	/// <param name="settings">Setting that affect how the mesh is generated</param>
 	/// <returns>Mesh data for the Polygon</returns>
-	Mesh Polygon(std::uint32_t sides, const GeneratorSetting& settings = GeneratorSetting());
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> Polygon(std::uint32_t sides, const GeneratorSetting& settings = GeneratorSetting());
+	/// <summary>
+	/// Generates a Polygon mesh facing the +z direction.
+	/// High side counts can be used to generate circles
+	/// </summary>
+	/// <param name="context">Context whose buffers are reused, see GeneratorContext</param>
+	/// <param name="sides">Number of sides for the polygon</param>
+	/// <param name="settings">Setting that affect how the mesh is generated</param>
+	/// <returns>Mesh data for the Polygon</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> Polygon(GeneratorContext& context, std::uint32_t sides, const GeneratorSetting& settings = GeneratorSetting());
+	/// <summary>
+	/// Generates a Polygon mesh facing the +z direction with the fewest sides that stay within a chordal error of a circle
+	/// </summary>
+	/// <param name="maxError">Maximum distance between the edges and the circle, in world units after scaling</param>
+	/// <param name="settings">Setting that affect how the mesh is generated</param>
+	/// <returns>Mesh data for the Polygon</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> Polygon(ChordalError maxError, const GeneratorSetting& settings = GeneratorSetting());
+	/// <summary>
+	/// Generates a Polygon mesh facing the +z direction with the fewest sides that stay within a chordal error of a circle
+	/// </summary>
+	/// <param name="context">Context whose buffers are reused, see GeneratorContext</param>
+	/// <param name="maxError">Maximum distance between the edges and the circle, in world units after scaling</param>
+	/// <param name="settings">Setting that affect how the mesh is generated</param>
+	/// <returns>Mesh data for the Polygon</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> Polygon(GeneratorContext& context, ChordalError maxError, const GeneratorSetting& settings = GeneratorSetting());
+	/// <summary>
+	/// Generates a Cube mesh
+	/// Uses a 6x1 texture layout with the texture being in the order:
+	/// Left, Front, Right, Back, Top, Bottom
+	/// (-x, +z, +x, -x, +y, -y)
+	/// </summary>
+	/// <param name="settings">Settings that affect how the mesh is generated</param>
+	/// <returns>Mesh data for the Cube</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> Cube(const GeneratorSetting& settings = GeneratorSetting());
 	/// <summary>
 	/// Generates a Cube mesh
 	/// Uses a 6x1 texture layout with the texture being in the order:
 	/// Left, Front, Right, Back, Top, Bottom
 	/// (-x, +z, +x, -x, +y, -y)
 	/// </summary>
+	/// <param name="context">Context whose buffers are reused, see GeneratorContext</param>
 	/// <param name="settings">Settings that affect how the mesh is generated</param>
 	/// <returns>Mesh data for the Cube</returns>
-	Mesh Cube(const GeneratorSetting& settings = GeneratorSetting());
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> Cube(GeneratorContext& context, const GeneratorSetting& settings = GeneratorSetting());
 	/// <summary>
 	/// Generates a UV Sphere mesh
 	/// Uses an equirectangular texture layout
@@ -47,31 +149,272 @@ namespace Construct
 	/// <param name="segments">Number of latitude lines</param>
 	/// <param name="settings">Settings that affect how the mesh is generated</param>
 	/// <returns>Mesh data for a UVSphere</returns>
-	Mesh UVSphere(std::uint32_t rings, std::uint32_t segments, const GeneratorSetting& settings = GeneratorSetting());
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> UVSphere(std::uint32_t rings, std::uint32_t segments, const GeneratorSetting& settings = GeneratorSetting());
+	/// <summary>
+	/// Generates a UV Sphere mesh
+	/// Uses an equirectangular texture layout
+	/// </summary>
+	/// <param name="context">Context whose buffers are reused, see GeneratorContext</param>
+	/// <param name="rings">Number of longitude lines</param>
+	/// <param name="segments">Number of latitude lines</param>
+	/// <param name="settings">Settings that affect how the mesh is generated</param>
+	/// <returns>Mesh data for a UVSphere</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> UVSphere(GeneratorContext& context, std::uint32_t rings, std::uint32_t segments, const GeneratorSetting& settings = GeneratorSetting());
+	/// <summary>
+	/// Generates a UV Sphere mesh with the fewest rings and segments that stay within a chordal error of the sphere.
+	/// Rings and segments are chosen separately, so stretching the sphere along y only adds rings
+	/// </summary>
+	/// <param name="maxError">Maximum distance between the faces and the sphere, in world units after scaling</param>
+	/// <param name="settings">Settings that affect how the mesh is generated</param>
+	/// <returns>Mesh data for a UVSphere</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> UVSphere(ChordalError maxError, const GeneratorSetting& settings = GeneratorSetting());
+	/// <summary>
+	/// Generates a UV Sphere mesh with the fewest rings and segments that stay within a chordal error of the sphere.
+	/// Rings and segments are chosen separately, so stretching the sphere along y only adds rings
+	/// </summary>
+	/// <param name="context">Context whose buffers are reused, see GeneratorContext</param>
+	/// <param name="maxError">Maximum distance between the faces and the sphere, in world units after scaling</param>
+	/// <param name="settings">Settings that affect how the mesh is generated</param>
+	/// <returns>Mesh data for a UVSphere</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> UVSphere(GeneratorContext& context, ChordalError maxError, const GeneratorSetting& settings = GeneratorSetting());
+	/// <summary>
+	/// Generates an Icosphere mesh
+	/// TODO Select texture layout for Cylinder
+	/// </summary>
+	/// <param name="subdivisions">Number of subdivisions, leave 0 for base case (icosahedron)</param>
+	/// <param name="settings">Settings that affect how the mesh is generated</param>
+	/// <returns>Mesh data for an Icosphere</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> Icosphere(std::uint32_t subdivisions, const GeneratorSetting& settings = GeneratorSetting());
 	/// <summary>
 	/// Generates an Icosphere mesh
 	/// TODO Select texture layout for Cylinder
 	/// </summary>
+	/// <param name="context">Context whose buffers are reused, see GeneratorContext</param>
 	/// <param name="subdivisions">Number of subdivisions, leave 0 for base case (icosahedron)</param>
 	/// <param name="settings">Settings that affect how the mesh is generated</param>
 	/// <returns>Mesh data for an Icosphere</returns>
-	Mesh Icosphere(std::uint32_t subdivisions, const GeneratorSetting& settings = GeneratorSetting());
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> Icosphere(GeneratorContext& context, std::uint32_t subdivisions, const GeneratorSetting& settings = GeneratorSetting());
+	/// <summary>
+	/// Generates an Icosphere mesh with the morph target of every vertex on the Icosphere with one subdivision less.
+	/// Vertices added by the last subdivision morph to the middle of the edge they split, the others to themselves
+	/// </summary>
+	/// <param name="subdivisions">Number of subdivisions, with 0 every vertex is its own morph target</param>
+	/// <param name="settings">Settings that affect how the mesh is generated</param>
+	/// <returns>Mesh data for an Icosphere and its morph target</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMorphMesh<IndexType> IcosphereMorph(std::uint32_t subdivisions, const GeneratorSetting& settings = GeneratorSetting());
+	/// <summary>
+	/// Generates an Icosphere mesh with the morph target of every vertex on the Icosphere with one subdivision less.
+	/// Vertices added by the last subdivision morph to the middle of the edge they split, the others to themselves
+	/// </summary>
+	/// <param name="context">Context whose buffers are reused, see GeneratorContext</param>
+	/// <param name="subdivisions">Number of subdivisions, with 0 every vertex is its own morph target</param>
+	/// <param name="settings">Settings that affect how the mesh is generated</param>
+	/// <returns>Mesh data for an Icosphere and its morph target</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMorphMesh<IndexType> IcosphereMorph(GeneratorContext& context, std::uint32_t subdivisions, const GeneratorSetting& settings = GeneratorSetting());
+	/// <summary>
+	/// Generates an Icosphere mesh with the fewest subdivisions that stay within a chordal error of the sphere
+	/// </summary>
+	/// <param name="maxError">Maximum distance between the faces and the sphere, in world units after scaling</param>
+	/// <param name="settings">Settings that affect how the mesh is generated</param>
+	/// <returns>Mesh data for an Icosphere</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> Icosphere(ChordalError maxError, const GeneratorSetting& settings = GeneratorSetting());
+	/// <summary>
+	/// Generates an Icosphere mesh with the fewest subdivisions that stay within a chordal error of the sphere
+	/// </summary>
+	/// <param name="context">Context whose buffers are reused, see GeneratorContext</param>
+	/// <param name="maxError">Maximum distance between the faces and the sphere, in world units after scaling</param>
+	/// <param name="settings">Settings that affect how the mesh is generated</param>
+	/// <returns>Mesh data for an Icosphere</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> Icosphere(GeneratorContext& context, ChordalError maxError, const GeneratorSetting& settings = GeneratorSetting());
+	/// <summary>
+	/// Generates an Icosphere straight into a mesh file, for spheres larger than memory.
+	/// Vertex positions and texture UVs match Icosphere, but each of the 20 base faces gets its own copy of its edge vertices,
+	/// so the file has IcosphereToFileVertexCount vertices. Normals point away from the center and tangents follow the texture layout of each face.
+	/// Only windowBytes of each buffer is mapped at a time, throws std::system_error if the file can't be written
+	/// </summary>
+	/// <param name="subdivisions">Number of subdivisions, leave 0 for base case (icosahedron)</param>
+	/// <param name="path">Path of the mesh file, overwritten if it exists</param>
+	/// <param name="settings">Settings that affect how the mesh is generated</param>
+	/// <param name="windowBytes">Bytes of each buffer mapped at once</param>
+	/// <returns>Header of the written file</returns>
+	template <typename IndexType = std::uint32_t>
+	MeshFileHeader IcosphereToFile(std::uint32_t subdivisions, const std::filesystem::path& path, const GeneratorSetting& settings = GeneratorSetting(), std::size_t windowBytes = DefaultMeshFileWindow);
+	/// <summary>
+	/// Generates a Cylinder mesh
+	/// TODO Select texture layout for Cylinder
+	/// </summary>
+	/// <param name="sides">Number of sides the cylinder mesh has</param>
+	/// <param name="settings">Settings that affect how the mesh is generated</param>
+	/// <returns>Mesh data for a Cylinder</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> Cylinder(std::uint32_t sides, const GeneratorSetting& settings = GeneratorSetting());
 	/// <summary>
 	/// Generates a Cylinder mesh
 	/// TODO Select texture layout for Cylinder
 	/// </summary>
+	/// <param name="context">Context whose buffers are reused, see GeneratorContext</param>
+	/// <param name="sides">Number of sides the cylinder mesh has</param>
+	/// <param name="settings">Settings that affect how the mesh is generated</param>
+	/// <returns>Mesh data for a Cylinder</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> Cylinder(GeneratorContext& context, std::uint32_t sides, const GeneratorSetting& settings = GeneratorSetting());
+	/// <summary>
+	/// Generates a Cylinder mesh with a given size and cap tessellation.
+	/// Always outputs a triangle list
+	/// </summary>
+	/// <param name="sides">Number of sides the cylinder mesh has</param>
+	/// <param name="capRings">Number of concentric rings in each cap, 0 generates an open tube</param>
+	/// <param name="radius">Radius of the cylinder, 0.5f by default</param>
+	/// <param name="height">Height of the cylinder, 1.0f by default</param>
+	/// <param name="settings">Settings that affect how the mesh is generated</param>
+	/// <returns>Mesh data for a Cylinder</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> Cylinder(std::uint32_t sides, std::uint32_t capRings, float radius, float height, const GeneratorSetting& settings = GeneratorSetting());
+	/// <summary>
+	/// Generates a Cylinder mesh with a given size and cap tessellation.
+	/// Always outputs a triangle list
+	/// </summary>
+	/// <param name="context">Context whose buffers are reused, see GeneratorContext</param>
 	/// <param name="sides">Number of sides the cylinder mesh has</param>
+	/// <param name="capRings">Number of concentric rings in each cap, 0 generates an open tube</param>
+	/// <param name="radius">Radius of the cylinder, 0.5f by default</param>
+	/// <param name="height">Height of the cylinder, 1.0f by default</param>
+	/// <param name="settings">Settings that affect how the mesh is generated</param>
+	/// <returns>Mesh data for a Cylinder</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> Cylinder(GeneratorContext& context, std::uint32_t sides, std::uint32_t capRings, float radius, float height, const GeneratorSetting& settings = GeneratorSetting());
+	/// <summary>
+	/// Generates a Cylinder mesh with the fewest sides that stay within a chordal error of the round body.
+	/// Only the x and z scale affect the number of sides
+	/// </summary>
+	/// <param name="maxError">Maximum distance between the faces and the cylinder, in world units after scaling</param>
+	/// <param name="settings">Settings that affect how the mesh is generated</param>
+	/// <returns>Mesh data for a Cylinder</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> Cylinder(ChordalError maxError, const GeneratorSetting& settings = GeneratorSetting());
+	/// <summary>
+	/// Generates a Cylinder mesh with the fewest sides that stay within a chordal error of the round body.
+	/// Only the x and z scale affect the number of sides
+	/// </summary>
+	/// <param name="context">Context whose buffers are reused, see GeneratorContext</param>
+	/// <param name="maxError">Maximum distance between the faces and the cylinder, in world units after scaling</param>
+	/// <param name="settings">Settings that affect how the mesh is generated</param>
+	/// <returns>Mesh data for a Cylinder</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> Cylinder(GeneratorContext& context, ChordalError maxError, const GeneratorSetting& settings = GeneratorSetting());
+	/// <summary>
+	/// Generates a Cylinder mesh with a given size and the fewest sides that stay within a chordal error of the round body.
+	/// Always outputs a triangle list
+	/// </summary>
+	/// <param name="maxError">Maximum distance between the faces and the cylinder, in world units after scaling</param>
+	/// <param name="radius">Radius of the cylinder</param>
+	/// <param name="height">Height of the cylinder</param>
+	/// <param name="settings">Settings that affect how the mesh is generated</param>
+	/// <returns>Mesh data for a Cylinder</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> Cylinder(ChordalError maxError, float radius, float height, const GeneratorSetting& settings = GeneratorSetting());
+	/// <summary>
+	/// Generates a Cylinder mesh with a given size and the fewest sides that stay within a chordal error of the round body.
+	/// Always outputs a triangle list
+	/// </summary>
+	/// <param name="context">Context whose buffers are reused, see GeneratorContext</param>
+	/// <param name="maxError">Maximum distance between the faces and the cylinder, in world units after scaling</param>
+	/// <param name="radius">Radius of the cylinder</param>
+	/// <param name="height">Height of the cylinder</param>
 	/// <param name="settings">Settings that affect how the mesh is generated</param>
 	/// <returns>Mesh data for a Cylinder</returns>
-	Mesh Cylinder(std::uint32_t sides, const GeneratorSetting& settings = GeneratorSetting());
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> Cylinder(GeneratorContext& context, ChordalError maxError, float radius, float height, const GeneratorSetting& settings = GeneratorSetting());
+	/// <summary>
+	/// Generates a Capsule mesh
+	/// TODO Select texture layout for capsule
+	/// </summary>
+	/// <param name="sides">Number of sides in the capsule mesh, this also affects the number of rings in the hemispheres</param>
+	/// <param name="settings">Settings that affect how the mesh is generated</param>
+	/// <returns>Mesh data for a Capsule</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> Capsule(std::uint32_t sides, const GeneratorSetting& settings = GeneratorSetting());
 	/// <summary>
 	/// Generates a Capsule mesh
 	/// TODO Select texture layout for capsule
 	/// </summary>
+	/// <param name="context">Context whose buffers are reused, see GeneratorContext</param>
 	/// <param name="sides">Number of sides in the capsule mesh, this also affects the number of rings in the hemispheres</param>
 	/// <param name="settings">Settings that affect how the mesh is generated</param>
 	/// <returns>Mesh data for a Capsule</returns>
-	Mesh Capsule(std::uint32_t sides, const GeneratorSetting& settings = GeneratorSetting());
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> Capsule(GeneratorContext& context, std::uint32_t sides, const GeneratorSetting& settings = GeneratorSetting());
+	/// <summary>
+	/// Generates a Capsule mesh with a given size and hemisphere tessellation
+	/// </summary>
+	/// <param name="sides">Number of sides in the capsule mesh</param>
+	/// <param name="capRings">Number of rings from the pole to the equator of each hemisphere, at least 1</param>
+	/// <param name="radius">Radius of the capsule, 0.5f by default</param>
+	/// <param name="height">Height of the cylindrical section between the hemisphere centers, 1.0f by default</param>
+	/// <param name="settings">Settings that affect how the mesh is generated</param>
+	/// <returns>Mesh data for a Capsule</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> Capsule(std::uint32_t sides, std::uint32_t capRings, float radius, float height, const GeneratorSetting& settings = GeneratorSetting());
+	/// <summary>
+	/// Generates a Capsule mesh with a given size and hemisphere tessellation
+	/// </summary>
+	/// <param name="context">Context whose buffers are reused, see GeneratorContext</param>
+	/// <param name="sides">Number of sides in the capsule mesh</param>
+	/// <param name="capRings">Number of rings from the pole to the equator of each hemisphere, at least 1</param>
+	/// <param name="radius">Radius of the capsule, 0.5f by default</param>
+	/// <param name="height">Height of the cylindrical section between the hemisphere centers, 1.0f by default</param>
+	/// <param name="settings">Settings that affect how the mesh is generated</param>
+	/// <returns>Mesh data for a Capsule</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> Capsule(GeneratorContext& context, std::uint32_t sides, std::uint32_t capRings, float radius, float height, const GeneratorSetting& settings = GeneratorSetting());
+	/// <summary>
+	/// Generates a Capsule mesh with the fewest sides and hemisphere rings that stay within a chordal error of the capsule
+	/// </summary>
+	/// <param name="maxError">Maximum distance between the faces and the capsule, in world units after scaling</param>
+	/// <param name="settings">Settings that affect how the mesh is generated</param>
+	/// <returns>Mesh data for a Capsule</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> Capsule(ChordalError maxError, const GeneratorSetting& settings = GeneratorSetting());
+	/// <summary>
+	/// Generates a Capsule mesh with the fewest sides and hemisphere rings that stay within a chordal error of the capsule
+	/// </summary>
+	/// <param name="context">Context whose buffers are reused, see GeneratorContext</param>
+	/// <param name="maxError">Maximum distance between the faces and the capsule, in world units after scaling</param>
+	/// <param name="settings">Settings that affect how the mesh is generated</param>
+	/// <returns>Mesh data for a Capsule</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> Capsule(GeneratorContext& context, ChordalError maxError, const GeneratorSetting& settings = GeneratorSetting());
+	/// <summary>
+	/// Generates a Capsule mesh with a given size and the fewest sides and hemisphere rings that stay within a chordal error of the capsule
+	/// </summary>
+	/// <param name="maxError">Maximum distance between the faces and the capsule, in world units after scaling</param>
+	/// <param name="radius">Radius of the capsule</param>
+	/// <param name="height">Height of the cylindrical section between the hemisphere centers</param>
+	/// <param name="settings">Settings that affect how the mesh is generated</param>
+	/// <returns>Mesh data for a Capsule</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> Capsule(ChordalError maxError, float radius, float height, const GeneratorSetting& settings = GeneratorSetting());
+	/// <summary>
+	/// Generates a Capsule mesh with a given size and the fewest sides and hemisphere rings that stay within a chordal error of the capsule
+	/// </summary>
+	/// <param name="context">Context whose buffers are reused, see GeneratorContext</param>
+	/// <param name="maxError">Maximum distance between the faces and the capsule, in world units after scaling</param>
+	/// <param name="radius">Radius of the capsule</param>
+	/// <param name="height">Height of the cylindrical section between the hemisphere centers</param>
+	/// <param name="settings">Settings that affect how the mesh is generated</param>
+	/// <returns>Mesh data for a Capsule</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> Capsule(GeneratorContext& context, ChordalError maxError, float radius, float height, const GeneratorSetting& settings = GeneratorSetting());
 
 	/// <summary>
 	/// Generates a Skybox Cube
@@ -81,14 +424,88 @@ namespace Construct
 	/// </summary>
 	/// <param name="settings">Settings that affect how the mesh is generated</param>
 	/// <returns>Mesh data for a Skybox Cube</returns>
-	Mesh SkyboxCube(const GeneratorSetting& settings = GeneratorSetting(WindingOrder::CW));
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> SkyboxCube(const GeneratorSetting& settings = GeneratorSetting(WindingOrder::CW));
+	/// <summary>
+	/// Generates a Skybox Cube
+	/// Uses a 6x1 texture layout with the texture being in the order:
+	/// Left, Front, Right, Back, Top, Bottom
+	/// (-x, +z, +x, -x, +y, -y)
+	/// </summary>
+	/// <param name="context">Context whose buffers are reused, see GeneratorContext</param>
+	/// <param name="settings">Settings that affect how the mesh is generated</param>
+	/// <returns>Mesh data for a Skybox Cube</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> SkyboxCube(GeneratorContext& context, const GeneratorSetting& settings = GeneratorSetting(WindingOrder::CW));
+	/// <summary>
+	/// Generates a Skybox Sphere
+	/// Uses an equirectangular texture layout
+	/// </summary>
+	/// <param name="rings">Number of longitude lines</param>
+	/// <param name="segments">Number of latitude lines</param>
+	/// <param name="settings">Settings that affect how the mesh is generated</param>
+	/// <returns>Mesh data for a Skybox Sphere</returns>
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> SkyboxSphere(std::uint32_t rings, std::uint32_t segments, const GeneratorSetting& settings = GeneratorSetting(WindingOrder::CW));
 	/// <summary>
 	/// Generates a Skybox Sphere
 	/// Uses an equirectangular texture layout
 	/// </summary>
+	/// <param name="context">Context whose buffers are reused, see GeneratorContext</param>
 	/// <param name="rings">Number of longitude lines</param>
 	/// <param name="segments">Number of latitude lines</param>
 	/// <param name="settings">Settings that affect how the mesh is generated</param>
 	/// <returns>Mesh data for a Skybox Sphere</returns>
-	Mesh SkyboxSphere(std::uint32_t rings, std::uint32_t segments, const GeneratorSetting& settings = GeneratorSetting(WindingOrder::CW));
+	template <typename IndexType = std::uint32_t>
+	BasicMesh<IndexType> SkyboxSphere(GeneratorContext& context, std::uint32_t rings, std::uint32_t segments, const GeneratorSetting& settings = GeneratorSetting(WindingOrder::CW));
+
+	/// <summary>
+	/// Number of vertices Plane generates
+	/// </summary>
+	std::uint64_t PlaneVertexCount(std::uint32_t widthTiles, std::uint32_t heightTiles);
+	/// <summary>
+	/// Number of vertices Polygon generates
+	/// </summary>
+	std::uint64_t PolygonVertexCount(std::uint32_t sides);
+	/// <summary>
+	/// Upper bound on the number of vertices UVSphere generates, triangle lists lose their unused pole vertices
+	/// </summary>
+	std::uint64_t UVSphereVertexCount(std::uint32_t rings, std::uint32_t segments);
+	/// <summary>
+	/// Upper bound on the number of vertices Icosphere generates, exact when texture UVs are generated
+	/// </summary>
+	std::uint64_t IcosphereVertexCount(std::uint32_t subdivisions);
+	/// <summary>
+	/// Number of vertices IcosphereToFile writes
+	/// </summary>
+	std::uint64_t IcosphereToFileVertexCount(std::uint32_t subdivisions);
+	/// <summary>
+	/// Number of vertices Cylinder generates, Cylinder(sides) has 1 cap ring
+	/// </summary>
+	std::uint64_t CylinderVertexCount(std::uint32_t sides, std::uint32_t capRings = 1);
+	/// <summary>
+	/// Upper bound on the number of vertices Capsule generates, Capsule(sides) has sides / 2 cap rings.
+	/// Triangle lists lose their unused pole vertices
+	/// </summary>
+	std::uint64_t CapsuleVertexCount(std::uint32_t sides, std::uint32_t capRings);
+	/// <summary>
+	/// Runs a generator with the smallest index type that can address a number of vertices.
+	/// For example GenerateWithSmallestIndex(PlaneVertexCount(w, h), [&]&lt;typename IndexType&gt;() { return Plane&lt;IndexType&gt;(w, h); })
+	/// </summary>
+	/// <param name="vertexCount">Predicted number of vertices, usually from one of the VertexCount functions</param>
+	/// <param name="generator">Templated callable taking the index type as its template argument and returning the mesh</param>
+	/// <returns>The generated mesh, holding a Mesh16, Mesh or Mesh64</returns>
+	template <typename Generator>
+	inline AnyMesh GenerateWithSmallestIndex(std::uint64_t vertexCount, Generator&& generator)
+	{
+		if (vertexCount <= MaxVertexCount<std::uint16_t>)
+		{
+			return generator.template operator()<std::uint16_t>();
+		}
+		if (vertexCount <= MaxVertexCount<std::uint32_t>)
+		{
+			return generator.template operator()<std::uint32_t>();
+		}
+		return generator.template operator()<std::uint64_t>();
+	}
 }
\ No newline at end of file
@@ -1,25 +1,111 @@
 #include "../Construct.hpp"
 
 #include "../internal/ProcessMesh.hpp"
-#include "../internal/CalculateNormals.hpp"
 
 #include "../internal/CapsuleHead.hpp"
 #include "../internal/CylinderBody.hpp"
-#include "../utils/Merge.hpp"
+#include "../utils/Compact.hpp"
+
+#include <numbers>
 
 namespace Construct
 {
-	Mesh Capsule(std::uint32_t sides, const GeneratorSetting& settings)
-	{
-		// Get parts of mesh
-		Mesh capsuleHead = internal::CapsuleHead(sides);
-		Mesh cylinderBody = internal::CylinderBody(sides);
-		// Merge meshes together
-		Mesh mesh = Merge({ &capsuleHead, &cylinderBody });
-		// Calculate normals
-		mesh.normals = internal::CalculateNormals(mesh.vertices, mesh.indices);
+	std::uint64_t CapsuleVertexCount(std::uint32_t sides, std::uint32_t capRings)
+	{
+		return internal::CheckedAdd(internal::CapsuleHeadVertexCount(sides, capRings), internal::CylinderBodyVertexCount(sides));
+	}
+	template <typename IndexType>
+	BasicMesh<IndexType> Capsule(std::uint32_t sides, const GeneratorSetting& settings)
+	{
+		GeneratorContext context;
+		return Capsule<IndexType>(context, sides, settings);
+	}
+	template <typename IndexType>
+	BasicMesh<IndexType> Capsule(GeneratorContext& context, std::uint32_t sides, const GeneratorSetting& settings)
+	{
+		return Capsule<IndexType>(context, sides, sides / 2, 0.5f, 1.0f, settings);
+	}
+	template <typename IndexType>
+	BasicMesh<IndexType> Capsule(std::uint32_t sides, std::uint32_t capRings, float radius, float height, const GeneratorSetting& settings)
+	{
+		GeneratorContext context;
+		return Capsule<IndexType>(context, sides, capRings, radius, height, settings);
+	}
+	template <typename IndexType>
+	BasicMesh<IndexType> Capsule(GeneratorContext& context, std::uint32_t sides, std::uint32_t capRings, float radius, float height, const GeneratorSetting& settings)
+	{
+		const std::size_t vertexCount = internal::CheckedVertexCount<IndexType>(CapsuleVertexCount(sides, capRings));
+		const IndexType headVertexCount = static_cast<IndexType>(internal::CapsuleHeadVertexCount(sides, capRings));
+		const std::size_t indexCount = internal::CheckedIndexCount<IndexType>(internal::CheckedAdd(internal::CapsuleHeadIndexCount(sides, capRings, settings.topology), internal::CylinderBodyIndexCount(sides, settings.topology)));
+		// Lists need their indices to drop the triangles at the poles
+		const bool writeIndices = settings.generateIndices || settings.topology == Topology::TriangleList;
+		// Preallocate everything once, parts are written directly into place
+		// Parts skip any attribute that is left unallocated
+		BasicMesh<IndexType> mesh = context.NewMesh<IndexType>(3 * vertexCount, writeIndices ? indexCount : 0,
+			settings.HasAttribute(VertexAttribute::Normal) ? 3 * vertexCount : 0,
+			settings.HasAttribute(VertexAttribute::TextureUV) ? 2 * vertexCount : 0,
+			settings.HasAttribute(VertexAttribute::Tangent) ? 4 * vertexCount : 0);
+		mesh.topology = settings.topology;
+		// Strips are wound here as ProcessMesh only flips triangle lists
+		const bool flip = settings.topology == Topology::TriangleStrip && settings.windingOrder == WindingOrder::CW;
+		IndexType* indexOutput = writeIndices ? mesh.indices.data() : nullptr;
+		indexOutput = internal::CapsuleHead<IndexType>(mesh, 0, indexOutput, sides, capRings, radius, height, flip, settings.topology);
+		internal::CylinderBody(mesh, headVertexCount, indexOutput, sides, radius, height, flip, settings.topology);
+		// Remove the zero area triangles at the poles, strips are kept whole
+		if (mesh.topology == Topology::TriangleList)
+		{
+			Compact(mesh, context);
+		}
 		// Process mesh for transforms
 		internal::ProcessMesh(mesh, settings);
 		return mesh;
 	}
-}
\ No newline at end of file
+	template <typename IndexType>
+	BasicMesh<IndexType> Capsule(ChordalError maxError, const GeneratorSetting& settings)
+	{
+		GeneratorContext context;
+		return Capsule<IndexType>(context, maxError, settings);
+	}
+	template <typename IndexType>
+	BasicMesh<IndexType> Capsule(GeneratorContext& context, ChordalError maxError, const GeneratorSetting& settings)
+	{
+		return Capsule<IndexType>(context, maxError, 0.5f, 1.0f, settings);
+	}
+	template <typename IndexType>
+	BasicMesh<IndexType> Capsule(ChordalError maxError, float radius, float height, const GeneratorSetting& settings)
+	{
+		GeneratorContext context;
+		return Capsule<IndexType>(context, maxError, radius, height, settings);
+	}
+	template <typename IndexType>
+	BasicMesh<IndexType> Capsule(GeneratorContext& context, ChordalError maxError, float radius, float height, const GeneratorSetting& settings)
+	{
+		// The hemispheres need more tessellation than the straight body, so they decide both counts
+		const internal::SphereTessellation tessellation = internal::SphereTessellationFor(0.5f * std::numbers::pi_v<float>, radius, maxError, settings.scale);
+		return Capsule<IndexType>(context, tessellation.segments, tessellation.rings, radius, height, settings);
+	}
+	template Mesh16 Capsule<std::uint16_t>(std::uint32_t, const GeneratorSetting&);
+	template Mesh Capsule<std::uint32_t>(std::uint32_t, const GeneratorSetting&);
+	template Mesh64 Capsule<std::uint64_t>(std::uint32_t, const GeneratorSetting&);
+	template Mesh16 Capsule<std::uint16_t>(std::uint32_t, std::uint32_t, float, float, const GeneratorSetting&);
+	template Mesh Capsule<std::uint32_t>(std::uint32_t, std::uint32_t, float, float, const GeneratorSetting&);
+	template Mesh64 Capsule<std::uint64_t>(std::uint32_t, std::uint32_t, float, float, const GeneratorSetting&);
+	template Mesh16 Capsule<std::uint16_t>(ChordalError, const GeneratorSetting&);
+	template Mesh Capsule<std::uint32_t>(ChordalError, const GeneratorSetting&);
+	template Mesh64 Capsule<std::uint64_t>(ChordalError, const GeneratorSetting&);
+	template Mesh16 Capsule<std::uint16_t>(ChordalError, float, float, const GeneratorSetting&);
+	template Mesh Capsule<std::uint32_t>(ChordalError, float, float, const GeneratorSetting&);
+	template Mesh64 Capsule<std::uint64_t>(ChordalError, float, float, const GeneratorSetting&);
+	template Mesh16 Capsule<std::uint16_t>(GeneratorContext&, std::uint32_t, const GeneratorSetting&);
+	template Mesh Capsule<std::uint32_t>(GeneratorContext&, std::uint32_t, const GeneratorSetting&);
+	template Mesh64 Capsule<std::uint64_t>(GeneratorContext&, std::uint32_t, const GeneratorSetting&);
+	template Mesh16 Capsule<std::uint16_t>(GeneratorContext&, std::uint32_t, std::uint32_t, float, float, const GeneratorSetting&);
+	template Mesh Capsule<std::uint32_t>(GeneratorContext&, std::uint32_t, std::uint32_t, float, float, const GeneratorSetting&);
+	template Mesh64 Capsule<std::uint64_t>(GeneratorContext&, std::uint32_t, std::uint32_t, float, float, const GeneratorSetting&);
+	template Mesh16 Capsule<std::uint16_t>(GeneratorContext&, ChordalError, const GeneratorSetting&);
+	template Mesh Capsule<std::uint32_t>(GeneratorContext&, ChordalError, const GeneratorSetting&);
+	template Mesh64 Capsule<std::uint64_t>(GeneratorContext&, ChordalError, const GeneratorSetting&);
+	template Mesh16 Capsule<std::uint16_t>(GeneratorContext&, ChordalError, float, float, const GeneratorSetting&);
+	template Mesh Capsule<std::uint32_t>(GeneratorContext&, ChordalError, float, float, const GeneratorSetting&);
+	template Mesh64 Capsule<std::uint64_t>(GeneratorContext&, ChordalError, float, float, const GeneratorSetting&);
+}
@@ -3,11 +3,19 @@
 #include "../internal/ProcessMesh.hpp"
 #include "../internal/CalculateNormals.hpp"
 
+#include <algorithm>
 #include <array>
 
 namespace Construct
 {
-	Mesh Cube(const GeneratorSetting& settings)
+	template <typename IndexType>
+	BasicMesh<IndexType> Cube(const GeneratorSetting& settings)
+	{
+		GeneratorContext context;
+		return Cube<IndexType>(context, settings);
+	}
+	template <typename IndexType>
+	BasicMesh<IndexType> Cube(GeneratorContext& context, const GeneratorSetting& settings)
 	{
 		// Cube data using 6x1 texture strip, 24 vertices for normals and textures
 		static constexpr std::array<float, 24 * 3> CubeVertices = {
@@ -42,7 +50,7 @@ namespace Construct
 				0.5f, -0.5f, -0.5f,
 			   -0.5f, -0.5f,  0.5f,
 		};
-		static constexpr std::array<uint32_t, 6 * 6> CubeIndices = {
+		static constexpr std::array<IndexType, 6 * 6> CubeIndices = {
 			// Left
 			0, 1, 2,
 			3, 1, 0,
@@ -95,20 +103,62 @@ namespace Construct
 			6.0f, 1.0f,
 			5.0f, 0.0f,
 		};
+		// Tangent of each face, in the same order as the vertices.
+		// V runs down every face, so every frame is left handed
+		static constexpr std::array<float, 6 * 4> CubeFaceTangents = {
+			// Left
+			 0.0f, 0.0f,  1.0f, -1.0f,
+			// Front
+			 1.0f, 0.0f,  0.0f, -1.0f,
+			// Right
+			 0.0f, 0.0f, -1.0f, -1.0f,
+			// Back
+			-1.0f, 0.0f,  0.0f, -1.0f,
+			// Top
+			 1.0f, 0.0f,  0.0f, -1.0f,
+			// Bottom
+			 1.0f, 0.0f,  0.0f, -1.0f,
+		};
+		const bool hasNormals = settings.HasAttribute(VertexAttribute::Normal);
+		const bool hasTextureUVs = settings.HasAttribute(VertexAttribute::TextureUV);
+		const bool hasTangents = settings.HasAttribute(VertexAttribute::Tangent);
 		// Create mesh
-		Mesh mesh;
-		// Move data into mesh
-		mesh.vertices = std::vector<float>(CubeVertices.begin(), CubeVertices.end());
-		mesh.indices = std::vector<std::uint32_t>(CubeIndices.begin(), CubeIndices.end());
-		mesh.normals = internal::CalculateNormals(mesh.vertices, mesh.indices);
-		mesh.textureUVs = std::vector<float>(CubeTextureUVs.begin(), CubeTextureUVs.end());
-		// Remap U component of texture UVs from [0.0f, 6.0f] to [0.0f, 1.0f]
-		for (std::uint32_t i = 0, size = mesh.textureUVs.size(); i < size; i += 2)
+		BasicMesh<IndexType> mesh = context.NewMesh<IndexType>(CubeVertices.size(), CubeIndices.size(), hasNormals ? CubeVertices.size() : 0, hasTextureUVs ? CubeTextureUVs.size() : 0, hasTangents ? 24 * 4 : 0);
+		// Copy data into mesh
+		std::copy(CubeVertices.begin(), CubeVertices.end(), mesh.vertices.begin());
+		std::copy(CubeIndices.begin(), CubeIndices.end(), mesh.indices.begin());
+		// Opposite corners are enough to bound a cube
+		mesh.bounds.Add(-0.5f, -0.5f, -0.5f);
+		mesh.bounds.Add(0.5f, 0.5f, 0.5f);
+		if (hasNormals)
+		{
+			internal::CalculateNormals(mesh.vertices, mesh.indices, mesh.normals);
+		}
+		if (hasTextureUVs)
+		{
+			std::copy(CubeTextureUVs.begin(), CubeTextureUVs.end(), mesh.textureUVs.begin());
+			// Remap U component of texture UVs from [0.0f, 6.0f] to [0.0f, 1.0f]
+			for (std::uint32_t i = 0, size = mesh.textureUVs.size(); i < size; i += 2)
+			{
+				mesh.textureUVs[i] /= 6.0f;
+			}
+		}
+		if (hasTangents)
 		{
-			mesh.textureUVs[i] /= 6.0f;
+			// 4 vertices per face
+			for (std::uint32_t i = 0; i < 24; i++)
+			{
+				std::copy_n(&CubeFaceTangents[(i / 4) * 4], 4, &mesh.tangents[i * 4]);
+			}
 		}
 		// Process mesh for transforms
 		internal::ProcessMesh(mesh, settings);
 		return mesh;
 	}
+	template Mesh16 Cube<std::uint16_t>(const GeneratorSetting&);
+	template Mesh Cube<std::uint32_t>(const GeneratorSetting&);
+	template Mesh64 Cube<std::uint64_t>(const GeneratorSetting&);
+	template Mesh16 Cube<std::uint16_t>(GeneratorContext&, const GeneratorSetting&);
+	template Mesh Cube<std::uint32_t>(GeneratorContext&, const GeneratorSetting&);
+	template Mesh64 Cube<std::uint64_t>(GeneratorContext&, const GeneratorSetting&);
 }
\ No newline at end of file
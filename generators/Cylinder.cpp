@@ -1,43 +1,108 @@
 #include "../Construct.hpp"
 
 #include "../internal/ProcessMesh.hpp"
-#include "../internal/CalculateNormals.hpp"
 
 #include "../internal/CylinderBody.hpp"
-#include "../utils/Merge.hpp"
+
+#include <numbers>
 
 namespace Construct
 {
-	Mesh Cylinder(std::uint32_t sides, const GeneratorSetting& settings)
-	{
-		// Get parts of mesh
-		Mesh body = internal::CylinderBody(sides);
-		Mesh topFace = Polygon(sides, {
-			WindingOrder::CCW,
-			vec3(0.0f, 0.5f, 0.0f),
-			vec3(1.0f, 1.0f, 1.0f),
-			quat(-0.707f, 0.0f, 0.0f, 0.707f) });
-		Mesh bottomFace = Polygon(sides, {
-			WindingOrder::CW,
-			vec3(0.0f, -0.5f, 0.0f),
-			vec3(1.0f, 1.0f, 1.0f),
-			quat(-0.707f, 0.0f, 0.0f, 0.707f) });
-		// Remap face texture UVs
-		for (std::uint32_t i = 0, size = topFace.textureUVs.size(); i < size; i += 2)
+	std::uint64_t CylinderVertexCount(std::uint32_t sides, std::uint32_t capRings)
+	{
+		const std::uint64_t capVertexCount = (capRings == 0) ? 0 : internal::CylinderCapVertexCount(sides, capRings);
+		return internal::CheckedAdd(internal::CheckedMultiply(2, capVertexCount), internal::CylinderBodyVertexCount(sides));
+	}
+	template <typename IndexType>
+	BasicMesh<IndexType> Cylinder(std::uint32_t sides, const GeneratorSetting& settings)
+	{
+		GeneratorContext context;
+		return Cylinder<IndexType>(context, sides, settings);
+	}
+	template <typename IndexType>
+	BasicMesh<IndexType> Cylinder(GeneratorContext& context, std::uint32_t sides, const GeneratorSetting& settings)
+	{
+		return Cylinder<IndexType>(context, sides, 1, 0.5f, 1.0f, settings);
+	}
+	template <typename IndexType>
+	BasicMesh<IndexType> Cylinder(std::uint32_t sides, std::uint32_t capRings, float radius, float height, const GeneratorSetting& settings)
+	{
+		GeneratorContext context;
+		return Cylinder<IndexType>(context, sides, capRings, radius, height, settings);
+	}
+	template <typename IndexType>
+	BasicMesh<IndexType> Cylinder(GeneratorContext& context, std::uint32_t sides, std::uint32_t capRings, float radius, float height, const GeneratorSetting& settings)
+	{
+		// Caps are triangle fans, so the whole cylinder is always a triangle list
+		const std::size_t vertexCount = internal::CheckedVertexCount<IndexType>(CylinderVertexCount(sides, capRings));
+		const IndexType capVertexCount = static_cast<IndexType>((capRings == 0) ? 0 : internal::CylinderCapVertexCount(sides, capRings));
+		const std::size_t indexCount = internal::CheckedIndexCount<IndexType>(internal::CheckedAdd(internal::CheckedMultiply(2, internal::CylinderCapIndexCount(sides, capRings)), internal::CylinderBodyIndexCount(sides, Topology::TriangleList)));
+		// Preallocate everything once, parts are written directly into place
+		// Parts skip any attribute that is left unallocated
+		BasicMesh<IndexType> mesh = context.NewMesh<IndexType>(3 * vertexCount, settings.generateIndices ? indexCount : 0,
+			settings.HasAttribute(VertexAttribute::Normal) ? 3 * vertexCount : 0,
+			settings.HasAttribute(VertexAttribute::TextureUV) ? 2 * vertexCount : 0,
+			settings.HasAttribute(VertexAttribute::Tangent) ? 4 * vertexCount : 0);
+		IndexType* indexOutput = settings.generateIndices ? mesh.indices.data() : nullptr;
+		IndexType baseVertex = 0;
+		if (capRings > 0)
 		{
-			topFace.textureUVs[i + 0] *= 1.0f / (1.0f + std::numbers::pi_v<float>);
-			topFace.textureUVs[i + 1] *= 0.5f;
-
-			bottomFace.textureUVs[i + 0] *= 1.0f / (1.0f + std::numbers::pi_v<float>);
-			bottomFace.textureUVs[i + 1] *= 0.5f;
-			bottomFace.textureUVs[i + 1] += 0.5f;
+			indexOutput = internal::CylinderCap(mesh, baseVertex, indexOutput, sides, capRings, radius, -0.5f * height, false);
+			baseVertex += capVertexCount;
+			indexOutput = internal::CylinderCap(mesh, baseVertex, indexOutput, sides, capRings, radius, 0.5f * height, true);
+			baseVertex += capVertexCount;
 		}
-		// Merge meshes together
-		Mesh mesh = Merge({ &bottomFace, &topFace, &body });
-		// Calculate normals
-		mesh.normals = internal::CalculateNormals(mesh.vertices, mesh.indices);
+		internal::CylinderBody(mesh, baseVertex, indexOutput, sides, radius, height, false, Topology::TriangleList);
 		// Process mesh for transforms
 		internal::ProcessMesh(mesh, settings);
 		return mesh;
 	}
-}
\ No newline at end of file
+	template <typename IndexType>
+	BasicMesh<IndexType> Cylinder(ChordalError maxError, const GeneratorSetting& settings)
+	{
+		GeneratorContext context;
+		return Cylinder<IndexType>(context, maxError, settings);
+	}
+	template <typename IndexType>
+	BasicMesh<IndexType> Cylinder(GeneratorContext& context, ChordalError maxError, const GeneratorSetting& settings)
+	{
+		return Cylinder<IndexType>(context, maxError, 0.5f, 1.0f, settings);
+	}
+	template <typename IndexType>
+	BasicMesh<IndexType> Cylinder(ChordalError maxError, float radius, float height, const GeneratorSetting& settings)
+	{
+		GeneratorContext context;
+		return Cylinder<IndexType>(context, maxError, radius, height, settings);
+	}
+	template <typename IndexType>
+	BasicMesh<IndexType> Cylinder(GeneratorContext& context, ChordalError maxError, float radius, float height, const GeneratorSetting& settings)
+	{
+		// The body is straight along y and the caps are flat, only the circles around y add error
+		const std::uint32_t sides = internal::ArcSteps(2.0f * std::numbers::pi_v<float>, radius * internal::MaxScale(settings.scale, true, false, true), maxError.value, 3);
+		return Cylinder<IndexType>(context, sides, 1, radius, height, settings);
+	}
+	template Mesh16 Cylinder<std::uint16_t>(std::uint32_t, const GeneratorSetting&);
+	template Mesh Cylinder<std::uint32_t>(std::uint32_t, const GeneratorSetting&);
+	template Mesh64 Cylinder<std::uint64_t>(std::uint32_t, const GeneratorSetting&);
+	template Mesh16 Cylinder<std::uint16_t>(std::uint32_t, std::uint32_t, float, float, const GeneratorSetting&);
+	template Mesh Cylinder<std::uint32_t>(std::uint32_t, std::uint32_t, float, float, const GeneratorSetting&);
+	template Mesh64 Cylinder<std::uint64_t>(std::uint32_t, std::uint32_t, float, float, const GeneratorSetting&);
+	template Mesh16 Cylinder<std::uint16_t>(ChordalError, const GeneratorSetting&);
+	template Mesh Cylinder<std::uint32_t>(ChordalError, const GeneratorSetting&);
+	template Mesh64 Cylinder<std::uint64_t>(ChordalError, const GeneratorSetting&);
+	template Mesh16 Cylinder<std::uint16_t>(ChordalError, float, float, const GeneratorSetting&);
+	template Mesh Cylinder<std::uint32_t>(ChordalError, float, float, const GeneratorSetting&);
+	template Mesh64 Cylinder<std::uint64_t>(ChordalError, float, float, const GeneratorSetting&);
+	template Mesh16 Cylinder<std::uint16_t>(GeneratorContext&, std::uint32_t, const GeneratorSetting&);
+	template Mesh Cylinder<std::uint32_t>(GeneratorContext&, std::uint32_t, const GeneratorSetting&);
+	template Mesh64 Cylinder<std::uint64_t>(GeneratorContext&, std::uint32_t, const GeneratorSetting&);
+	template Mesh16 Cylinder<std::uint16_t>(GeneratorContext&, std::uint32_t, std::uint32_t, float, float, const GeneratorSetting&);
+	template Mesh Cylinder<std::uint32_t>(GeneratorContext&, std::uint32_t, std::uint32_t, float, float, const GeneratorSetting&);
+	template Mesh64 Cylinder<std::uint64_t>(GeneratorContext&, std::uint32_t, std::uint32_t, float, float, const GeneratorSetting&);
+	template Mesh16 Cylinder<std::uint16_t>(GeneratorContext&, ChordalError, const GeneratorSetting&);
+	template Mesh Cylinder<std::uint32_t>(GeneratorContext&, ChordalError, const GeneratorSetting&);
+	template Mesh64 Cylinder<std::uint64_t>(GeneratorContext&, ChordalError, const GeneratorSetting&);
+	template Mesh16 Cylinder<std::uint16_t>(GeneratorContext&, ChordalError, float, float, const GeneratorSetting&);
+	template Mesh Cylinder<std::uint32_t>(GeneratorContext&, ChordalError, float, float, const GeneratorSetting&);
+	template Mesh64 Cylinder<std::uint64_t>(GeneratorContext&, ChordalError, float, float, const GeneratorSetting&);
+}
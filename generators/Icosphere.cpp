@@ -2,20 +2,210 @@
 
 #include "../internal/ProcessMesh.hpp"
 #include "../internal/CalculateNormals.hpp"
+#include "../internal/CalculateTangents.hpp"
+#include "../internal/MeshFileSink.hpp"
 
 #include "../internal/IcosphereBase.hpp"
 #include "../internal/IcosphereSubdivide.hpp"
 
+#include <algorithm>
+
 namespace Construct
 {
-	Mesh Icosphere(std::uint32_t subdivisions, const GeneratorSetting& settings)
+	std::uint64_t IcosphereVertexCount(std::uint32_t subdivisions)
+	{
+		// Every subdivision quadruples the faces, vertices along the texture seam and at the poles are duplicated
+		// which gives 10 * 4^n + 11 * 2^n + 1 vertices
+		std::uint64_t powerOf2 = 1;
+		for (std::uint32_t i = 0; i < subdivisions; i++)
+		{
+			powerOf2 = internal::CheckedMultiply(powerOf2, 2);
+		}
+		return internal::CheckedAdd(internal::CheckedMultiply(internal::CheckedMultiply(10, powerOf2), powerOf2), 11 * powerOf2 + 1);
+	}
+	std::uint64_t IcosphereToFileVertexCount(std::uint32_t subdivisions)
+	{
+		return internal::IcosphereStreamVertexCount(20, subdivisions);
+	}
+	namespace internal
 	{
-		// Generate Icosphere base case
-		Mesh mesh = internal::IcosphereSubdivide(internal::IcosphereBase(), subdivisions);
-		// Calculate normals
-		mesh.normals = internal::CalculateNormals(mesh.vertices, mesh.indices);
+		/// <summary>
+		/// Generates an untransformed Icosphere with the requested attributes, optionally recording the parents of the last subdivision
+		/// </summary>
+		template <typename IndexType>
+		BasicMesh<IndexType> IcosphereUnprocessed(GeneratorContext& context, std::uint32_t subdivisions, const GeneratorSetting& settings, std::vector<std::uint32_t>* parents)
+		{
+			// Throws if the index type can't address the subdivided vertices
+			CheckedVertexCount<IndexType>(IcosphereVertexCount(subdivisions));
+			// Generate Icosphere base case
+			BasicMesh<IndexType> base = IcosphereBase<IndexType>(context);
+			// Tangents follow the texture layout, so texture UVs are kept until they are calculated
+			const bool keepTextureUVs = settings.HasAttribute(VertexAttribute::TextureUV) || settings.HasAttribute(VertexAttribute::Tangent);
+			if (!keepTextureUVs)
+			{
+				context.Recycle(std::move(base.textureUVs));
+			}
+			BasicMesh<IndexType> mesh = IcosphereSubdivide(context, std::move(base), subdivisions, parents);
+			// Calculate normals
+			if (settings.HasAttribute(VertexAttribute::Normal))
+			{
+				mesh.normals = context.NewBuffer<float>(mesh.vertices.size());
+				CalculateNormals(mesh.vertices, mesh.indices, mesh.normals);
+			}
+			// Subdivided faces have no closed form parameterisation, so tangents use the general fallback
+			if (settings.HasAttribute(VertexAttribute::Tangent))
+			{
+				mesh.tangents = context.NewBuffer<float>(4 * (mesh.vertices.size() / 3));
+				CalculateTangents(mesh.vertices, mesh.normals, mesh.textureUVs, mesh.indices, mesh.tangents, context);
+			}
+			if (!settings.HasAttribute(VertexAttribute::TextureUV))
+			{
+				context.Recycle(std::move(mesh.textureUVs));
+			}
+			return mesh;
+		}
+	}
+	template <typename IndexType>
+	BasicMesh<IndexType> Icosphere(std::uint32_t subdivisions, const GeneratorSetting& settings)
+	{
+		GeneratorContext context;
+		return Icosphere<IndexType>(context, subdivisions, settings);
+	}
+	template <typename IndexType>
+	BasicMesh<IndexType> Icosphere(GeneratorContext& context, std::uint32_t subdivisions, const GeneratorSetting& settings)
+	{
+		BasicMesh<IndexType> mesh = internal::IcosphereUnprocessed<IndexType>(context, subdivisions, settings, nullptr);
 		// Process mesh for transforms
 		internal::ProcessMesh(mesh, settings);
 		return mesh;
 	}
+	template <typename IndexType>
+	BasicMorphMesh<IndexType> IcosphereMorph(std::uint32_t subdivisions, const GeneratorSetting& settings)
+	{
+		GeneratorContext context;
+		return IcosphereMorph<IndexType>(context, subdivisions, settings);
+	}
+	template <typename IndexType>
+	BasicMorphMesh<IndexType> IcosphereMorph(GeneratorContext& context, std::uint32_t subdivisions, const GeneratorSetting& settings)
+	{
+		// The subdivision engine already knows the edge every new vertex splits, so the parents come out of the last level for free
+		std::vector<std::uint32_t>& parents = context.Scratch<std::uint32_t>(10);
+		BasicMorphMesh<IndexType> morph;
+		morph.mesh = internal::IcosphereUnprocessed<IndexType>(context, subdivisions, settings, &parents);
+		// With no subdivisions every vertex is its own parent
+		if (subdivisions == 0)
+		{
+			parents.resize(2 * (morph.mesh.vertices.size() / 3));
+			for (std::size_t v = 0, size = parents.size() / 2; v < size; v++)
+			{
+				parents[2 * v + 0] = parents[2 * v + 1] = static_cast<std::uint32_t>(v);
+			}
+		}
+		morph.parent = internal::MorphTargetFromParents(morph.mesh, parents, context);
+		morph.parents = context.NewBuffer<IndexType>(parents.size());
+		std::transform(parents.begin(), parents.end(), morph.parents.begin(), [](std::uint32_t parent) { return static_cast<IndexType>(parent); });
+		internal::ProcessMorphMesh(morph, settings);
+		return morph;
+	}
+	template <typename IndexType>
+	BasicMesh<IndexType> Icosphere(ChordalError maxError, const GeneratorSetting& settings)
+	{
+		GeneratorContext context;
+		return Icosphere<IndexType>(context, maxError, settings);
+	}
+	template <typename IndexType>
+	BasicMesh<IndexType> Icosphere(GeneratorContext& context, ChordalError maxError, const GeneratorSetting& settings)
+	{
+		return Icosphere<IndexType>(context, internal::IcosphereSubdivisionsFor(0.5f, maxError, settings.scale), settings);
+	}
+	template <typename IndexType>
+	MeshFileHeader IcosphereToFile(std::uint32_t subdivisions, const std::filesystem::path& path, const GeneratorSetting& settings, std::size_t windowBytes)
+	{
+		// Throws if the index type can't address the vertices, the file itself can be larger than memory
+		const std::uint64_t vertexCount = internal::CheckedVertexCount<IndexType>(IcosphereToFileVertexCount(subdivisions));
+		const std::uint64_t indexCount = internal::IcosphereStreamIndexCount(20, subdivisions);
+		const bool hasNormals = settings.HasAttribute(VertexAttribute::Normal);
+		const bool hasTangents = settings.HasAttribute(VertexAttribute::Tangent);
+		const BasicMesh<IndexType> base = internal::IcosphereBase<IndexType>();
+		// Texture UVs are linear across each base face, so every vertex of a face shares its texture frame
+		std::vector<float> faceTangents(3 * 20), faceBitangents(3 * 20);
+		for (std::size_t f = 0; f < 20; f++)
+		{
+			const std::size_t i0 = base.indices[f * 3 + 0], i1 = base.indices[f * 3 + 1], i2 = base.indices[f * 3 + 2];
+			const float du1 = base.textureUVs[i1 * 2 + 0] - base.textureUVs[i0 * 2 + 0], dv1 = base.textureUVs[i1 * 2 + 1] - base.textureUVs[i0 * 2 + 1];
+			const float du2 = base.textureUVs[i2 * 2 + 0] - base.textureUVs[i0 * 2 + 0], dv2 = base.textureUVs[i2 * 2 + 1] - base.textureUVs[i0 * 2 + 1];
+			const float orientation = (du1 * dv2 - du2 * dv1 < 0.0f) ? -1.0f : 1.0f;
+			for (std::size_t k = 0; k < 3; k++)
+			{
+				const float e1 = base.vertices[i1 * 3 + k] - base.vertices[i0 * 3 + k];
+				const float e2 = base.vertices[i2 * 3 + k] - base.vertices[i0 * 3 + k];
+				faceTangents[f * 3 + k] = (e1 * dv2 - e2 * dv1) * orientation;
+				faceBitangents[f * 3 + k] = (e2 * du1 - e1 * du2) * orientation;
+			}
+		}
+		// Edges between faces are written once per face, so the index count is known up front
+		internal::MeshFileSink<IndexType> sink(path, vertexCount, indexCount, Topology::TriangleList, settings.attributes, windowBytes);
+		sink.bounds = Bounds(settings.offset);
+		auto vertex = [&](std::size_t face, const float* subdivided, const float* textureUV) {
+			float position[3] = { subdivided[0], subdivided[1], subdivided[2] };
+			// Normals point straight out from the center
+			const float length = std::sqrtf(position[0] * position[0] + position[1] * position[1] + position[2] * position[2]);
+			float normal[3] = { position[0] / length, position[1] / length, position[2] / length };
+			// Face tangent projected onto the tangent plane of the vertex
+			float tangent[4] = {};
+			if (hasTangents)
+			{
+				const float* faceTangent = &faceTangents[face * 3];
+				const float* faceBitangent = &faceBitangents[face * 3];
+				const float d = faceTangent[0] * normal[0] + faceTangent[1] * normal[1] + faceTangent[2] * normal[2];
+				const float tx = faceTangent[0] - normal[0] * d, ty = faceTangent[1] - normal[1] * d, tz = faceTangent[2] - normal[2] * d;
+				const float tangentLength = std::sqrtf(tx * tx + ty * ty + tz * tz);
+				tangent[0] = tx / tangentLength;
+				tangent[1] = ty / tangentLength;
+				tangent[2] = tz / tangentLength;
+				// Handedness is whether cross(normal, tangent) agrees with the bitangent
+				const float cx = normal[1] * tz - normal[2] * ty, cy = normal[2] * tx - normal[0] * tz, cz = normal[0] * ty - normal[1] * tx;
+				tangent[3] = (cx * faceBitangent[0] + cy * faceBitangent[1] + cz * faceBitangent[2] < 0.0f) ? -1.0f : 1.0f;
+			}
+			internal::ProcessVertex(settings, position, hasNormals ? normal : nullptr, hasTangents ? tangent : nullptr);
+			sink.Vertex(position, normal, textureUV, tangent);
+		};
+		std::vector<IndexType> flipped;
+		auto indices = [&](const IndexType* data, std::size_t count) {
+			if (settings.windingOrder == WindingOrder::CW)
+			{
+				// Same swap as ProcessMesh
+				flipped.assign(data, data + count);
+				for (std::size_t k = 0; k < count; k += 3)
+				{
+					std::swap(flipped[k + 0], flipped[k + 2]);
+				}
+				data = flipped.data();
+			}
+			sink.Indices(data, count);
+		};
+		internal::IcosphereSubdivideStream(base, subdivisions, vertex, indices);
+		return sink.Finish();
+	}
+	template Mesh16 Icosphere<std::uint16_t>(std::uint32_t, const GeneratorSetting&);
+	template Mesh Icosphere<std::uint32_t>(std::uint32_t, const GeneratorSetting&);
+	template Mesh64 Icosphere<std::uint64_t>(std::uint32_t, const GeneratorSetting&);
+	template Mesh16 Icosphere<std::uint16_t>(ChordalError, const GeneratorSetting&);
+	template Mesh Icosphere<std::uint32_t>(ChordalError, const GeneratorSetting&);
+	template Mesh64 Icosphere<std::uint64_t>(ChordalError, const GeneratorSetting&);
+	template Mesh16 Icosphere<std::uint16_t>(GeneratorContext&, std::uint32_t, const GeneratorSetting&);
+	template Mesh Icosphere<std::uint32_t>(GeneratorContext&, std::uint32_t, const GeneratorSetting&);
+	template Mesh64 Icosphere<std::uint64_t>(GeneratorContext&, std::uint32_t, const GeneratorSetting&);
+	template Mesh16 Icosphere<std::uint16_t>(GeneratorContext&, ChordalError, const GeneratorSetting&);
+	template Mesh Icosphere<std::uint32_t>(GeneratorContext&, ChordalError, const GeneratorSetting&);
+	template Mesh64 Icosphere<std::uint64_t>(GeneratorContext&, ChordalError, const GeneratorSetting&);
+	template MeshFileHeader IcosphereToFile<std::uint16_t>(std::uint32_t, const std::filesystem::path&, const GeneratorSetting&, std::size_t);
+	template MeshFileHeader IcosphereToFile<std::uint32_t>(std::uint32_t, const std::filesystem::path&, const GeneratorSetting&, std::size_t);
+	template MeshFileHeader IcosphereToFile<std::uint64_t>(std::uint32_t, const std::filesystem::path&, const GeneratorSetting&, std::size_t);
+	template BasicMorphMesh<std::uint16_t> IcosphereMorph<std::uint16_t>(std::uint32_t, const GeneratorSetting&);
+	template BasicMorphMesh<std::uint32_t> IcosphereMorph<std::uint32_t>(std::uint32_t, const GeneratorSetting&);
+	template BasicMorphMesh<std::uint64_t> IcosphereMorph<std::uint64_t>(std::uint32_t, const GeneratorSetting&);
+	template BasicMorphMesh<std::uint16_t> IcosphereMorph<std::uint16_t>(GeneratorContext&, std::uint32_t, const GeneratorSetting&);
+	template BasicMorphMesh<std::uint32_t> IcosphereMorph<std::uint32_t>(GeneratorContext&, std::uint32_t, const GeneratorSetting&);
+	template BasicMorphMesh<std::uint64_t> IcosphereMorph<std::uint64_t>(GeneratorContext&, std::uint32_t, const GeneratorSetting&);
 }
\ No newline at end of file
@@ -1,65 +1,170 @@
 #include "../Construct.hpp"
 
 #include "../internal/ProcessMesh.hpp"
-#include "../internal/CalculateNormals.hpp"
-
-#include <array>
+#include "../internal/GridIndices.hpp"
+#include "../internal/MeshFileSink.hpp"
+#include "../internal/PlaneVertex.hpp"
 
 namespace Construct
 {
-	Mesh Plane(std::uint32_t widthTiles, std::uint32_t heightTiles, const GeneratorSetting& settings)
+	std::uint64_t PlaneVertexCount(std::uint32_t widthTiles, std::uint32_t heightTiles)
+	{
+		return internal::CheckedMultiply(static_cast<std::uint64_t>(widthTiles) + 1, static_cast<std::uint64_t>(heightTiles) + 1);
+	}
+	template <typename IndexType>
+	BasicMesh<IndexType> Plane(std::uint32_t widthTiles, std::uint32_t heightTiles, const GeneratorSetting& settings)
+	{
+		GeneratorContext context;
+		return Plane<IndexType>(context, widthTiles, heightTiles, settings);
+	}
+	namespace internal
+	{
+		/// <summary>
+		/// Generates an untransformed Plane, and if parent isn't null the morph target of every vertex on the plane with half the tiles
+		/// </summary>
+		template <typename IndexType>
+		BasicMesh<IndexType> PlaneUnprocessed(GeneratorContext& context, std::uint32_t widthTiles, std::uint32_t heightTiles, const GeneratorSetting& settings, MorphTarget* parent)
+		{
+			// Precalculate required vertices, throws if the index type can't address them
+			const std::size_t vertexCount = CheckedVertexCount<IndexType>(PlaneVertexCount(widthTiles, heightTiles));
+			const std::size_t indexCount = CheckedIndexCount<IndexType>(GridIndexCount(heightTiles, widthTiles, settings.topology));
+			// Preallocate mesh
+			const bool hasNormals = settings.HasAttribute(VertexAttribute::Normal);
+			const bool hasTextureUVs = settings.HasAttribute(VertexAttribute::TextureUV);
+			const bool hasTangents = settings.HasAttribute(VertexAttribute::Tangent);
+			BasicMesh<IndexType> mesh = context.NewMesh<IndexType>(3 * vertexCount, settings.generateIndices ? indexCount : 0, hasNormals ? 3 * vertexCount : 0, hasTextureUVs ? 2 * vertexCount : 0, hasTangents ? 4 * vertexCount : 0);
+			mesh.topology = settings.topology;
+			if (parent != nullptr)
+			{
+				parent->vertices = context.NewBuffer<float>(3 * vertexCount);
+				parent->normals = context.NewBuffer<float>(hasNormals ? 3 * vertexCount : 0);
+				parent->textureUVs = context.NewBuffer<float>(hasTextureUVs ? 2 * vertexCount : 0);
+			}
+			// Create lambda to get indices
+			auto index2D = [&](std::size_t i, std::size_t j) { return i * (static_cast<std::size_t>(widthTiles) + 1) + j; };
+			for (std::uint32_t i = 0; i <= heightTiles; i++)
+			{
+				for (std::uint32_t j = 0; j <= widthTiles; j++)
+				{
+					// Calculate vertex index
+					std::size_t index = index2D(i, j);
+					PlaneVertex(i, j, widthTiles, heightTiles, &mesh.vertices[3 * index],
+						hasNormals ? &mesh.normals[3 * index] : nullptr,
+						hasTextureUVs ? &mesh.textureUVs[2 * index] : nullptr,
+						hasTangents ? &mesh.tangents[4 * index] : nullptr);
+					mesh.bounds.Add(mesh.vertices[3 * index + 0], mesh.vertices[3 * index + 1], 0.0f);
+					if (parent != nullptr)
+					{
+						PlaneMorphVertex(i, j, widthTiles, heightTiles, &parent->vertices[3 * index],
+							hasNormals ? &parent->normals[3 * index] : nullptr,
+							hasTextureUVs ? &parent->textureUVs[2 * index] : nullptr);
+					}
+				}
+			}
+			// Strips are wound here as ProcessMesh only flips triangle lists
+			const bool flip = settings.topology == Topology::TriangleStrip && settings.windingOrder == WindingOrder::CW;
+			GridIndices<IndexType>(settings.generateIndices ? mesh.indices.data() : nullptr, 0, heightTiles, widthTiles, flip, settings.topology);
+			return mesh;
+		}
+	}
+	template <typename IndexType>
+	BasicMesh<IndexType> Plane(GeneratorContext& context, std::uint32_t widthTiles, std::uint32_t heightTiles, const GeneratorSetting& settings)
+	{
+		BasicMesh<IndexType> mesh = internal::PlaneUnprocessed<IndexType>(context, widthTiles, heightTiles, settings, nullptr);
+		// Process mesh for transforms
+		internal::ProcessMesh(mesh, settings);
+		return mesh;
+	}
+	template <typename IndexType>
+	BasicMorphMesh<IndexType> PlaneMorph(std::uint32_t widthTiles, std::uint32_t heightTiles, const GeneratorSetting& settings)
+	{
+		GeneratorContext context;
+		return PlaneMorph<IndexType>(context, widthTiles, heightTiles, settings);
+	}
+	template <typename IndexType>
+	BasicMorphMesh<IndexType> PlaneMorph(GeneratorContext& context, std::uint32_t widthTiles, std::uint32_t heightTiles, const GeneratorSetting& settings)
+	{
+		if (widthTiles % 2 != 0 || heightTiles % 2 != 0)
+		{
+			throw std::invalid_argument("Construct: a morphing plane needs an even number of tiles along each side");
+		}
+		BasicMorphMesh<IndexType> morph;
+		morph.mesh = internal::PlaneUnprocessed<IndexType>(context, widthTiles, heightTiles, settings, &morph.parent);
+		// On the flat grid the target is the vertex itself, the parents let displaced planes find the coarse height
+		morph.parents = context.NewBuffer<IndexType>(2 * (morph.mesh.vertices.size() / 3));
+		const std::size_t stride = static_cast<std::size_t>(widthTiles) + 1;
+		for (std::uint32_t i = 0; i <= heightTiles; i++)
+		{
+			for (std::uint32_t j = 0; j <= widthTiles; j++)
+			{
+				std::uint32_t i0, j0, i1, j1;
+				internal::PlaneMorphParents(i, j, i0, j0, i1, j1);
+				const std::size_t index = i * stride + j;
+				morph.parents[2 * index + 0] = static_cast<IndexType>(i0 * stride + j0);
+				morph.parents[2 * index + 1] = static_cast<IndexType>(i1 * stride + j1);
+			}
+		}
+		internal::ProcessMorphMesh(morph, settings);
+		return morph;
+	}
+	template <typename IndexType>
+	MeshFileHeader PlaneToFile(std::uint32_t widthTiles, std::uint32_t heightTiles, const std::filesystem::path& path, const GeneratorSetting& settings, std::size_t windowBytes)
 	{
-        // Plane indice data
-		static constexpr std::array<std::uint32_t, 6> PlaneIndexMap = {
-			0, 1, 2,
-			1, 3, 2,
-		};
-        // Precalculate required vertices
-        const uint32_t vertexCount = (widthTiles + 1) * (heightTiles + 1);
-        const uint32_t quadCount = widthTiles * heightTiles;
-        // Preallocate mesh
-        Mesh mesh(3 * vertexCount, 2 * 3 * quadCount, 0, 2 * vertexCount);
-        // Create lambda to get indices
-        auto index2D = [&](uint32_t i, uint32_t j) { return i * (widthTiles + 1) + j; };
-        for (std::uint32_t i = 0; i <= heightTiles; i++)
-        {
-            for (std::uint32_t j = 0; j <= widthTiles; j++)
-            {
-                // Calculate vertex position
-                float x = static_cast<float>(j) / widthTiles - 0.5f;
-                float z = static_cast<float>(i) / heightTiles - 0.5f;
-                // Calculate vertex index
-                std::uint32_t vertexIndex = 3 * index2D(i, j);
-                std::uint32_t textureIndex = 2 * index2D(i, j);
-                // Add vertex to data
-                mesh.vertices[vertexIndex + 0] = x;
-                mesh.vertices[vertexIndex + 1] = z;
-                // Add texture to data
-                mesh.textureUVs[textureIndex + 0] = x + 0.5f;
-                mesh.textureUVs[textureIndex + 1] = z + 0.5f;
-                // n + 1 verts but n squares
-                if (i < heightTiles && j < widthTiles)
-                {
-                    // Calculate index of quad corners
-                    uint32_t corners[4] = {
-                        index2D(i + 0, j + 0),
-                        index2D(i + 0, j + 1),
-                        index2D(i + 1, j + 0),
-                        index2D(i + 1, j + 1)
-                    };
-                    uint32_t index = 6 * (i * widthTiles + j);
-                    // Add quad indices to plane
-                    for (std::uint32_t k = 0; k < 6; k++)
-                    {
-                        mesh.indices[index + k] = corners[PlaneIndexMap[k]];
-                    }
-                }
-            }
-        }
-        // Calculate mesh normals
-        mesh.normals = internal::CalculateNormals(mesh.vertices, mesh.indices);
-        // Process mesh for transforms
-        internal::ProcessMesh(mesh, settings);
-        return mesh;
+		// Throws if the index type can't address the vertices, the file itself can be larger than memory
+		const std::uint64_t vertexCount = internal::CheckedVertexCount<IndexType>(PlaneVertexCount(widthTiles, heightTiles));
+		const std::uint64_t indexCount = internal::GridIndexCount(heightTiles, widthTiles, settings.topology);
+		const bool hasNormals = settings.HasAttribute(VertexAttribute::Normal);
+		const bool hasTextureUVs = settings.HasAttribute(VertexAttribute::TextureUV);
+		const bool hasTangents = settings.HasAttribute(VertexAttribute::Tangent);
+		internal::MeshFileSink<IndexType> sink(path, vertexCount, indexCount, settings.topology, settings.attributes, windowBytes);
+		sink.bounds = Bounds(settings.offset);
+		// Vertices are written in the same order as Plane, one at a time
+		float position[3], normal[3], textureUV[2], tangent[4];
+		for (std::uint32_t i = 0; i <= heightTiles; i++)
+		{
+			for (std::uint32_t j = 0; j <= widthTiles; j++)
+			{
+				internal::PlaneVertex(i, j, widthTiles, heightTiles, position,
+					hasNormals ? normal : nullptr,
+					hasTextureUVs ? textureUV : nullptr,
+					hasTangents ? tangent : nullptr);
+				internal::ProcessVertex(settings, position, hasNormals ? normal : nullptr, hasTangents ? tangent : nullptr);
+				sink.Vertex(position, normal, textureUV, tangent);
+			}
+		}
+		// Indices are written a row of quads at a time
+		const bool flip = settings.topology == Topology::TriangleStrip && settings.windingOrder == WindingOrder::CW;
+		const bool flipList = settings.topology == Topology::TriangleList && settings.windingOrder == WindingOrder::CW;
+		std::vector<IndexType> rowIndices(internal::CheckedIndexCount<IndexType>(internal::GridIndexCount(1, widthTiles, settings.topology)));
+		const IndexType stride = static_cast<IndexType>(widthTiles + static_cast<std::uint64_t>(1));
+		for (std::uint32_t i = 0; i < heightTiles; i++)
+		{
+			internal::GridIndices<IndexType>(rowIndices.data(), static_cast<IndexType>(static_cast<IndexType>(i) * stride), 1, widthTiles, flip, settings.topology);
+			// Same swap as ProcessMesh
+			if (flipList)
+			{
+				for (std::size_t k = 0, size = rowIndices.size(); k < size; k += 3)
+				{
+					std::swap(rowIndices[k + 0], rowIndices[k + 2]);
+				}
+			}
+			sink.Indices(rowIndices.data(), rowIndices.size());
+		}
+		return sink.Finish();
 	}
+	template Mesh16 Plane<std::uint16_t>(std::uint32_t, std::uint32_t, const GeneratorSetting&);
+	template Mesh Plane<std::uint32_t>(std::uint32_t, std::uint32_t, const GeneratorSetting&);
+	template Mesh64 Plane<std::uint64_t>(std::uint32_t, std::uint32_t, const GeneratorSetting&);
+	template Mesh16 Plane<std::uint16_t>(GeneratorContext&, std::uint32_t, std::uint32_t, const GeneratorSetting&);
+	template Mesh Plane<std::uint32_t>(GeneratorContext&, std::uint32_t, std::uint32_t, const GeneratorSetting&);
+	template Mesh64 Plane<std::uint64_t>(GeneratorContext&, std::uint32_t, std::uint32_t, const GeneratorSetting&);
+	template MeshFileHeader PlaneToFile<std::uint16_t>(std::uint32_t, std::uint32_t, const std::filesystem::path&, const GeneratorSetting&, std::size_t);
+	template MeshFileHeader PlaneToFile<std::uint32_t>(std::uint32_t, std::uint32_t, const std::filesystem::path&, const GeneratorSetting&, std::size_t);
+	template MeshFileHeader PlaneToFile<std::uint64_t>(std::uint32_t, std::uint32_t, const std::filesystem::path&, const GeneratorSetting&, std::size_t);
+	template BasicMorphMesh<std::uint16_t> PlaneMorph<std::uint16_t>(std::uint32_t, std::uint32_t, const GeneratorSetting&);
+	template BasicMorphMesh<std::uint32_t> PlaneMorph<std::uint32_t>(std::uint32_t, std::uint32_t, const GeneratorSetting&);
+	template BasicMorphMesh<std::uint64_t> PlaneMorph<std::uint64_t>(std::uint32_t, std::uint32_t, const GeneratorSetting&);
+	template BasicMorphMesh<std::uint16_t> PlaneMorph<std::uint16_t>(GeneratorContext&, std::uint32_t, std::uint32_t, const GeneratorSetting&);
+	template BasicMorphMesh<std::uint32_t> PlaneMorph<std::uint32_t>(GeneratorContext&, std::uint32_t, std::uint32_t, const GeneratorSetting&);
+	template BasicMorphMesh<std::uint64_t> PlaneMorph<std::uint64_t>(GeneratorContext&, std::uint32_t, std::uint32_t, const GeneratorSetting&);
 }
\ No newline at end of file
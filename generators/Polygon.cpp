@@ -7,17 +7,35 @@
 
 namespace Construct
 {
-	Mesh Polygon(std::uint32_t sides, const GeneratorSetting& settings)
+	std::uint64_t PolygonVertexCount(std::uint32_t sides)
 	{
-		// Calculate number of vertices for preallocation
-		const std::uint32_t vertexCount = (sides + 1);
+		return static_cast<std::uint64_t>(sides) + 1;
+	}
+	template <typename IndexType>
+	BasicMesh<IndexType> Polygon(std::uint32_t sides, const GeneratorSetting& settings)
+	{
+		GeneratorContext context;
+		return Polygon<IndexType>(context, sides, settings);
+	}
+	template <typename IndexType>
+	BasicMesh<IndexType> Polygon(GeneratorContext& context, std::uint32_t sides, const GeneratorSetting& settings)
+	{
+		// Calculate number of vertices for preallocation, throws if the index type can't address them
+		const std::size_t vertexCount = internal::CheckedVertexCount<IndexType>(PolygonVertexCount(sides));
 		// Preallocate
-		Mesh mesh(3 * vertexCount, 3 * sides, 0, 2 * vertexCount);
+		const bool hasNormals = settings.HasAttribute(VertexAttribute::Normal);
+		const bool hasTextureUVs = settings.HasAttribute(VertexAttribute::TextureUV);
+		const bool hasTangents = settings.HasAttribute(VertexAttribute::Tangent);
+		BasicMesh<IndexType> mesh = context.NewMesh<IndexType>(3 * vertexCount, 3 * static_cast<std::size_t>(sides), hasNormals ? 3 * vertexCount : 0, hasTextureUVs ? 2 * vertexCount : 0, hasTangents ? 4 * vertexCount : 0);
 		// Add center vertice data
 		// Vertices already initialised to 0
-		mesh.textureUVs[0] = 0.5f;
-		mesh.textureUVs[1] = 0.5f;
-		for (std::uint32_t i = 1; i <= sides; i++)
+		mesh.bounds.Add(0.0f, 0.0f, 0.0f);
+		if (hasTextureUVs)
+		{
+			mesh.textureUVs[0] = 0.5f;
+			mesh.textureUVs[1] = 0.5f;
+		}
+		for (std::size_t i = 1; i <= sides; i++)
 		{
 			const float angle = static_cast<float>(i) / sides * 2.0f * std::numbers::pi_v<float>;
 			const float x = std::cosf(angle) * 0.5f;
@@ -25,17 +43,56 @@ namespace Construct
 			// Push mesh vertex
 			mesh.vertices[3 * i + 0] = x;
 			mesh.vertices[3 * i + 1] = y;
+			mesh.bounds.Add(x, y, 0.0f);
 			// Push mesh UV
-			mesh.textureUVs[2 * i + 0] = x + 0.5f;
-			mesh.textureUVs[2 * i + 1] = -y + 0.5f;
+			if (hasTextureUVs)
+			{
+				mesh.textureUVs[2 * i + 0] = x + 0.5f;
+				mesh.textureUVs[2 * i + 1] = -y + 0.5f;
+			}
 			// First vertex is always center
-			mesh.indices[3 * (i - 1) + 1] = i;
-			mesh.indices[3 * (i - 1) + 2] = i % sides + 1;
+			mesh.indices[3 * (i - 1) + 1] = static_cast<IndexType>(i);
+			mesh.indices[3 * (i - 1) + 2] = static_cast<IndexType>(i % sides + 1);
 		}
 		// Calculate normals
-		mesh.normals = internal::CalculateNormals(mesh.vertices, mesh.indices);
+		if (hasNormals)
+		{
+			internal::CalculateNormals(mesh.vertices, mesh.indices, mesh.normals);
+		}
+		// Tangents are all the same, U follows +x and V follows -y so the frame is left handed
+		if (hasTangents)
+		{
+			for (std::size_t i = 0; i < vertexCount; i++)
+			{
+				mesh.tangents[4 * i + 0] = 1.0f;
+				mesh.tangents[4 * i + 3] = -1.0f;
+			}
+		}
 		// Process mesh for transforms
 		internal::ProcessMesh(mesh, settings);
 		return mesh;
 	}
+	template <typename IndexType>
+	BasicMesh<IndexType> Polygon(ChordalError maxError, const GeneratorSetting& settings)
+	{
+		// The polygon lies in the xy plane, so only those axes stretch the circle
+		return Polygon<IndexType>(internal::ArcSteps(2.0f * std::numbers::pi_v<float>, 0.5f * internal::MaxScale(settings.scale, true, true, false), maxError.value, 3), settings);
+	}
+	template Mesh16 Polygon<std::uint16_t>(std::uint32_t, const GeneratorSetting&);
+	template Mesh Polygon<std::uint32_t>(std::uint32_t, const GeneratorSetting&);
+	template Mesh64 Polygon<std::uint64_t>(std::uint32_t, const GeneratorSetting&);
+	template <typename IndexType>
+	BasicMesh<IndexType> Polygon(GeneratorContext& context, ChordalError maxError, const GeneratorSetting& settings)
+	{
+		return Polygon<IndexType>(context, internal::ArcSteps(2.0f * std::numbers::pi_v<float>, 0.5f * internal::MaxScale(settings.scale, true, true, false), maxError.value, 3), settings);
+	}
+	template Mesh16 Polygon<std::uint16_t>(ChordalError, const GeneratorSetting&);
+	template Mesh Polygon<std::uint32_t>(ChordalError, const GeneratorSetting&);
+	template Mesh64 Polygon<std::uint64_t>(ChordalError, const GeneratorSetting&);
+	template Mesh16 Polygon<std::uint16_t>(GeneratorContext&, std::uint32_t, const GeneratorSetting&);
+	template Mesh Polygon<std::uint32_t>(GeneratorContext&, std::uint32_t, const GeneratorSetting&);
+	template Mesh64 Polygon<std::uint64_t>(GeneratorContext&, std::uint32_t, const GeneratorSetting&);
+	template Mesh16 Polygon<std::uint16_t>(GeneratorContext&, ChordalError, const GeneratorSetting&);
+	template Mesh Polygon<std::uint32_t>(GeneratorContext&, ChordalError, const GeneratorSetting&);
+	template Mesh64 Polygon<std::uint64_t>(GeneratorContext&, ChordalError, const GeneratorSetting&);
 }
\ No newline at end of file
@@ -2,10 +2,23 @@
 
 namespace Construct
 {
-	Mesh Quad(const GeneratorSetting& settings)
+	template <typename IndexType>
+	BasicMesh<IndexType> Quad(const GeneratorSetting& settings)
+	{
+		GeneratorContext context;
+		return Quad<IndexType>(context, settings);
+	}
+	template <typename IndexType>
+	BasicMesh<IndexType> Quad(GeneratorContext& context, const GeneratorSetting& settings)
 	{
 		// Create mesh
-		Mesh mesh = Plane(1, 1, settings);
+		BasicMesh<IndexType> mesh = Plane<IndexType>(context, 1, 1, settings);
 		return mesh;
 	}
-}
\ No newline at end of file
+	template Mesh16 Quad<std::uint16_t>(const GeneratorSetting&);
+	template Mesh Quad<std::uint32_t>(const GeneratorSetting&);
+	template Mesh64 Quad<std::uint64_t>(const GeneratorSetting&);
+	template Mesh16 Quad<std::uint16_t>(GeneratorContext&, const GeneratorSetting&);
+	template Mesh Quad<std::uint32_t>(GeneratorContext&, const GeneratorSetting&);
+	template Mesh64 Quad<std::uint64_t>(GeneratorContext&, const GeneratorSetting&);
+}
@@ -2,9 +2,22 @@
 
 namespace Construct
 {
-	Mesh SkyboxCube(const GeneratorSetting& settings)
+	template <typename IndexType>
+	BasicMesh<IndexType> SkyboxCube(const GeneratorSetting& settings)
 	{
-		Mesh mesh = Cube(settings);
+		GeneratorContext context;
+		return SkyboxCube<IndexType>(context, settings);
+	}
+	template <typename IndexType>
+	BasicMesh<IndexType> SkyboxCube(GeneratorContext& context, const GeneratorSetting& settings)
+	{
+		BasicMesh<IndexType> mesh = Cube<IndexType>(context, settings);
 		return mesh;
 	}
-}
\ No newline at end of file
+	template Mesh16 SkyboxCube<std::uint16_t>(const GeneratorSetting&);
+	template Mesh SkyboxCube<std::uint32_t>(const GeneratorSetting&);
+	template Mesh64 SkyboxCube<std::uint64_t>(const GeneratorSetting&);
+	template Mesh16 SkyboxCube<std::uint16_t>(GeneratorContext&, const GeneratorSetting&);
+	template Mesh SkyboxCube<std::uint32_t>(GeneratorContext&, const GeneratorSetting&);
+	template Mesh64 SkyboxCube<std::uint64_t>(GeneratorContext&, const GeneratorSetting&);
+}
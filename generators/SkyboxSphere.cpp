@@ -2,9 +2,22 @@
 
 namespace Construct
 {
-	Mesh SkyboxSphere(std::uint32_t rings, std::uint32_t segments, const GeneratorSetting& settings)
+	template <typename IndexType>
+	BasicMesh<IndexType> SkyboxSphere(std::uint32_t rings, std::uint32_t segments, const GeneratorSetting& settings)
 	{
-		Mesh mesh = UVSphere(rings, segments, settings);
+		GeneratorContext context;
+		return SkyboxSphere<IndexType>(context, rings, segments, settings);
+	}
+	template <typename IndexType>
+	BasicMesh<IndexType> SkyboxSphere(GeneratorContext& context, std::uint32_t rings, std::uint32_t segments, const GeneratorSetting& settings)
+	{
+		BasicMesh<IndexType> mesh = UVSphere<IndexType>(context, rings, segments, settings);
 		return mesh;
 	}
-}
\ No newline at end of file
+	template Mesh16 SkyboxSphere<std::uint16_t>(std::uint32_t, std::uint32_t, const GeneratorSetting&);
+	template Mesh SkyboxSphere<std::uint32_t>(std::uint32_t, std::uint32_t, const GeneratorSetting&);
+	template Mesh64 SkyboxSphere<std::uint64_t>(std::uint32_t, std::uint32_t, const GeneratorSetting&);
+	template Mesh16 SkyboxSphere<std::uint16_t>(GeneratorContext&, std::uint32_t, std::uint32_t, const GeneratorSetting&);
+	template Mesh SkyboxSphere<std::uint32_t>(GeneratorContext&, std::uint32_t, std::uint32_t, const GeneratorSetting&);
+	template Mesh64 SkyboxSphere<std::uint64_t>(GeneratorContext&, std::uint32_t, std::uint32_t, const GeneratorSetting&);
+}
@@ -1,77 +1,89 @@
 #include "../Construct.hpp"
 
 #include "../internal/ProcessMesh.hpp"
-#include "../internal/CalculateNormals.hpp"
+#include "../internal/GridIndices.hpp"
+#include "../internal/UVSphereVertex.hpp"
+#include "../utils/Compact.hpp"
 
 #include <numbers>
 #include <cmath>
-#include <array>
 
 namespace Construct
 {
-	Mesh UVSphere(std::uint32_t rings, std::uint32_t segments, const GeneratorSetting& settings)
+	std::uint64_t UVSphereVertexCount(std::uint32_t rings, std::uint32_t segments)
+	{
+		return internal::CheckedMultiply(static_cast<std::uint64_t>(rings) + 1, static_cast<std::uint64_t>(segments) + 1);
+	}
+	template <typename IndexType>
+	BasicMesh<IndexType> UVSphere(std::uint32_t rings, std::uint32_t segments, const GeneratorSetting& settings)
+	{
+		GeneratorContext context;
+		return UVSphere<IndexType>(context, rings, segments, settings);
+	}
+	template <typename IndexType>
+	BasicMesh<IndexType> UVSphere(GeneratorContext& context, std::uint32_t rings, std::uint32_t segments, const GeneratorSetting& settings)
 	{
-		// Sphere indice data
-		static constexpr std::array<std::uint32_t, 6> SphereIndexMap = {
-			2, 1, 0,
-			2, 3, 1,
-		};
-		Mesh mesh;
 		// Calculate vertex counts, its similiar to a plane
-		const std::uint32_t vertexCount = (rings + 1) * (segments + 1);
-		const std::uint32_t indexCount = 2 * 3 * rings * segments;
+		const std::size_t vertexCount = internal::CheckedVertexCount<IndexType>(UVSphereVertexCount(rings, segments));
+		const std::size_t indexCount = internal::CheckedIndexCount<IndexType>(internal::GridIndexCount(rings, segments, settings.topology));
 		// Preallocate
-		mesh.vertices.resize(3 * vertexCount, 0.0f);
-		mesh.indices.resize(indexCount, 0);
-		mesh.textureUVs.resize(2 * vertexCount, 0.0f);
+		const bool hasNormals = settings.HasAttribute(VertexAttribute::Normal);
+		const bool hasTextureUVs = settings.HasAttribute(VertexAttribute::TextureUV);
+		const bool hasTangents = settings.HasAttribute(VertexAttribute::Tangent);
+		// Lists need their indices to drop the triangles at the poles
+		const bool writeIndices = settings.generateIndices || settings.topology == Topology::TriangleList;
+		BasicMesh<IndexType> mesh = context.NewMesh<IndexType>(3 * vertexCount, writeIndices ? indexCount : 0, hasNormals ? 3 * vertexCount : 0, hasTextureUVs ? 2 * vertexCount : 0, hasTangents ? 4 * vertexCount : 0);
+		mesh.topology = settings.topology;
 		// Calculate the vertex positions and texture coordinates
 		for (std::uint32_t i = 0; i <= rings; i++)
 		{
-			float latitude = (float)i / (float)rings;
-			float theta = latitude * std::numbers::pi_v<float>;
-			// Cache Y value, it doesn't change as often
-			float y = std::cosf(theta) * 0.5;
-			float sinTheta = std::sinf(theta);
+			// Cache ring values, they don't change as often
+			const internal::UVSphereRing ring = internal::UVSphereRingAt(i, rings);
 			for (std::uint32_t j = 0; j <= segments; j++)
 			{
-				float longitude = (float)j / (float)segments;
-				float phi = -longitude * 2.0f * std::numbers::pi_v<float>;
-				// Calculate positions
-				float x = std::cosf(phi) * sinTheta * 0.5f;
-				float z = std::sinf(phi) * sinTheta * 0.5f;
 				// Calculate vertex index
-				std::uint32_t index = (i * (segments + 1) + j);
-				// Add vertices
-				mesh.vertices[3 * index + 0] = x;
-				mesh.vertices[3 * index + 1] = y;
-				mesh.vertices[3 * index + 2] = z;
-				// Add texture UVs
-				mesh.textureUVs[2 * index + 0] = longitude;
-				mesh.textureUVs[2 * index + 1] = latitude;
-				// n + 1 verts but n squares
-				if (i < rings && j < segments)
-				{
-					// Calculate index of quad corners
-					const std::uint32_t corners[4]
-					{
-						((i + 0) * (segments + 1)) + j + 0,
-						((i + 0) * (segments + 1)) + j + 1,
-						((i + 1) * (segments + 1)) + j + 0,
-						((i + 1) * (segments + 1)) + j + 1,
-					};
-					std::uint32_t index = 6 * (i * segments + j);
-					// Use the plane index map to generate the triangles
-					for (std::uint32_t k = 0; k < 6; k++)
-					{
-						mesh.indices[index + k] = corners[SphereIndexMap[k]];
-					}
-				}
+				std::size_t index = (i * (static_cast<std::size_t>(segments) + 1) + j);
+				internal::UVSphereVertex(ring, j, segments, &mesh.vertices[3 * index],
+					hasNormals ? &mesh.normals[3 * index] : nullptr,
+					hasTextureUVs ? &mesh.textureUVs[2 * index] : nullptr,
+					hasTangents ? &mesh.tangents[4 * index] : nullptr);
+				mesh.bounds.Add(mesh.vertices[3 * index + 0], mesh.vertices[3 * index + 1], mesh.vertices[3 * index + 2]);
 			}
 		}
-		// Calculate normals
-		mesh.normals = internal::CalculateNormals(mesh.vertices, mesh.indices);
+		// Sphere quads are flipped relative to the plane, strips are additionally wound here as ProcessMesh only flips triangle lists
+		const bool flip = !(settings.topology == Topology::TriangleStrip && settings.windingOrder == WindingOrder::CW);
+		internal::GridIndices<IndexType>(writeIndices ? mesh.indices.data() : nullptr, 0, rings, segments, flip, settings.topology);
+		// Remove the zero area triangles at the poles, strips are kept whole
+		if (mesh.topology == Topology::TriangleList)
+		{
+			Compact(mesh, context);
+		}
 		// Process mesh for transforms
 		internal::ProcessMesh(mesh, settings);
 		return mesh;
 	}
+	template <typename IndexType>
+	BasicMesh<IndexType> UVSphere(ChordalError maxError, const GeneratorSetting& settings)
+	{
+		GeneratorContext context;
+		return UVSphere<IndexType>(context, maxError, settings);
+	}
+	template <typename IndexType>
+	BasicMesh<IndexType> UVSphere(GeneratorContext& context, ChordalError maxError, const GeneratorSetting& settings)
+	{
+		const internal::SphereTessellation tessellation = internal::SphereTessellationFor(std::numbers::pi_v<float>, 0.5f, maxError, settings.scale);
+		return UVSphere<IndexType>(context, tessellation.rings, tessellation.segments, settings);
+	}
+	template Mesh16 UVSphere<std::uint16_t>(std::uint32_t, std::uint32_t, const GeneratorSetting&);
+	template Mesh UVSphere<std::uint32_t>(std::uint32_t, std::uint32_t, const GeneratorSetting&);
+	template Mesh64 UVSphere<std::uint64_t>(std::uint32_t, std::uint32_t, const GeneratorSetting&);
+	template Mesh16 UVSphere<std::uint16_t>(ChordalError, const GeneratorSetting&);
+	template Mesh UVSphere<std::uint32_t>(ChordalError, const GeneratorSetting&);
+	template Mesh64 UVSphere<std::uint64_t>(ChordalError, const GeneratorSetting&);
+	template Mesh16 UVSphere<std::uint16_t>(GeneratorContext&, std::uint32_t, std::uint32_t, const GeneratorSetting&);
+	template Mesh UVSphere<std::uint32_t>(GeneratorContext&, std::uint32_t, std::uint32_t, const GeneratorSetting&);
+	template Mesh64 UVSphere<std::uint64_t>(GeneratorContext&, std::uint32_t, std::uint32_t, const GeneratorSetting&);
+	template Mesh16 UVSphere<std::uint16_t>(GeneratorContext&, ChordalError, const GeneratorSetting&);
+	template Mesh UVSphere<std::uint32_t>(GeneratorContext&, ChordalError, const GeneratorSetting&);
+	template Mesh64 UVSphere<std::uint64_t>(GeneratorContext&, ChordalError, const GeneratorSetting&);
 }
\ No newline at end of file
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "types.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace Construct
+{
+	/// <summary>
+	/// Axis aligned bounding box and bounding sphere of a mesh.
+	/// Default constructed bounds are empty and contain nothing
+	/// </summary>
+	struct Bounds
+	{
+		/// <summary>
+		/// Minimum corner of the axis aligned bounding box
+		/// </summary>
+		vec3 min = vec3(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+		/// <summary>
+		/// Maximum corner of the axis aligned bounding box
+		/// </summary>
+		vec3 max = vec3(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest());
+		/// <summary>
+		/// Center of the bounding sphere
+		/// </summary>
+		vec3 center;
+		/// <summary>
+		/// Radius of the bounding sphere, negative if the bounds are empty
+		/// </summary>
+		float radius = -1.0f;
+		// Default constructor
+		inline Bounds() = default;
+		/// <summary>
+		/// Initialise empty bounds with a fixed sphere center, points added later grow the sphere around it
+		/// </summary>
+		inline Bounds(const vec3& sphereCenter) : center(sphereCenter) {}
+		/// <summary>
+		/// Whether the bounds contain nothing
+		/// </summary>
+		inline bool Empty() const
+		{
+			return this->radius < 0.0f;
+		}
+		/// <summary>
+		/// Grows the bounds to contain a point
+		/// </summary>
+		inline void Add(float x, float y, float z)
+		{
+			this->min = vec3(std::min(this->min.x, x), std::min(this->min.y, y), std::min(this->min.z, z));
+			this->max = vec3(std::max(this->max.x, x), std::max(this->max.y, y), std::max(this->max.z, z));
+			const float dx = x - this->center.x, dy = y - this->center.y, dz = z - this->center.z;
+			const float distanceSquared = dx * dx + dy * dy + dz * dz;
+			if (this->radius < 0.0f || distanceSquared > this->radius * this->radius)
+			{
+				this->radius = std::sqrtf(distanceSquared);
+			}
+		}
+		/// <summary>
+		/// Grows the bounds to contain a list of 3 tuple vertices (X, Y, Z)
+		/// </summary>
+		inline void Add(const std::vector<float>& vertices)
+		{
+			for (std::size_t i = 0, size = vertices.size(); i + 2 < size; i += 3)
+			{
+				this->Add(vertices[i + 0], vertices[i + 1], vertices[i + 2]);
+			}
+		}
+		/// <summary>
+		/// Calculates bounds for arbitrary vertices, centering the sphere on the box
+		/// </summary>
+		/// <param name="vertices">float list of 3 tuple vertices (X, Y, Z)</param>
+		/// <returns>Bounds of the vertices</returns>
+		static inline Bounds FromVertices(const std::vector<float>& vertices)
+		{
+			Bounds box;
+			box.Add(vertices);
+			if (box.Empty())
+			{
+				return box;
+			}
+			Bounds bounds(vec3(0.5f * (box.min.x + box.max.x), 0.5f * (box.min.y + box.max.y), 0.5f * (box.min.z + box.max.z)));
+			bounds.Add(vertices);
+			return bounds;
+		}
+		/// <summary>
+		/// Grows the bounds to contain other bounds.
+		/// The box is exact, the sphere is the smallest sphere containing both spheres
+		/// </summary>
+		inline void Add(const Bounds& other)
+		{
+			if (other.Empty())
+			{
+				return;
+			}
+			if (this->Empty())
+			{
+				*this = other;
+				return;
+			}
+			this->min = vec3(std::min(this->min.x, other.min.x), std::min(this->min.y, other.min.y), std::min(this->min.z, other.min.z));
+			this->max = vec3(std::max(this->max.x, other.max.x), std::max(this->max.y, other.max.y), std::max(this->max.z, other.max.z));
+			const float dx = other.center.x - this->center.x, dy = other.center.y - this->center.y, dz = other.center.z - this->center.z;
+			const float distance = std::sqrtf(dx * dx + dy * dy + dz * dz);
+			// One sphere already contains the other
+			if (distance + other.radius <= this->radius)
+			{
+				return;
+			}
+			if (distance + this->radius <= other.radius)
+			{
+				this->center = other.center;
+				this->radius = other.radius;
+				return;
+			}
+			const float radius = 0.5f * (distance + this->radius + other.radius);
+			const float t = (radius - this->radius) / distance;
+			this->center = vec3(this->center.x + dx * t, this->center.y + dy * t, this->center.z + dz * t);
+			this->radius = radius;
+		}
+	};
+}
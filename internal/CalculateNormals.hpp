@@ -1,19 +1,25 @@
 #pragma once
 
+#include "Topology.hpp"
+
 #include <vector>
 #include <cstdint>
 #include <cmath>
 
 namespace Construct::internal
 {
-	inline const std::vector<float> CalculateNormals(const std::vector<float>& vertices, const std::vector<std::uint32_t>& indices)
+	/// <summary>
+	/// Calculates faceted normals into an existing buffer, reusing its capacity
+	/// </summary>
+	template <typename IndexType>
+	inline void CalculateNormals(const std::vector<float>& vertices, const std::vector<IndexType>& indices, std::vector<float>& normals, Topology topology = Topology::TriangleList)
 	{
-		std::vector<float> normals(vertices.size(), 0.0f);
-		for (std::uint32_t i = 0; i < indices.size(); i += 3) {
+		normals.assign(vertices.size(), 0.0f);
+		ForEachTriangle(indices, topology, [&](IndexType index1, IndexType index2, IndexType index3) {
 			// Get index of vertices in triangle
-			const std::uint32_t i1 = indices[i + 0] * 3,
-				i2 = indices[i + 1] * 3,
-				i3 = indices[i + 2] * 3;
+			const std::size_t i1 = static_cast<std::size_t>(index1) * 3,
+				i2 = static_cast<std::size_t>(index2) * 3,
+				i3 = static_cast<std::size_t>(index3) * 3;
 			// Vertex 1
 			const float x1 = vertices[i1 + 0],
 				y1 = vertices[i1 + 1],
@@ -57,7 +63,13 @@ namespace Construct::internal
 			normals[i3 + 0] = nx;
 			normals[i3 + 1] = ny;
 			normals[i3 + 2] = nz;
-		}
+		});
+	}
+	template <typename IndexType>
+	inline const std::vector<float> CalculateNormals(const std::vector<float>& vertices, const std::vector<IndexType>& indices, Topology topology = Topology::TriangleList)
+	{
+		std::vector<float> normals;
+		CalculateNormals(vertices, indices, normals, topology);
 		return normals;
 	}
 }
\ No newline at end of file
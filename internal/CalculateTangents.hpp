@@ -0,0 +1,170 @@
+#pragma once
+
+#include "Topology.hpp"
+#include "GeneratorContext.hpp"
+
+#include <algorithm>
+#include <vector>
+#include <cstdint>
+#include <cmath>
+
+namespace Construct::internal
+{
+	/// <summary>
+	/// Calculates per vertex tangents from texture UVs, following MikkTSpace:
+	/// face tangents are normalised, projected onto each vertex's tangent plane and weighted by the corner angle.
+	/// Vertices are not split, so vertices shared by mirrored faces get a single averaged tangent.
+	/// Written as flat loops over contiguous arrays so the per face and per vertex passes can be auto-vectorised
+	/// </summary>
+	/// <param name="vertices">float list of 3 tuple vertices (X, Y, Z)</param>
+	/// <param name="normals">float list of 3 tuple normals, if empty smooth normals are derived from the faces</param>
+	/// <param name="textureUVs">float list of 2 tuple texture coordinates</param>
+	/// <param name="indices">Index buffer of the mesh</param>
+	/// <param name="tangents">Receives the float list of 4 tuple tangents (TX, TY, TZ, W), its capacity is reused</param>
+	/// <param name="context">Context whose scratch buffers hold the face frames and sums</param>
+	/// <param name="topology">How the index buffer is assembled</param>
+	template <typename IndexType>
+	inline void CalculateTangents(const std::vector<float>& vertices, const std::vector<float>& normals, const std::vector<float>& textureUVs, const std::vector<IndexType>& indices, std::vector<float>& tangents, GeneratorContext& context, Topology topology = Topology::TriangleList)
+	{
+		const std::size_t vertexCount = vertices.size() / 3;
+		// Lists are read in place, strips are expanded into a scratch list first
+		const IndexType* triangles = indices.data();
+		std::size_t triangleCount = indices.size() / 3;
+		if (topology == Topology::TriangleStrip)
+		{
+			std::vector<IndexType>& list = context.Scratch<IndexType>(0);
+			list.clear();
+			ForEachTriangle(indices, topology, [&](IndexType i1, IndexType i2, IndexType i3) {
+				list.push_back(i1);
+				list.push_back(i2);
+				list.push_back(i3);
+			});
+			triangles = list.data();
+			triangleCount = list.size() / 3;
+		}
+		// Face frames, structure of arrays so the loop has no dependencies between triangles
+		std::vector<float>& faceTangents = context.Scratch<float>(0);
+		std::vector<float>& faceBitangents = context.Scratch<float>(1);
+		std::vector<float>& faceNormals = context.Scratch<float>(2);
+		faceTangents.resize(3 * triangleCount);
+		faceBitangents.resize(3 * triangleCount);
+		faceNormals.resize(3 * triangleCount);
+		for (std::size_t f = 0; f < triangleCount; f++)
+		{
+			const std::size_t i0 = triangles[f * 3 + 0], i1 = triangles[f * 3 + 1], i2 = triangles[f * 3 + 2];
+			const float e1x = vertices[i1 * 3 + 0] - vertices[i0 * 3 + 0],
+				e1y = vertices[i1 * 3 + 1] - vertices[i0 * 3 + 1],
+				e1z = vertices[i1 * 3 + 2] - vertices[i0 * 3 + 2];
+			const float e2x = vertices[i2 * 3 + 0] - vertices[i0 * 3 + 0],
+				e2y = vertices[i2 * 3 + 1] - vertices[i0 * 3 + 1],
+				e2z = vertices[i2 * 3 + 2] - vertices[i0 * 3 + 2];
+			const float du1 = textureUVs[i1 * 2 + 0] - textureUVs[i0 * 2 + 0],
+				dv1 = textureUVs[i1 * 2 + 1] - textureUVs[i0 * 2 + 1];
+			const float du2 = textureUVs[i2 * 2 + 0] - textureUVs[i0 * 2 + 0],
+				dv2 = textureUVs[i2 * 2 + 1] - textureUVs[i0 * 2 + 1];
+			// Only the orientation of the UV mapping matters, faces with zero UV area contribute nothing
+			const float determinant = du1 * dv2 - du2 * dv1;
+			const float orientation = (determinant > 0.0f) ? 1.0f : ((determinant < 0.0f) ? -1.0f : 0.0f);
+			faceTangents[f * 3 + 0] = (e1x * dv2 - e2x * dv1) * orientation;
+			faceTangents[f * 3 + 1] = (e1y * dv2 - e2y * dv1) * orientation;
+			faceTangents[f * 3 + 2] = (e1z * dv2 - e2z * dv1) * orientation;
+			faceBitangents[f * 3 + 0] = (e2x * du1 - e1x * du2) * orientation;
+			faceBitangents[f * 3 + 1] = (e2y * du1 - e1y * du2) * orientation;
+			faceBitangents[f * 3 + 2] = (e2z * du1 - e1z * du2) * orientation;
+			faceNormals[f * 3 + 0] = e1y * e2z - e1z * e2y;
+			faceNormals[f * 3 + 1] = e1z * e2x - e1x * e2z;
+			faceNormals[f * 3 + 2] = e1x * e2y - e1y * e2x;
+		}
+		// Smooth normals weighted by area, only if the mesh has none
+		std::vector<float>& derivedNormals = context.Scratch<float>(3);
+		if (normals.empty())
+		{
+			derivedNormals.assign(3 * vertexCount, 0.0f);
+			for (std::size_t f = 0; f < triangleCount; f++)
+			{
+				for (std::size_t c = 0; c < 3; c++)
+				{
+					for (std::size_t k = 0; k < 3; k++)
+					{
+						derivedNormals[triangles[f * 3 + c] * 3 + k] += faceNormals[f * 3 + k];
+					}
+				}
+			}
+		}
+		const std::vector<float>& vertexNormals = normals.empty() ? derivedNormals : normals;
+		// Accumulate the face frames at each corner
+		std::vector<float>& tangentSums = context.Scratch<float>(4);
+		std::vector<float>& bitangentSums = context.Scratch<float>(5);
+		tangentSums.assign(3 * vertexCount, 0.0f);
+		bitangentSums.assign(3 * vertexCount, 0.0f);
+		for (std::size_t f = 0; f < triangleCount; f++)
+		{
+			for (std::size_t c = 0; c < 3; c++)
+			{
+				const std::size_t v = triangles[f * 3 + c];
+				const std::size_t previous = triangles[f * 3 + (c + 2) % 3], next = triangles[f * 3 + (c + 1) % 3];
+				// Corner angle
+				const float ax = vertices[next * 3 + 0] - vertices[v * 3 + 0],
+					ay = vertices[next * 3 + 1] - vertices[v * 3 + 1],
+					az = vertices[next * 3 + 2] - vertices[v * 3 + 2];
+				const float bx = vertices[previous * 3 + 0] - vertices[v * 3 + 0],
+					by = vertices[previous * 3 + 1] - vertices[v * 3 + 1],
+					bz = vertices[previous * 3 + 2] - vertices[v * 3 + 2];
+				const float lengths = std::sqrtf((ax * ax + ay * ay + az * az) * (bx * bx + by * by + bz * bz));
+				const float angle = (lengths > 0.0f) ? std::acosf(std::clamp((ax * bx + ay * by + az * bz) / lengths, -1.0f, 1.0f)) : 0.0f;
+				// Project the face frame onto the vertex tangent plane, then normalise
+				const float nx = vertexNormals[v * 3 + 0], ny = vertexNormals[v * 3 + 1], nz = vertexNormals[v * 3 + 2];
+				const float nn = nx * nx + ny * ny + nz * nz;
+				const float inverseNN = (nn > 0.0f) ? 1.0f / nn : 0.0f;
+				for (std::uint32_t frame = 0; frame < 2; frame++)
+				{
+					const float* face = (frame == 0) ? &faceTangents[f * 3] : &faceBitangents[f * 3];
+					float* sum = (frame == 0) ? &tangentSums[v * 3] : &bitangentSums[v * 3];
+					const float d = (face[0] * nx + face[1] * ny + face[2] * nz) * inverseNN;
+					const float px = face[0] - nx * d, py = face[1] - ny * d, pz = face[2] - nz * d;
+					const float length = std::sqrtf(px * px + py * py + pz * pz);
+					const float weight = (length > 0.0f) ? angle / length : 0.0f;
+					sum[0] += px * weight;
+					sum[1] += py * weight;
+					sum[2] += pz * weight;
+				}
+			}
+		}
+		// Orthonormalise against the normal and find the handedness
+		tangents.resize(4 * vertexCount);
+		for (std::size_t v = 0; v < vertexCount; v++)
+		{
+			float nx = vertexNormals[v * 3 + 0], ny = vertexNormals[v * 3 + 1], nz = vertexNormals[v * 3 + 2];
+			const float normalLength = std::sqrtf(nx * nx + ny * ny + nz * nz);
+			const float inverseNormalLength = (normalLength > 0.0f) ? 1.0f / normalLength : 0.0f;
+			nx *= inverseNormalLength;
+			ny *= inverseNormalLength;
+			nz *= inverseNormalLength;
+			const float d = tangentSums[v * 3 + 0] * nx + tangentSums[v * 3 + 1] * ny + tangentSums[v * 3 + 2] * nz;
+			const float tx = tangentSums[v * 3 + 0] - nx * d,
+				ty = tangentSums[v * 3 + 1] - ny * d,
+				tz = tangentSums[v * 3 + 2] - nz * d;
+			const float length = std::sqrtf(tx * tx + ty * ty + tz * tz);
+			const float inverseLength = (length > 0.0f) ? 1.0f / length : 0.0f;
+			tangents[v * 4 + 0] = tx * inverseLength;
+			tangents[v * 4 + 1] = ty * inverseLength;
+			tangents[v * 4 + 2] = tz * inverseLength;
+			// Handedness is whether cross(normal, tangent) agrees with the bitangent
+			const float cx = ny * tz - nz * ty, cy = nz * tx - nx * tz, cz = nx * ty - ny * tx;
+			const float handedness = cx * bitangentSums[v * 3 + 0] + cy * bitangentSums[v * 3 + 1] + cz * bitangentSums[v * 3 + 2];
+			tangents[v * 4 + 3] = (handedness < 0.0f) ? -1.0f : 1.0f;
+		}
+	}
+	/// <summary>
+	/// Calculates per vertex tangents from texture UVs, using a temporary context
+	/// </summary>
+	/// <returns>float list of 4 tuple tangents (TX, TY, TZ, W)</returns>
+	template <typename IndexType>
+	inline std::vector<float> CalculateTangents(const std::vector<float>& vertices, const std::vector<float>& normals, const std::vector<float>& textureUVs, const std::vector<IndexType>& indices, Topology topology = Topology::TriangleList)
+	{
+		GeneratorContext context;
+		std::vector<float> tangents;
+		CalculateTangents(vertices, normals, textureUVs, indices, tangents, context, topology);
+		return tangents;
+	}
+}
@@ -1,88 +1,114 @@
 #pragma once
 
 #include "Mesh.hpp"
+#include "GridIndices.hpp"
 
-#include <array>
 #include <cstdint>
 #include <numbers>
 #include <cmath>
 
 namespace Construct::internal
 {
-	inline Mesh CapsuleHead(std::uint32_t sides)
+	/// <summary>
+	/// Number of vertices written by CapsuleHead
+	/// </summary>
+	inline std::uint64_t CapsuleHeadVertexCount(std::uint32_t segments, std::uint32_t rings)
 	{
-		// Sphere indice data
-		static constexpr std::array<std::uint32_t, 6> SphereIndexMap = {
-			2, 1, 0,
-			2, 3, 1,
-		};
-		const uint32_t rings = sides / 2;
-		const uint32_t segments = sides;
-		Mesh mesh;
-		// Calculate vertex counts, its similiar to a plane
-		const std::uint32_t vertexCount = 2 * (rings + 1) * (segments + 1);
-		const std::uint32_t indexCount = 2 * 2 * rings * segments;
-		// Preallocate
-		mesh.vertices.resize(3 * vertexCount, 0.0f);
-		mesh.indices.resize(3 * indexCount, 0);
-		mesh.textureUVs.resize(2 * vertexCount, 0.0f);
+		return CheckedMultiply(2 * (static_cast<std::uint64_t>(rings) + 1), static_cast<std::uint64_t>(segments) + 1);
+	}
+	/// <summary>
+	/// Number of indices written by CapsuleHead
+	/// </summary>
+	inline std::uint64_t CapsuleHeadIndexCount(std::uint32_t segments, std::uint32_t rings, Topology topology)
+	{
+		return CheckedMultiply(2, GridIndexCount(rings, segments, topology));
+	}
+	/// <summary>
+	/// Writes both hemispheres of a capsule into a preallocated mesh, with analytic normals and tangents.
+	/// Texture UVs are a top down projection of each hemisphere, squashed into the left 1.0f / (1.0f + pi) of the texture,
+	/// the top hemisphere uses the top half and the bottom hemisphere uses the bottom half.
+	/// Normals, texture UVs and tangents are only written if the mesh has them allocated
+	/// </summary>
+	/// <param name="mesh">Mesh with room for CapsuleHeadVertexCount vertices after baseVertex</param>
+	/// <param name="baseVertex">Index of the first vertex to write</param>
+	/// <param name="indexOutput">Output pointer with room for CapsuleHeadIndexCount indices</param>
+	/// <param name="segments">Number of segments around the capsule</param>
+	/// <param name="rings">Number of rings from the pole to the equator of each hemisphere</param>
+	/// <param name="radius">Radius of the hemispheres</param>
+	/// <param name="height">Distance between the centers of the hemispheres</param>
+	/// <param name="flip">Reverses the winding of every triangle</param>
+	/// <param name="topology">Topology to write the indices in</param>
+	/// <returns>Pointer to one past the last written index</returns>
+	template <typename IndexType>
+	inline IndexType* CapsuleHead(BasicMesh<IndexType>& mesh, IndexType baseVertex, IndexType* indexOutput, std::uint32_t segments, std::uint32_t rings, float radius, float height, bool flip, Topology topology)
+	{
+		const bool hasNormals = !mesh.normals.empty();
+		const bool hasTextureUVs = !mesh.textureUVs.empty();
+		const bool hasTangents = !mesh.tangents.empty();
+		const float textureUScale = 1.0f / (1.0f + std::numbers::pi_v<float>);
 		// Calculate the vertex positions and texture coordinates
 		for (std::uint32_t l = 0; l < 2; l++)
 		{
 			float side = ((l == 0) ? 1.0f : -1.0f);
-			std::uint32_t startingIndex = l * (segments + 1) * (rings + 1);
-			std::uint32_t indexStartingIndex = l * segments * rings;
+			std::size_t startingIndex = baseVertex + l * (static_cast<std::size_t>(segments) + 1) * (static_cast<std::size_t>(rings) + 1);
 			for (std::uint32_t i = 0; i <= rings; i++)
 			{
 				float latitude = (float)i / (float)rings;
 				float theta = latitude * 0.5f * std::numbers::pi_v<float>;
 				// Cache Y value, it doesn't change as often
-				float y = std::cosf(theta) * 0.5;
+				float y = std::cosf(theta);
 				float sinTheta = std::sinf(theta);
 
 				for (std::uint32_t j = 0; j <= segments; j++)
 				{
 					float longitude = (float)j / (float)segments;
 					float phi = -longitude * 2.0f * std::numbers::pi_v<float>;
-					// Calculate positions
-					float x = std::cosf(phi) * sinTheta * 0.5f;
-					float z = std::sinf(phi) * sinTheta * 0.5f;
+					// Calculate direction from the center of the hemisphere
+					float x = std::cosf(phi) * sinTheta;
+					float z = std::sinf(phi) * sinTheta;
 					// Calculate vertex index
-					std::uint32_t index = startingIndex + (i * (segments + 1) + j);
+					std::size_t index = startingIndex + (i * (static_cast<std::size_t>(segments) + 1) + j);
 					// Add vertices
-					mesh.vertices[3 * index + 0] = x;
-					mesh.vertices[3 * index + 1] = (y + 0.5f) * side;
-					mesh.vertices[3 * index + 2] = z;
+					mesh.vertices[3 * index + 0] = x * radius;
+					mesh.vertices[3 * index + 1] = (y * radius + 0.5f * height) * side;
+					mesh.vertices[3 * index + 2] = z * radius;
+					mesh.bounds.Add(mesh.vertices[3 * index + 0], mesh.vertices[3 * index + 1], mesh.vertices[3 * index + 2]);
+					// Add normals, the direction from the center of the hemisphere
+					if (hasNormals)
+					{
+						mesh.normals[3 * index + 0] = x;
+						mesh.normals[3 * index + 1] = y * side;
+						mesh.normals[3 * index + 2] = z;
+					}
 					// Add texture UVs
-					mesh.textureUVs[2 * index + 0] = 0.5f + x;
-					mesh.textureUVs[2 * index + 1] = 0.25f + ((l == 0) ? 0.0f : 0.5f) + z * 0.5f;
-					// n + 1 verts but n squares
-					if (i < rings && j < segments)
+					if (hasTextureUVs)
 					{
-						// Calculate index of quad corners
-						const std::uint32_t corners[4]
-						{
-							((i + 0) * (segments + 1)) + j + 0,
-							((i + 0) * (segments + 1)) + j + 1,
-							((i + 1) * (segments + 1)) + j + 0,
-							((i + 1) * (segments + 1)) + j + 1,
-						};
-						std::uint32_t index = 6 * (indexStartingIndex + i * segments + j);
-						// Use the plane index map to generate the triangles
-						for (std::uint32_t k = 0; k < 6; k++)
+						mesh.textureUVs[2 * index + 0] = (0.5f + x * 0.5f) * textureUScale;
+						mesh.textureUVs[2 * index + 1] = 0.25f + ((l == 0) ? 0.0f : 0.5f) + z * 0.25f;
+					}
+					// Texture UVs are a projection along y, with U following x and V following z.
+					// The tangent is the surface direction that keeps z constant, which makes the top hemisphere left handed and the bottom right handed
+					if (hasTangents)
+					{
+						float tx = y, ty = -side * x, tz = 0.0f;
+						float length = std::sqrtf(tx * tx + ty * ty);
+						// Where the normal is +-z the tangent plane is xy and U simply follows +x
+						if (length < 1e-6f)
 						{
-							std::uint32_t indexOffset = ((l == 0) ? k : 6 - k - 1);
-							mesh.indices[index + indexOffset] = startingIndex + corners[SphereIndexMap[k]];
+							tx = 1.0f;
+							ty = 0.0f;
+							length = 1.0f;
 						}
+						mesh.tangents[4 * index + 0] = tx / length;
+						mesh.tangents[4 * index + 1] = ty / length;
+						mesh.tangents[4 * index + 2] = tz / length;
+						mesh.tangents[4 * index + 3] = -side;
 					}
 				}
 			}
+			// Top hemisphere is wound like a sphere, the bottom hemisphere is mirrored
+			indexOutput = GridIndices(indexOutput, static_cast<IndexType>(startingIndex), rings, segments, (l == 0) != flip, topology);
 		}
-		// Remap x coordinate
-		for (std::uint32_t i = 0, size = mesh.textureUVs.size(); i < size; i += 2)
-		{
-			mesh.textureUVs[i] /= 1.0f + std::numbers::pi_v<float>;
-		}
-		return mesh;
+		return indexOutput;
 	}
-}
\ No newline at end of file
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Mesh.hpp"
+#include "GridIndices.hpp"
 
 #include <numbers>
 #include <cmath>
@@ -8,49 +9,190 @@
 
 namespace Construct::internal
 {
-	inline Mesh CylinderBody(std::uint32_t sides)
+	/// <summary>
+	/// Number of vertices written by CylinderBody
+	/// </summary>
+	inline std::uint64_t CylinderBodyVertexCount(std::uint32_t sides)
 	{
-		Mesh mesh;
-		// Calculate number of vertices for preallocation
-		const std::uint32_t vertexCount = 2 * (sides + 1);
-		const std::uint32_t triangleCount = 2 * sides + 1;
-		// Preallocate
-		mesh.vertices = std::vector<float>(3 * vertexCount, 0.0f);
-		mesh.indices = std::vector<std::uint32_t>(3 * triangleCount, 0);
-		// Can't preallocate normals though
-		// Texture UV's U component is between [0.0f, 1.0f + pi], remapped to [0.0f, 1.0f] later
-		mesh.textureUVs = std::vector<float>(2 * vertexCount, 0.0f);
-		for (std::uint32_t i = 0; i < 2; i++)
+		return 2 * (static_cast<std::uint64_t>(sides) + 1);
+	}
+	/// <summary>
+	/// Number of indices written by CylinderBody
+	/// </summary>
+	inline std::uint64_t CylinderBodyIndexCount(std::uint32_t sides, Topology topology)
+	{
+		return GridIndexCount(1, sides, topology);
+	}
+	/// <summary>
+	/// Writes the side of a cylinder into a preallocated mesh, with analytic normals and tangents.
+	/// Texture UV's U component is in [1.0f / (1.0f + pi), 1.0f], leaving room on the left for caps.
+	/// Normals, texture UVs and tangents are only written if the mesh has them allocated
+	/// </summary>
+	/// <param name="mesh">Mesh with room for CylinderBodyVertexCount vertices after baseVertex</param>
+	/// <param name="baseVertex">Index of the first vertex to write</param>
+	/// <param name="indexOutput">Output pointer with room for CylinderBodyIndexCount indices</param>
+	/// <param name="sides">Number of sides</param>
+	/// <param name="radius">Radius of the cylinder</param>
+	/// <param name="height">Distance between the top and bottom rings, centered on y = 0</param>
+	/// <param name="flip">Reverses the winding of every triangle</param>
+	/// <param name="topology">Topology to write the indices in</param>
+	/// <returns>Pointer to one past the last written index</returns>
+	template <typename IndexType>
+	inline IndexType* CylinderBody(BasicMesh<IndexType>& mesh, IndexType baseVertex, IndexType* indexOutput, std::uint32_t sides, float radius, float height, bool flip, Topology topology)
+	{
+		const bool hasNormals = !mesh.normals.empty();
+		const bool hasTextureUVs = !mesh.textureUVs.empty();
+		const bool hasTangents = !mesh.tangents.empty();
+		for (std::uint32_t j = 0; j <= sides; j++)
 		{
-			std::uint32_t vertexOffset = i * (sides + 1);
-			for (std::uint32_t j = 0; j <= sides; j++)
+			const float angle = static_cast<float>(j) / static_cast<float>(sides) * 2.0f * std::numbers::pi_v<float>;
+			const float nx = std::cosf(angle);
+			const float nz = std::sinf(angle);
+			const float textureU = (1.0f + (1.0f - static_cast<float>(j) / sides) * std::numbers::pi_v<float>) / (1.0f + std::numbers::pi_v<float>);
+			// Top ring is row 0, bottom ring is row 1
+			for (std::uint32_t i = 0; i < 2; i++)
 			{
-				const float angle = static_cast<float>(j) / static_cast<float>(sides) * 2.0f * std::numbers::pi_v<float>;
-				const float x = std::cosf(angle) * 0.5f;
-				const float z = std::sinf(angle) * 0.5f;
-				const float textureU = 1.0f + (1.0f - static_cast<float>(j) / sides) * std::numbers::pi_v<float>;
-				const std::uint32_t index = (j + vertexOffset);
+				const std::size_t index = baseVertex + i * (static_cast<std::size_t>(sides) + 1) + j;
 				// Push side vertices
-				mesh.vertices[index * 3 + 0] = x;
-				mesh.vertices[index * 3 + 1] = (i == 0) ? 0.5f : -0.5f;
-				mesh.vertices[index * 3 + 2] = z;
+				mesh.vertices[index * 3 + 0] = nx * radius;
+				mesh.vertices[index * 3 + 1] = (i == 0) ? 0.5f * height : -0.5f * height;
+				mesh.vertices[index * 3 + 2] = nz * radius;
+				mesh.bounds.Add(mesh.vertices[index * 3 + 0], mesh.vertices[index * 3 + 1], mesh.vertices[index * 3 + 2]);
+				// Push side normals, pointing straight out
+				if (hasNormals)
+				{
+					mesh.normals[index * 3 + 0] = nx;
+					mesh.normals[index * 3 + 1] = 0.0f;
+					mesh.normals[index * 3 + 2] = nz;
+				}
 				// Push side mesh UV
-				mesh.textureUVs[index * 2 + 0] = textureU;
-				mesh.textureUVs[index * 2 + 1] = (i == 0) ? 0.0f : 1.0f;
-				// Push side mesh indices 
-				if (j < sides)
+				if (hasTextureUVs)
+				{
+					mesh.textureUVs[index * 2 + 0] = textureU;
+					mesh.textureUVs[index * 2 + 1] = (i == 0) ? 0.0f : 1.0f;
+				}
+				// U decreases with the angle and V increases downwards, so the frame is left handed
+				if (hasTangents)
+				{
+					mesh.tangents[index * 4 + 0] = nz;
+					mesh.tangents[index * 4 + 1] = 0.0f;
+					mesh.tangents[index * 4 + 2] = -nx;
+					mesh.tangents[index * 4 + 3] = -1.0f;
+				}
+			}
+		}
+		// Side is a single row of quads between the top and bottom rings
+		return GridIndices(indexOutput, baseVertex, 1, sides, flip, topology);
+	}
+	/// <summary>
+	/// Number of vertices written by CylinderCap
+	/// </summary>
+	inline std::uint64_t CylinderCapVertexCount(std::uint32_t sides, std::uint32_t rings)
+	{
+		return 1 + CheckedMultiply(rings, static_cast<std::uint64_t>(sides) + 1);
+	}
+	/// <summary>
+	/// Number of indices written by CylinderCap, caps are always triangle lists
+	/// </summary>
+	inline std::uint64_t CylinderCapIndexCount(std::uint32_t sides, std::uint32_t rings)
+	{
+		return (rings == 0) ? 0 : CheckedAdd(3 * static_cast<std::uint64_t>(sides), GridIndexCount(rings - 1, sides, Topology::TriangleList));
+	}
+	/// <summary>
+	/// Writes a flat cylinder cap made of concentric rings into a preallocated mesh, with analytic normals and tangents.
+	/// Texture UVs are the Polygon layout, squashed into the left 1.0f / (1.0f + pi) of the texture,
+	/// the top cap uses the top half and the bottom cap uses the bottom half.
+	/// Normals, texture UVs and tangents are only written if the mesh has them allocated
+	/// </summary>
+	/// <param name="mesh">Mesh with room for CylinderCapVertexCount vertices after baseVertex</param>
+	/// <param name="baseVertex">Index of the first vertex to write</param>
+	/// <param name="indexOutput">Output pointer with room for CylinderCapIndexCount indices, indices are skipped if it is null</param>
+	/// <param name="sides">Number of sides</param>
+	/// <param name="rings">Number of concentric rings, 1 gives a triangle fan</param>
+	/// <param name="radius">Radius of the cap</param>
+	/// <param name="y">Height of the cap</param>
+	/// <param name="top">Whether the cap faces +y, otherwise it faces -y</param>
+	/// <returns>Pointer to one past the last written index</returns>
+	template <typename IndexType>
+	inline IndexType* CylinderCap(BasicMesh<IndexType>& mesh, IndexType baseVertex, IndexType* indexOutput, std::uint32_t sides, std::uint32_t rings, float radius, float y, bool top)
+	{
+		const bool hasNormals = !mesh.normals.empty();
+		const bool hasTextureUVs = !mesh.textureUVs.empty();
+		const bool hasTangents = !mesh.tangents.empty();
+		const float normalY = top ? 1.0f : -1.0f;
+		// U follows +x and V follows +z on both caps, so only the bottom cap's frame is right handed
+		auto writeTangent = [&](std::size_t index) {
+			mesh.tangents[index * 4 + 0] = 1.0f;
+			mesh.tangents[index * 4 + 1] = 0.0f;
+			mesh.tangents[index * 4 + 2] = 0.0f;
+			mesh.tangents[index * 4 + 3] = -normalY;
+		};
+		const float textureVOffset = top ? 0.0f : 0.5f;
+		const float textureUScale = 1.0f / (1.0f + std::numbers::pi_v<float>);
+		// Center vertex
+		mesh.vertices[baseVertex * 3 + 0] = 0.0f;
+		mesh.vertices[baseVertex * 3 + 1] = y;
+		mesh.vertices[baseVertex * 3 + 2] = 0.0f;
+		mesh.bounds.Add(0.0f, y, 0.0f);
+		if (hasNormals)
+		{
+			mesh.normals[baseVertex * 3 + 0] = 0.0f;
+			mesh.normals[baseVertex * 3 + 1] = normalY;
+			mesh.normals[baseVertex * 3 + 2] = 0.0f;
+		}
+		if (hasTextureUVs)
+		{
+			mesh.textureUVs[baseVertex * 2 + 0] = 0.5f * textureUScale;
+			mesh.textureUVs[baseVertex * 2 + 1] = 0.25f + textureVOffset;
+		}
+		if (hasTangents)
+		{
+			writeTangent(baseVertex);
+		}
+		// Rings from the inside out
+		for (std::uint32_t i = 0; i < rings; i++)
+		{
+			const float ringRadius = static_cast<float>(i + 1) / static_cast<float>(rings);
+			for (std::uint32_t j = 0; j <= sides; j++)
+			{
+				const float angle = static_cast<float>(j) / static_cast<float>(sides) * 2.0f * std::numbers::pi_v<float>;
+				const float x = std::cosf(angle) * ringRadius;
+				const float z = -std::sinf(angle) * ringRadius;
+				const std::size_t index = baseVertex + 1 + i * (static_cast<std::size_t>(sides) + 1) + j;
+				mesh.vertices[index * 3 + 0] = x * radius;
+				mesh.vertices[index * 3 + 1] = y;
+				mesh.vertices[index * 3 + 2] = z * radius;
+				mesh.bounds.Add(x * radius, y, z * radius);
+				if (hasNormals)
+				{
+					mesh.normals[index * 3 + 0] = 0.0f;
+					mesh.normals[index * 3 + 1] = normalY;
+					mesh.normals[index * 3 + 2] = 0.0f;
+				}
+				if (hasTextureUVs)
 				{
-					mesh.indices[index * 3 + 0] = index;
-					mesh.indices[index * 3 + 1] = j + 1;
-					mesh.indices[index * 3 + 2] = sides + j + 1 + i;
+					mesh.textureUVs[index * 2 + 0] = (x * 0.5f + 0.5f) * textureUScale;
+					mesh.textureUVs[index * 2 + 1] = (z * 0.5f + 0.5f) * 0.5f + textureVOffset;
+				}
+				if (hasTangents)
+				{
+					writeTangent(index);
 				}
 			}
 		}
-		// Remap x coordinate
-		for (std::uint32_t i = 0, size = mesh.textureUVs.size(); i < size; i += 2)
+		if (rings == 0 || indexOutput == nullptr)
+		{
+			return indexOutput;
+		}
+		// Fan from the center to the first ring
+		for (std::uint32_t j = 0; j < sides; j++)
 		{
-			mesh.textureUVs[i] /= 1.0f + std::numbers::pi_v<float>;
+			const IndexType ring0 = static_cast<IndexType>(baseVertex + 1 + j);
+			*indexOutput++ = baseVertex;
+			*indexOutput++ = top ? ring0 : static_cast<IndexType>(ring0 + 1);
+			*indexOutput++ = top ? static_cast<IndexType>(ring0 + 1) : ring0;
 		}
-		return mesh;
+		// Quads between successive rings
+		return GridIndices(indexOutput, static_cast<IndexType>(baseVertex + 1), rings - 1, sides, top, Topology::TriangleList);
 	}
-}
\ No newline at end of file
+}
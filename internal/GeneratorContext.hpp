@@ -0,0 +1,152 @@
+#pragma once
+
+#include "Mesh.hpp"
+#include "Parallel.hpp"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace Construct
+{
+	/// <summary>
+	/// Buffers reused across generator calls, so repeated generation stops allocating once the buffers have grown.
+	/// Generators that take a context build their output mesh from recycled buffers and keep their temporaries in scratch buffers,
+	/// and split large meshes across worker threads the context keeps between calls.
+	/// Hand meshes back with Recycle once they are uploaded or copied, a mesh that is kept just takes its buffers with it.
+	/// Reordering vertices with GeneratorSetting::vertexOrder still allocates.
+	/// Not thread safe, use one context per thread
+	/// </summary>
+	class GeneratorContext
+	{
+	public:
+		inline GeneratorContext() = default;
+		GeneratorContext(const GeneratorContext&) = delete;
+		GeneratorContext& operator=(const GeneratorContext&) = delete;
+		inline GeneratorContext(GeneratorContext&&) noexcept = default;
+		inline GeneratorContext& operator=(GeneratorContext&&) noexcept = default;
+		/// <summary>
+		/// Creates a mesh like BasicMesh(vertexCount, indexCount, normalCount, textureUVs, tangentCount), taking its buffers from recycled meshes
+		/// </summary>
+		template <typename IndexType>
+		inline BasicMesh<IndexType> NewMesh(std::size_t vertexCount, std::size_t indexCount, std::size_t normalCount, std::size_t textureUVs, std::size_t tangentCount = 0)
+		{
+			BasicMesh<IndexType> mesh;
+			mesh.vertices = this->NewBuffer<float>(vertexCount);
+			mesh.indices = this->NewBuffer<IndexType>(indexCount);
+			mesh.normals = this->NewBuffer<float>(normalCount);
+			mesh.textureUVs = this->NewBuffer<float>(textureUVs);
+			mesh.tangents = this->NewBuffer<float>(tangentCount);
+			return mesh;
+		}
+		/// <summary>
+		/// Creates a buffer of count zeroes for one attribute of a mesh, taken from recycled buffers
+		/// </summary>
+		template <typename T>
+		inline std::vector<T> NewBuffer(std::size_t count)
+		{
+			return Take(std::get<Pool<T>>(this->buffers), count);
+		}
+		/// <summary>
+		/// Hands the buffers of a mesh back to the context for later meshes, the mesh is left empty
+		/// </summary>
+		template <typename IndexType>
+		inline void Recycle(BasicMesh<IndexType>&& mesh)
+		{
+			this->Recycle(std::move(mesh.vertices));
+			this->Recycle(std::move(mesh.indices));
+			this->Recycle(std::move(mesh.normals));
+			this->Recycle(std::move(mesh.textureUVs));
+			this->Recycle(std::move(mesh.tangents));
+			mesh.bounds = Bounds();
+		}
+		/// <summary>
+		/// Hands a buffer back to the context, the buffer is left empty
+		/// </summary>
+		template <typename T>
+		inline void Recycle(std::vector<T>&& buffer)
+		{
+			Give(std::get<Pool<T>>(this->buffers), buffer);
+		}
+		/// <summary>
+		/// Scratch buffer that keeps its capacity between calls, for float, 8, 16, 32 and 64-bit unsigned values.
+		/// Slots let one function hold several buffers of the same type at once, its contents are left from the last user
+		/// </summary>
+		template <typename T>
+		inline std::vector<T>& Scratch(std::uint32_t slot)
+		{
+			return std::get<std::array<std::vector<T>, ScratchSlots>>(this->scratch)[slot];
+		}
+		/// <summary>
+		/// Number of scratch slots per type
+		/// </summary>
+		static constexpr std::uint32_t ScratchSlots = 16;
+		/// <summary>
+		/// Worker threads for ParallelFor, created on first use and joined when the context is destroyed
+		/// </summary>
+		inline internal::WorkerPool& Workers()
+		{
+			if (!this->workers)
+			{
+				this->workers = std::make_unique<internal::WorkerPool>();
+			}
+			return *this->workers;
+		}
+	private:
+		template <typename T>
+		using Pool = std::vector<std::vector<T>>;
+		/// <summary>
+		/// Takes the smallest pooled buffer that fits, or grows the largest one, and resizes it to count zeroes
+		/// </summary>
+		template <typename T>
+		static inline std::vector<T> Take(Pool<T>& pool, std::size_t count)
+		{
+			std::vector<T> buffer;
+			if (count == 0 || pool.empty())
+			{
+				buffer.resize(count, T(0));
+				return buffer;
+			}
+			std::size_t best = 0;
+			for (std::size_t i = 1, size = pool.size(); i < size; i++)
+			{
+				const std::size_t capacity = pool[i].capacity(), bestCapacity = pool[best].capacity();
+				const bool fits = capacity >= count, bestFits = bestCapacity >= count;
+				if ((fits && (!bestFits || capacity < bestCapacity)) || (!fits && !bestFits && capacity > bestCapacity))
+				{
+					best = i;
+				}
+			}
+			buffer = std::move(pool[best]);
+			if (best + 1 != pool.size())
+			{
+				pool[best] = std::move(pool.back());
+			}
+			pool.pop_back();
+			buffer.assign(count, T(0));
+			return buffer;
+		}
+		template <typename T>
+		static inline void Give(Pool<T>& pool, std::vector<T>& buffer)
+		{
+			if (buffer.capacity() > 0)
+			{
+				buffer.clear();
+				pool.push_back(std::move(buffer));
+			}
+			buffer = std::vector<T>();
+		}
+		std::tuple<Pool<float>, Pool<std::uint16_t>, Pool<std::uint32_t>, Pool<std::uint64_t>> buffers;
+		std::tuple<
+			std::array<std::vector<float>, ScratchSlots>,
+			std::array<std::vector<std::uint8_t>, ScratchSlots>,
+			std::array<std::vector<std::uint16_t>, ScratchSlots>,
+			std::array<std::vector<std::uint32_t>, ScratchSlots>,
+			std::array<std::vector<std::uint64_t>, ScratchSlots>> scratch;
+		// Behind a pointer so the context stays movable
+		std::unique_ptr<internal::WorkerPool> workers;
+	};
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "types.hpp"
+#include "Mesh.hpp"
 
 namespace Construct
 {
@@ -10,6 +11,35 @@ namespace Construct
 	/// </summary>
 	enum class WindingOrder : std::uint8_t { CCW, CW };
 	/// <summary>
+	/// Bitmask for GeneratorSetting that selects which vertex attributes are generated.
+	/// Positions are always generated, normals and texture UVs by default.
+	/// Attributes that are not selected are left empty in the mesh.
+	/// Tangents are opt in and follow the texture layout of the generator, even if texture UVs aren't generated
+	/// </summary>
+	enum class VertexAttribute : std::uint8_t
+	{
+		None = 0,
+		Normal = 1 << 0,
+		TextureUV = 1 << 1,
+		Tangent = 1 << 2,
+		Default = Normal | TextureUV,
+	};
+	/// <summary>
+	/// Enum for GeneratorSetting that defines the order vertices are stored in, indices are remapped to match.
+	/// Generated keeps the generator's order, FirstUse follows the first reference from the index buffer with unreferenced vertices last,
+	/// Morton and Hilbert follow a space filling curve through the bounding cube so vertices close in space are close in memory.
+	/// Hilbert is slower to compute but never jumps across the cube
+	/// </summary>
+	enum class VertexOrder : std::uint8_t { Generated, FirstUse, Morton, Hilbert };
+	inline constexpr VertexAttribute operator|(VertexAttribute lhs, VertexAttribute rhs)
+	{
+		return static_cast<VertexAttribute>(static_cast<std::uint8_t>(lhs) | static_cast<std::uint8_t>(rhs));
+	}
+	inline constexpr VertexAttribute operator&(VertexAttribute lhs, VertexAttribute rhs)
+	{
+		return static_cast<VertexAttribute>(static_cast<std::uint8_t>(lhs) & static_cast<std::uint8_t>(rhs));
+	}
+	/// <summary>
 	/// Defines generator settings to generate specific data or data manipulations
 	/// </summary>
 	struct GeneratorSetting
@@ -19,6 +49,29 @@ namespace Construct
 		quat rotation;
 		WindingOrder windingOrder;
 		/// <summary>
+		/// Index topology of the generated mesh, TriangleList by default.
+		/// Only grid based generators (Plane, Quad, UVSphere, Capsule) output strips, others always output lists.
+		/// Strips are already wound according to windingOrder
+		/// </summary>
+		Topology topology = Topology::TriangleList;
+		/// <summary>
+		/// Vertex attributes to generate, normals and texture UVs by default.
+		/// Position only meshes (shadow casters, collision, skyboxes sampled by direction) can use VertexAttribute::None
+		/// </summary>
+		VertexAttribute attributes = VertexAttribute::Default;
+		/// <summary>
+		/// Order the generated vertices are stored in, VertexOrder::Generated by default.
+		/// Reordering runs after every other step, views and out of core generators always use the generated order
+		/// </summary>
+		VertexOrder vertexOrder = VertexOrder::Generated;
+		/// <summary>
+		/// Whether to write the index buffer, true by default.
+		/// Plane, Cylinder and triangle strip UVSpheres and Capsules leave the indices empty without it, for when they are already shared through a TopologyRegistry.
+		/// Other generators need their indices for normals or to drop the triangles at the poles and always write them.
+		/// VertexOrder::FirstUse has no order to follow without indices
+		/// </summary>
+		bool generateIndices = true;
+		/// <summary>
 		/// Define generator settings
 		/// </summary>
 		/// <param name="windingOrder">Defines what winding order the generated face will have, CCW by default</param>
@@ -31,5 +84,14 @@ namespace Construct
 			this->scale = sc;
 			this->rotation = qu;
 		}
+		/// <summary>
+		/// Checks whether a vertex attribute should be generated
+		/// </summary>
+		/// <param name="attribute">Attribute to check</param>
+		/// <returns>Whether the attribute is selected in attributes</returns>
+		inline bool HasAttribute(VertexAttribute attribute) const
+		{
+			return (this->attributes & attribute) == attribute;
+		}
 	};
 }
\ No newline at end of file
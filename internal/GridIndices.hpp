@@ -0,0 +1,101 @@
+#pragma once
+
+#include "Mesh.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace Construct::internal
+{
+	/// <summary>
+	/// Number of indices required for a grid of quads
+	/// </summary>
+	/// <param name="rows">Number of quad rows</param>
+	/// <param name="columns">Number of quads per row</param>
+	/// <param name="topology">Topology the grid is written in</param>
+	/// <returns>Index count</returns>
+	inline std::uint64_t GridIndexCount(std::uint32_t rows, std::uint32_t columns, Topology topology)
+	{
+		if (topology == Topology::TriangleStrip)
+		{
+			// 2 indices per column of vertices, a repeated index and a restart index, per row
+			return CheckedMultiply(rows, 2 * (static_cast<std::uint64_t>(columns) + 1) + 2);
+		}
+		return CheckedMultiply(6 * static_cast<std::uint64_t>(rows), columns);
+	}
+	/// <summary>
+	/// Writes the indices for a grid of quads where vertex (i, j) is located at baseVertex + i * (columns + 1) + j.
+	/// Unflipped quads are wound as (i, j), (i, j + 1), (i + 1, j) and (i, j + 1), (i + 1, j + 1), (i + 1, j).
+	/// Strips are emitted one per row, each followed by PrimitiveRestart, and split quads along the same diagonal as lists so every topology and winding gives the same surface.
+	/// The caller must have checked that every vertex of the grid fits in the index type
+	/// </summary>
+	/// <param name="out">Output pointer, must have room for GridIndexCount indices, nothing is written if it is null</param>
+	/// <param name="baseVertex">Index of vertex (0, 0)</param>
+	/// <param name="rows">Number of quad rows</param>
+	/// <param name="columns">Number of quads per row</param>
+	/// <param name="flip">Reverses the winding of every triangle</param>
+	/// <param name="topology">Topology to write the grid in</param>
+	/// <returns>Pointer to one past the last written index</returns>
+	template <typename IndexType>
+	inline IndexType* GridIndices(IndexType* out, IndexType baseVertex, std::uint32_t rows, std::uint32_t columns, bool flip, Topology topology)
+	{
+		// Quad corner maps, second one is the first with every triangle reversed
+		static constexpr std::array<std::uint32_t, 6> QuadIndexMap = {
+			0, 1, 2,
+			1, 3, 2,
+		};
+		static constexpr std::array<std::uint32_t, 6> FlippedQuadIndexMap = {
+			2, 1, 0,
+			2, 3, 1,
+		};
+		if (out == nullptr)
+		{
+			return out;
+		}
+		const IndexType stride = static_cast<IndexType>(columns + static_cast<std::uint64_t>(1));
+		if (topology == Topology::TriangleStrip)
+		{
+			// Zigzagging from row i to row i + 1 uses the list diagonal but gives flipped triangles.
+			// Unflipped strips repeat their first index so every real triangle is odd and swapped, flipped strips repeat their last to keep the count
+			for (std::uint32_t i = 0; i < rows; i++)
+			{
+				const IndexType rowStart = static_cast<IndexType>(baseVertex + static_cast<IndexType>(i) * stride);
+				if (!flip)
+				{
+					*out++ = rowStart;
+				}
+				for (IndexType j = 0; j < stride; j++)
+				{
+					*out++ = static_cast<IndexType>(rowStart + j);
+					*out++ = static_cast<IndexType>(rowStart + stride + j);
+				}
+				if (flip)
+				{
+					*out++ = static_cast<IndexType>(rowStart + 2 * stride - 1);
+				}
+				*out++ = PrimitiveRestart<IndexType>;
+			}
+			return out;
+		}
+		const std::array<std::uint32_t, 6>& indexMap = flip ? FlippedQuadIndexMap : QuadIndexMap;
+		for (std::uint32_t i = 0; i < rows; i++)
+		{
+			for (std::uint32_t j = 0; j < columns; j++)
+			{
+				// Calculate index of quad corners
+				const IndexType corner = static_cast<IndexType>(baseVertex + static_cast<IndexType>(i) * stride + static_cast<IndexType>(j));
+				const IndexType corners[4] = {
+					corner,
+					static_cast<IndexType>(corner + 1),
+					static_cast<IndexType>(corner + stride),
+					static_cast<IndexType>(corner + stride + 1),
+				};
+				for (std::uint32_t k = 0; k < 6; k++)
+				{
+					*out++ = corners[indexMap[k]];
+				}
+			}
+		}
+		return out;
+	}
+}
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "Mesh.hpp"
+#include "GeneratorContext.hpp"
 
+#include <algorithm>
 #include <vector>
 #include <cstdint>
 #include <cmath>
@@ -13,8 +15,10 @@ namespace Construct::internal
 	/// <summary>
 	/// Generate the mesh for a base case Icosphere
 	/// </summary>
+	/// <param name="context">Context the buffers of the mesh are taken from</param>
 	/// <returns>Icosphere subdivision 0 mesh</returns>
-	inline Mesh IcosphereBase()
+	template <typename IndexType>
+	inline BasicMesh<IndexType> IcosphereBase(GeneratorContext& context)
 	{
 		static constexpr std::array<std::uint32_t, 3 * 20> IcosphereBaseIndices = {
 			6, 5, 0,
@@ -67,9 +71,8 @@ namespace Construct::internal
 			30.0f, 1.0f,
 		};
 
-		Mesh mesh;
 		// 22 points, 5 * 2 for the poles (+10), 6 * 2 for the rings
-		mesh.vertices = std::vector<float>(22 * 3, 0.0f);
+		BasicMesh<IndexType> mesh = context.NewMesh<IndexType>(22 * 3, IcosphereBaseIndices.size(), 0, IcosphereBaseTextureUVs.size());
 
 		// Cache common calculations
 		const float va = std::atanf(0.5f);
@@ -102,9 +105,10 @@ namespace Construct::internal
 				mesh.vertices[(i + 17) * 3 + 1] = -0.5f;
 			}
 		}
+		mesh.bounds.Add(mesh.vertices);
 		// Add indices
-		mesh.indices = std::vector<std::uint32_t>(IcosphereBaseIndices.begin(), IcosphereBaseIndices.end());
-		mesh.textureUVs = std::vector<float>(IcosphereBaseTextureUVs.begin(), IcosphereBaseTextureUVs.end());
+		std::copy(IcosphereBaseIndices.begin(), IcosphereBaseIndices.end(), mesh.indices.begin());
+		std::copy(IcosphereBaseTextureUVs.begin(), IcosphereBaseTextureUVs.end(), mesh.textureUVs.begin());
 		// Remap U component by dividing by 30.0f
 		for (std::uint32_t i = 0, size = mesh.textureUVs.size(); i < size; i += 2)
 		{
@@ -112,4 +116,14 @@ namespace Construct::internal
 		}
 		return mesh;
 	}
+	/// <summary>
+	/// Generate the mesh for a base case Icosphere
+	/// </summary>
+	/// <returns>Icosphere subdivision 0 mesh</returns>
+	template <typename IndexType>
+	inline BasicMesh<IndexType> IcosphereBase()
+	{
+		GeneratorContext context;
+		return IcosphereBase<IndexType>(context);
+	}
 }
\ No newline at end of file
@@ -1,147 +1,284 @@
 #pragma once
 
 #include "./Mesh.hpp"
+#include "./GeneratorContext.hpp"
+#include "./SubdivisionEngine.hpp"
 
+#include <algorithm>
 #include <array>
-#include <unordered_map>
+#include <limits>
+#include <stdexcept>
 #include <vector>
 
 namespace Construct::internal
 {
-	struct FloatArrayHash
+	/// <summary>
+	/// Midpoint of two vertices pushed back onto the sphere.
+	/// The sum is commutative so the result doesn't depend on the order of the endpoints
+	/// </summary>
+	inline void SphereMidpoint(const float* vertex1, const float* vertex2, float* outputVertex)
+	{
+		float vx = vertex1[0] + vertex2[0];
+		float vy = vertex1[1] + vertex2[1];
+		float vz = vertex1[2] + vertex2[2];
+		float length = 0.5f / std::sqrtf(vx * vx + vy * vy + vz * vz);
+		outputVertex[0] = vx * length;
+		outputVertex[1] = vy * length;
+		outputVertex[2] = vz * length;
+	}
+	/// <summary>
+	/// Midpoint of two vertices pushed back onto the sphere, and the midpoint of their texture UVs.
+	/// Both sums are commutative so the result doesn't depend on the order of the endpoints
+	/// </summary>
+	inline void HalfVertex(const float* vertex1, const float* vertex2, const float* textureUV1, const float* textureUV2, float* outputVertex, float* outputTextureUV)
 	{
-		std::size_t operator()(const std::array<float, 5>& arr) const
+		SphereMidpoint(vertex1, vertex2, outputVertex);
+		// Texture UV midpoint calculation
+		{
+			float tx = (textureUV1[0] + textureUV2[0]) / 2.0f;
+			float ty = (textureUV1[1] + textureUV2[1]) / 2.0f;
+			outputTextureUV[0] = tx;
+			outputTextureUV[1] = ty;
+		}
+	}
+	inline void ComputeHalfVertex(float* vertexArray, float* textureUVArray, std::size_t v1Index, std::size_t v2Index, std::size_t outputIndex)
+	{
+		HalfVertex(&vertexArray[v1Index * 3], &vertexArray[v2Index * 3], &textureUVArray[v1Index * 2], &textureUVArray[v2Index * 2], &vertexArray[outputIndex * 3], &textureUVArray[outputIndex * 2]);
+	}
+	/// <summary>
+	/// Subdivide an Icosphere to generate higher quality meshes.
+	/// If the input mesh has no texture UVs, none are generated and vertices are shared across the UV seam.
+	/// Every level is a midpoint level of the subdivision engine with the midpoints pushed back onto the sphere,
+	/// so the vertices of each level follow the vertices of the previous one and the texture seam is split by the engine.
+	/// The caller must have checked that the subdivided vertex count fits in the index type
+	/// </summary>
+	/// <param name="context">Context the buffers of every level are taken from</param>
+	/// <param name="inputMesh">Mesh to subdivide, its buffers are recycled</param>
+	/// <param name="subdivisions">Number of subdivisions</param>
+	/// <param name="parents">If not null, receives the 2 vertices of the previous subdivision each vertex was split from, see SubdivisionEngine::RecordParents</param>
+	/// <returns>Subdivided mesh</returns>
+	template <typename IndexType>
+	inline BasicMesh<IndexType> IcosphereSubdivide(GeneratorContext& context, BasicMesh<IndexType>&& inputMesh, std::uint32_t subdivisions, std::vector<std::uint32_t>* parents = nullptr)
+	{
+		if (subdivisions == 0)
+		{
+			return std::move(inputMesh);
+		}
+		SubdivisionEngine<IndexType> engine(context, std::move(inputMesh));
+		for (std::uint32_t i = 0; i < subdivisions; i++)
 		{
-			std::size_t seed = 0;
-			for (float f : arr)
+			// Only the last level is a morph target, earlier levels don't need to record anything
+			if (parents != nullptr && i + 1 == subdivisions)
 			{
-				// Bitwise manipulation to mix the bits of the float representation and the seed
-				seed ^= std::hash<float>{}(f)+0x9e3779b9 + (seed << 6) + (seed >> 2);
+				engine.RecordParents(*parents);
 			}
-			return seed;
+			engine.Level(SphereMidpoint);
 		}
-	};
-	struct FloatArrayEqual
+		return engine.Finish();
+	}
+	/// <summary>
+	/// Subdivide an Icosphere to generate higher quality meshes, using a temporary context
+	/// </summary>
+	/// <param name="inputMesh">Mesh to subdivide</param>
+	/// <param name="subdivisions">Number of subdivisions</param>
+	/// <returns>Subdivided mesh</returns>
+	template <typename IndexType>
+	inline BasicMesh<IndexType> IcosphereSubdivide(const BasicMesh<IndexType>& inputMesh, std::uint32_t subdivisions)
+	{
+		GeneratorContext context;
+		return IcosphereSubdivide(context, BasicMesh<IndexType>(inputMesh), subdivisions);
+	}
+	/// <summary>
+	/// Generates the vertices of one subdivided Icosphere face row by row, bitwise identical to IcosphereSubdivide.
+	/// The face is a triangular lattice with side 2^subdivisions, point (i, j) for 0 &lt;= j &lt;= i,
+	/// corner (0, 0) is the first vertex of the face, (side, 0) the second and (side, side) the third.
+	/// Every point is the midpoint of an edge one level coarser, so each level only keeps 3 rows and memory grows with the side instead of the area
+	/// </summary>
+	class IcosphereFaceRows
 	{
-		bool operator()(const std::array<float, 5>& lhs, const std::array<float, 5>& rhs) const {
-			const float epsilon = 1e-5f; // Adjust this value depending on the required precision
-			for (size_t i = 0; i < 5; ++i)
+	public:
+		/// <summary>
+		/// One row of the lattice
+		/// </summary>
+		struct Row
+		{
+			std::uint32_t index = std::numeric_limits<std::uint32_t>::max();
+			/// <summary>
+			/// 3 tuple vertices of the row, i + 1 of them
+			/// </summary>
+			std::vector<float> vertices;
+			/// <summary>
+			/// 2 tuple texture UVs of the row
+			/// </summary>
+			std::vector<float> textureUVs;
+		};
+		/// <param name="corners">3 tuple vertices of the face corners</param>
+		/// <param name="textureUVs">2 tuple texture UVs of the face corners</param>
+		/// <param name="subdivisions">Number of subdivisions</param>
+		inline IcosphereFaceRows(const std::array<float, 9>& corners, const std::array<float, 6>& textureUVs, std::uint32_t subdivisions)
+			: corners(corners), textureUVs(textureUVs), subdivisions(subdivisions), levels(subdivisions + 1)
+		{
+			for (std::uint32_t level = 0; level <= subdivisions; level++)
 			{
-				if (std::abs(lhs[i] - rhs[i]) > epsilon)
+				const std::size_t width = (std::size_t(1) << level) + 1;
+				for (Row& row : this->levels[level])
 				{
-					return false;
+					row.vertices.resize(3 * width);
+					row.textureUVs.resize(2 * width);
 				}
 			}
-			return true;
 		}
-	};
-	inline void ComputeHalfVertex(float* vertexArray, float* textureUVArray, std::size_t v1Index, std::size_t v2Index, std::size_t outputIndex)
-	{
-		// Vertex Midpoint calculation
+		/// <summary>
+		/// Number of rows, 2^subdivisions + 1
+		/// </summary>
+		inline std::uint32_t RowCount() const
 		{
-			float vx = vertexArray[v1Index * 3 + 0] + vertexArray[v2Index * 3 + 0];
-			float vy = vertexArray[v1Index * 3 + 1] + vertexArray[v2Index * 3 + 1];
-			float vz = vertexArray[v1Index * 3 + 2] + vertexArray[v2Index * 3 + 2];
-			float length = 0.5f / std::sqrtf(vx * vx + vy * vy + vz * vz);
-			vertexArray[outputIndex * 3 + 0] = vx * length;
-			vertexArray[outputIndex * 3 + 1] = vy * length;
-			vertexArray[outputIndex * 3 + 2] = vz * length;
+			return (std::uint32_t(1) << this->subdivisions) + 1;
 		}
-		// Texture UV midpoint calculation
+		/// <summary>
+		/// Row i of the fully subdivided face, rows must be requested in increasing order.
+		/// The reference stays valid until the next call
+		/// </summary>
+		inline const Row& At(std::uint32_t i)
+		{
+			return this->RowAt(this->subdivisions, i);
+		}
+	private:
+		inline Row& RowAt(std::uint32_t level, std::uint32_t i)
+		{
+			// An odd row needs the rows on either side of it, so 3 slots are enough
+			Row& row = this->levels[level][i % 3];
+			if (row.index == i)
+			{
+				return row;
+			}
+			row.index = i;
+			if (level == 0)
+			{
+				// Row 0 is the first corner, row 1 is the second and third
+				for (std::uint32_t j = 0; j <= i; j++)
+				{
+					const std::uint32_t corner = i + j;
+					std::copy_n(&this->corners[corner * 3], 3, &row.vertices[j * 3]);
+					std::copy_n(&this->textureUVs[corner * 2], 2, &row.textureUVs[j * 2]);
+				}
+				return row;
+			}
+			if (i % 2 == 0)
+			{
+				// Even points are the coarser row, odd points split the edges along the row
+				const Row& coarse = this->RowAt(level - 1, i / 2);
+				for (std::uint32_t j = 0; j <= i; j += 2)
+				{
+					std::copy_n(&coarse.vertices[j / 2 * 3], 3, &row.vertices[j * 3]);
+					std::copy_n(&coarse.textureUVs[j / 2 * 2], 2, &row.textureUVs[j * 2]);
+				}
+				for (std::uint32_t j = 1; j < i; j += 2)
+				{
+					HalfVertex(&row.vertices[(j - 1) * 3], &row.vertices[(j + 1) * 3], &row.textureUVs[(j - 1) * 2], &row.textureUVs[(j + 1) * 2], &row.vertices[j * 3], &row.textureUVs[j * 2]);
+				}
+				return row;
+			}
+			// Odd rows split the edges between the even rows above and below, even points straight down and odd points diagonally
+			const Row& above = this->RowAt(level, i - 1);
+			const Row& below = this->RowAt(level, i + 1);
+			for (std::uint32_t j = 0; j <= i; j++)
+			{
+				const std::uint32_t first = (j % 2 == 0) ? j : j - 1;
+				const std::uint32_t second = (j % 2 == 0) ? j : j + 1;
+				HalfVertex(&above.vertices[first * 3], &below.vertices[second * 3], &above.textureUVs[first * 2], &below.textureUVs[second * 2], &row.vertices[j * 3], &row.textureUVs[j * 2]);
+			}
+			return row;
+		}
+		std::array<float, 9> corners;
+		std::array<float, 6> textureUVs;
+		std::uint32_t subdivisions;
+		std::vector<std::array<Row, 3>> levels;
+	};
+	/// <summary>
+	/// Number of edges along each side of a subdivided face, throws std::overflow_error past 31 subdivisions
+	/// </summary>
+	inline std::uint64_t IcosphereStreamSide(std::uint32_t subdivisions)
+	{
+		if (subdivisions > 31)
 		{
-			float tx = (textureUVArray[v1Index * 2 + 0] + textureUVArray[v2Index * 2 + 0]) / 2.0f;
-			float ty = (textureUVArray[v1Index * 2 + 1] + textureUVArray[v2Index * 2 + 1]) / 2.0f;
-			textureUVArray[outputIndex * 2 + 0] = tx;
-			textureUVArray[outputIndex * 2 + 1] = ty;
+			throw std::overflow_error("Construct: mesh size overflows 64 bits");
 		}
+		return std::uint64_t(1) << subdivisions;
 	}
 	/// <summary>
-	/// Subdivide an Icosphere to generate higher quality meshes
+	/// Number of vertices IcosphereSubdivideStream generates, vertices on the edges of the input faces are repeated for every face
 	/// </summary>
-	/// <param name="inputMesh"></param>
-	/// <param name="subdivisions"></param>
-	/// <returns></returns>
-	inline Mesh IcosphereSubdivide(const Mesh& inputMesh, std::uint32_t subdivisions)
+	inline std::uint64_t IcosphereStreamVertexCount(std::uint64_t faces, std::uint32_t subdivisions)
 	{
-		// takes a 2, 1, 0 triangle, subdivides it serpinski style and remaps the indices to this array
-		static constexpr std::array<std::uint32_t, 12> IcosphereSubdivisionRemapIndices = {
-			0, 1, 2,
-			1, 3, 4,
-			2, 4, 5,
-			2, 1, 4,
-		};
-
-		Mesh currentMesh = Mesh(inputMesh);
-		// Perform the specified number of subdivisions
-		for (std::uint32_t i = 0; i < subdivisions; i++)
+		const std::uint64_t side = IcosphereStreamSide(subdivisions);
+		return CheckedMultiply(faces, CheckedMultiply(side + 1, side + 2) / 2);
+	}
+	/// <summary>
+	/// Number of indices IcosphereSubdivideStream generates
+	/// </summary>
+	inline std::uint64_t IcosphereStreamIndexCount(std::uint64_t faces, std::uint32_t subdivisions)
+	{
+		const std::uint64_t side = IcosphereStreamSide(subdivisions);
+		return CheckedMultiply(3 * faces, CheckedMultiply(side, side));
+	}
+	/// <summary>
+	/// Subdivides an Icosphere like IcosphereSubdivide without holding the subdivided mesh, for meshes larger than memory.
+	/// Faces are emitted one after another as a lattice of IcosphereFaceRows, vertex (i, j) of face f has index f * (side + 1) * (side + 2) / 2 + i * (i + 1) / 2 + j.
+	/// Vertex positions and texture UVs are bitwise identical to IcosphereSubdivide, but vertices on the edges of input faces are not shared.
+	/// Triangles are wound like the input faces, the caller must have checked that IcosphereStreamVertexCount fits in the index type
+	/// </summary>
+	/// <param name="inputMesh">Triangle list to subdivide, must have texture UVs</param>
+	/// <param name="subdivisions">Number of subdivisions</param>
+	/// <param name="vertex">Called with (face, vertex, textureUV) for every vertex in index order</param>
+	/// <param name="indices">Called with (const IndexType*, count) after each row of vertices with the triangles above it</param>
+	template <typename IndexType, typename VertexCallback, typename IndexCallback>
+	inline void IcosphereSubdivideStream(const BasicMesh<IndexType>& inputMesh, std::uint32_t subdivisions, VertexCallback&& vertex, IndexCallback&& indices)
+	{
+		const std::uint64_t side = IcosphereStreamSide(subdivisions);
+		const std::uint64_t faceVertices = IcosphereStreamVertexCount(1, subdivisions);
+		std::vector<IndexType> rowIndices(3 * (2 * side - 1));
+		for (std::size_t f = 0, size = inputMesh.indices.size() / 3; f < size; f++)
 		{
-			// Point map so we don't duplicate vertices
-			// Maps a vertex and texture coordinate to an index
-			std::unordered_map<std::array<float, 5>, std::uint32_t, FloatArrayHash, FloatArrayEqual> vertexMap;
-			std::uint32_t nextFreeIndex = 0;
-			Mesh outputMesh;
-			for (std::uint32_t j = 0, size = currentMesh.indices.size() / 3; j < size; j++)
+			std::array<float, 9> corners;
+			std::array<float, 6> textureUVs;
+			for (std::size_t c = 0; c < 3; c++)
 			{
-				const std::uint32_t index1 = currentMesh.indices[j * 3 + 0];
-				const std::uint32_t index2 = currentMesh.indices[j * 3 + 1];
-				const std::uint32_t index3 = currentMesh.indices[j * 3 + 2];
-
-				float vertices[6 * 3] = {
-					currentMesh.vertices[index1 * 3 + 0], currentMesh.vertices[index1 * 3 + 1], currentMesh.vertices[index1 * 3 + 2],
-					0.0f, 0.0f, 0.0f,
-					0.0f, 0.0f, 0.0f,
-					currentMesh.vertices[index2 * 3 + 0], currentMesh.vertices[index2 * 3 + 1], currentMesh.vertices[index2 * 3 + 2],
-					0.0f, 0.0f, 0.0f,
-					currentMesh.vertices[index3 * 3 + 0], currentMesh.vertices[index3 * 3 + 1], currentMesh.vertices[index3 * 3 + 2],
-				};
-				float textureUVs[6 * 2] = {
-					currentMesh.textureUVs[index1 * 2 + 0], currentMesh.textureUVs[index1 * 2 + 1],
-					0.0f, 0.0f,
-					0.0f, 0.0f,
-					currentMesh.textureUVs[index2 * 2 + 0], currentMesh.textureUVs[index2 * 2 + 1],
-					0.0f, 0.0f,
-					currentMesh.textureUVs[index3 * 2 + 0], currentMesh.textureUVs[index3 * 2 + 1],
-				};
-				// Compute half vertices and remap to surface
-				ComputeHalfVertex(vertices, textureUVs, 0, 3, 1);
-				ComputeHalfVertex(vertices, textureUVs, 0, 5, 2);
-				ComputeHalfVertex(vertices, textureUVs, 3, 5, 4);
-				for (std::uint32_t k = 0, size2 = IcosphereSubdivisionRemapIndices.size(); k < size2; k++)
+				const std::size_t index = inputMesh.indices[f * 3 + c];
+				std::copy_n(&inputMesh.vertices[index * 3], 3, &corners[c * 3]);
+				std::copy_n(&inputMesh.textureUVs[index * 2], 2, &textureUVs[c * 2]);
+			}
+			IcosphereFaceRows rows(corners, textureUVs, subdivisions);
+			const std::uint64_t faceBase = f * faceVertices;
+			for (std::uint32_t i = 0, rowCount = rows.RowCount(); i < rowCount; i++)
+			{
+				const IcosphereFaceRows::Row& row = rows.At(i);
+				for (std::uint32_t j = 0; j <= i; j++)
 				{
-					const std::uint32_t index = IcosphereSubdivisionRemapIndices[k];
-					const std::array<float, 5> key = {
-						vertices[index * 3 + 0],
-						vertices[index * 3 + 1],
-						vertices[index * 3 + 2],
-						textureUVs[index * 2 + 0],
-						textureUVs[index * 2 + 1]
-					};
-					// Vertex Already exists, don't add
-					if (vertexMap.find(key) != vertexMap.end())
-					{
-						outputMesh.indices.push_back(vertexMap[key]);
-					}
-					// Vertex doesn't exist, add
-					else
+					vertex(f, &row.vertices[j * 3], &row.textureUVs[j * 2]);
+				}
+				if (i == 0)
+				{
+					continue;
+				}
+				// Triangles between row i - 1 and row i, upright ones point at the first corner like the input face
+				const std::uint64_t above = faceBase + static_cast<std::uint64_t>(i - 1) * i / 2;
+				const std::uint64_t current = faceBase + static_cast<std::uint64_t>(i) * (i + 1) / 2;
+				IndexType* out = rowIndices.data();
+				for (std::uint32_t j = 0; j < i; j++)
+				{
+					*out++ = static_cast<IndexType>(above + j);
+					*out++ = static_cast<IndexType>(current + j);
+					*out++ = static_cast<IndexType>(current + j + 1);
+					if (j + 1 < i)
 					{
-						// Add index to map
-						vertexMap[key] = nextFreeIndex;
-						// Index
-						outputMesh.indices.push_back(nextFreeIndex);
-						// Vertex
-						outputMesh.vertices.push_back(key[0]);
-						outputMesh.vertices.push_back(key[1]);
-						outputMesh.vertices.push_back(key[2]);
-						// Texture UVs
-						outputMesh.textureUVs.push_back(key[3]);
-						outputMesh.textureUVs.push_back(key[4]);
-						// Increment for next free index
-						nextFreeIndex++;
+						*out++ = static_cast<IndexType>(above + j + 1);
+						*out++ = static_cast<IndexType>(above + j);
+						*out++ = static_cast<IndexType>(current + j + 1);
 					}
 				}
+				indices(static_cast<const IndexType*>(rowIndices.data()), static_cast<std::size_t>(out - rowIndices.data()));
 			}
-			currentMesh = Mesh(outputMesh);
 		}
-		return currentMesh;
 	}
-}
\ No newline at end of file
+}
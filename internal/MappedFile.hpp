@@ -0,0 +1,259 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace Construct::internal
+{
+	/// <summary>
+	/// A file of fixed size that is written through memory mapped windows.
+	/// Only the windows that are currently mapped are resident in the process
+	/// </summary>
+	class MappedFile
+	{
+	public:
+		/// <summary>
+		/// Creates or truncates a file and grows it to a size, throws std::system_error on failure
+		/// </summary>
+		/// <param name="path">Path of the file</param>
+		/// <param name="size">Size of the file in bytes</param>
+		inline MappedFile(const std::filesystem::path& path, std::uint64_t size) : size(size)
+		{
+#ifdef _WIN32
+			this->file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			if (this->file == INVALID_HANDLE_VALUE)
+			{
+				throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), "Construct: failed to create mesh file");
+			}
+			LARGE_INTEGER fileSize;
+			fileSize.QuadPart = static_cast<LONGLONG>(size);
+			if (!SetFilePointerEx(this->file, fileSize, nullptr, FILE_BEGIN) || !SetEndOfFile(this->file))
+			{
+				const DWORD error = GetLastError();
+				CloseHandle(this->file);
+				throw std::system_error(static_cast<int>(error), std::system_category(), "Construct: failed to size mesh file");
+			}
+			this->mapping = CreateFileMappingW(this->file, nullptr, PAGE_READWRITE, static_cast<DWORD>(size >> 32), static_cast<DWORD>(size & 0xFFFFFFFFull), nullptr);
+			if (this->mapping == nullptr)
+			{
+				const DWORD error = GetLastError();
+				CloseHandle(this->file);
+				throw std::system_error(static_cast<int>(error), std::system_category(), "Construct: failed to map mesh file");
+			}
+#else
+			this->file = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+			if (this->file < 0)
+			{
+				throw std::system_error(errno, std::generic_category(), "Construct: failed to create mesh file");
+			}
+			if (ftruncate(this->file, static_cast<off_t>(size)) != 0)
+			{
+				const int error = errno;
+				close(this->file);
+				throw std::system_error(error, std::generic_category(), "Construct: failed to size mesh file");
+			}
+#endif
+		}
+		inline ~MappedFile()
+		{
+#ifdef _WIN32
+			CloseHandle(this->mapping);
+			CloseHandle(this->file);
+#else
+			close(this->file);
+#endif
+		}
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		/// <summary>
+		/// Alignment of mapped window offsets, the page size or the allocation granularity on Windows
+		/// </summary>
+		static inline std::uint64_t Granularity()
+		{
+#ifdef _WIN32
+			SYSTEM_INFO info;
+			GetSystemInfo(&info);
+			return info.dwAllocationGranularity;
+#else
+			return static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+#endif
+		}
+		/// <summary>
+		/// Maps a window of the file for writing, offset must be a multiple of Granularity
+		/// </summary>
+		inline unsigned char* Map(std::uint64_t offset, std::size_t length)
+		{
+#ifdef _WIN32
+			void* view = MapViewOfFile(this->mapping, FILE_MAP_WRITE, static_cast<DWORD>(offset >> 32), static_cast<DWORD>(offset & 0xFFFFFFFFull), length);
+			if (view == nullptr)
+			{
+				throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), "Construct: failed to map mesh file window");
+			}
+#else
+			void* view = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, this->file, static_cast<off_t>(offset));
+			if (view == MAP_FAILED)
+			{
+				throw std::system_error(errno, std::generic_category(), "Construct: failed to map mesh file window");
+			}
+			// Windows are written front to back once
+			madvise(view, length, MADV_SEQUENTIAL);
+#endif
+			return static_cast<unsigned char*>(view);
+		}
+		/// <summary>
+		/// Starts writing a window back to the file and unmaps it, releasing its memory
+		/// </summary>
+		inline static void Unmap(unsigned char* view, std::size_t length)
+		{
+#ifdef _WIN32
+			FlushViewOfFile(view, length);
+			UnmapViewOfFile(view);
+#else
+			msync(view, length, MS_ASYNC);
+			munmap(view, length);
+#endif
+		}
+		/// <summary>
+		/// Size of the file in bytes
+		/// </summary>
+		inline std::uint64_t Size() const
+		{
+			return this->size;
+		}
+	private:
+		std::uint64_t size;
+#ifdef _WIN32
+		HANDLE file;
+		HANDLE mapping;
+#else
+		int file;
+#endif
+	};
+	/// <summary>
+	/// Writes a region of a MappedFile front to back, mapping one window of at most windowBytes at a time
+	/// </summary>
+	class MappedStream
+	{
+	public:
+		inline MappedStream() = default;
+		/// <summary>
+		/// Define a stream over [offset, offset + length) of a file
+		/// </summary>
+		/// <param name="file">File to write, must outlive the stream</param>
+		/// <param name="offset">First byte of the region</param>
+		/// <param name="length">Length of the region in bytes</param>
+		/// <param name="windowBytes">Largest window to map at once, rounded to the mapping granularity</param>
+		inline MappedStream(MappedFile& file, std::uint64_t offset, std::uint64_t length, std::size_t windowBytes)
+			: file(&file), position(offset), end(offset + length)
+		{
+			const std::uint64_t granularity = MappedFile::Granularity();
+			this->windowBytes = std::max<std::uint64_t>(granularity, windowBytes / granularity * granularity);
+		}
+		inline ~MappedStream()
+		{
+			this->Close();
+		}
+		MappedStream(const MappedStream&) = delete;
+		MappedStream& operator=(const MappedStream&) = delete;
+		inline MappedStream(MappedStream&& other) noexcept
+		{
+			*this = std::move(other);
+		}
+		inline MappedStream& operator=(MappedStream&& other) noexcept
+		{
+			if (this != &other)
+			{
+				this->Close();
+				this->file = other.file;
+				this->position = other.position;
+				this->end = other.end;
+				this->windowBytes = other.windowBytes;
+				this->window = other.window;
+				this->windowStart = other.windowStart;
+				this->windowLength = other.windowLength;
+				other.window = nullptr;
+				other.file = nullptr;
+			}
+			return *this;
+		}
+		/// <summary>
+		/// Appends bytes to the region, throws std::out_of_range if the region is full
+		/// </summary>
+		inline void Write(const void* data, std::size_t bytes)
+		{
+			if (bytes > this->end - this->position)
+			{
+				throw std::out_of_range("Construct: mesh file section overflow");
+			}
+			const unsigned char* source = static_cast<const unsigned char*>(data);
+			while (bytes > 0)
+			{
+				if (this->window == nullptr || this->position >= this->windowStart + this->windowLength)
+				{
+					this->Advance();
+				}
+				const std::size_t available = static_cast<std::size_t>(this->windowStart + this->windowLength - this->position);
+				const std::size_t count = std::min(bytes, available);
+				std::memcpy(this->window + (this->position - this->windowStart), source, count);
+				this->position += count;
+				source += count;
+				bytes -= count;
+			}
+		}
+		/// <summary>
+		/// Appends one value to the region
+		/// </summary>
+		template <typename T>
+		inline void Write(const T& value)
+		{
+			this->Write(&value, sizeof(T));
+		}
+		/// <summary>
+		/// Unmaps the current window
+		/// </summary>
+		inline void Close()
+		{
+			if (this->window != nullptr)
+			{
+				MappedFile::Unmap(this->window, this->windowLength);
+				this->window = nullptr;
+			}
+		}
+	private:
+		/// <summary>
+		/// Unmaps the current window and maps the one containing the write position
+		/// </summary>
+		inline void Advance()
+		{
+			this->Close();
+			const std::uint64_t granularity = MappedFile::Granularity();
+			this->windowStart = this->position / granularity * granularity;
+			this->windowLength = static_cast<std::size_t>(std::min<std::uint64_t>(this->windowBytes, this->file->Size() - this->windowStart));
+			this->window = this->file->Map(this->windowStart, this->windowLength);
+		}
+		MappedFile* file = nullptr;
+		std::uint64_t position = 0;
+		std::uint64_t end = 0;
+		std::uint64_t windowBytes = 0;
+		unsigned char* window = nullptr;
+		std::uint64_t windowStart = 0;
+		std::size_t windowLength = 0;
+	};
+}
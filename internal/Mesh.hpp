@@ -1,24 +1,55 @@
 #pragma once
 
+#include "Bounds.hpp"
+
 #include <vector>
 #include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <variant>
 
 namespace Construct
 {
 	/// <summary>
-	/// Define a mesh of data that is usually compatible with most renderer
+	/// Defines how the indices of a mesh are assembled into triangles.
+	/// TriangleList by default.
+	/// </summary>
+	enum class Topology : std::uint8_t { TriangleList, TriangleStrip };
+	/// <summary>
+	/// Index value that ends the current strip when using Topology::TriangleStrip, the largest value of the index type.
+	/// Requires primitive restart to be enabled in the renderer
 	/// </summary>
-	struct Mesh
+	template <typename IndexType>
+	inline constexpr IndexType PrimitiveRestart = std::numeric_limits<IndexType>::max();
+	/// <summary>
+	/// Primitive restart index of 32-bit meshes
+	/// </summary>
+	inline constexpr std::uint32_t PrimitiveRestartIndex = PrimitiveRestart<std::uint32_t>;
+	/// <summary>
+	/// Largest number of vertices a mesh with the given index type can address.
+	/// The largest index value is reserved for primitive restart
+	/// </summary>
+	template <typename IndexType>
+	inline constexpr std::uint64_t MaxVertexCount = PrimitiveRestart<IndexType>;
+	/// <summary>
+	/// Define a mesh of data that is usually compatible with most renderer.
+	/// Generic over the index type, use the Mesh, Mesh16 and Mesh64 aliases
+	/// </summary>
+	template <typename IndexType>
+	struct BasicMesh
 	{
+		static_assert(std::is_unsigned_v<IndexType>, "Mesh index type must be an unsigned integer");
 		/// <summary>
 		/// float list of 3 tuple vertices (X, Y, Z)
 		/// </summary>
 		std::vector<float> vertices;
 		/// <summary>
-		/// 32-bit int list of 3 tuple points of a triangle (p1, p2, p3).
+		/// int list of 3 tuple points of a triangle (p1, p2, p3).
 		/// With a default winding order of counter-clockwise.
+		/// If topology is TriangleStrip, each strip is terminated by PrimitiveRestart instead
 		/// </summary>
-		std::vector<std::uint32_t> indices;
+		std::vector<IndexType> indices;
 		/// <summary>
 		/// float list of 3 tuple normals (NX, NY, NZ)
 		/// Normalised to lengths of 1.0f or 0.0f if normal is a zero-vector
@@ -29,27 +60,126 @@ namespace Construct
 		/// With 0.0f, 0.0f denoting bottom-left corner
 		/// </summary>
 		std::vector<float> textureUVs;
+		/// <summary>
+		/// float list of 4 tuple tangents (TX, TY, TZ, W)
+		/// Tangents point along increasing U, W is the handedness (1.0f or -1.0f) such that
+		/// the bitangent along increasing V is W * cross(normal, tangent)
+		/// </summary>
+		std::vector<float> tangents;
+		/// <summary>
+		/// How the indices are assembled into triangles
+		/// </summary>
+		Topology topology = Topology::TriangleList;
+		/// <summary>
+		/// Bounding box and sphere of the vertices, filled in by the generators and Merge
+		/// </summary>
+		Bounds bounds;
 		// Default constructor
-		inline Mesh() = default;
+		inline BasicMesh() = default;
 		/// <summary>
 		/// Initialise arrays with lengths and initialise to 0
 		/// </summary>
-		inline Mesh(std::uint32_t vertexCount, std::uint32_t indexCount, std::uint32_t normalCount, std::uint32_t textureUVs)
+		inline BasicMesh(std::size_t vertexCount, std::size_t indexCount, std::size_t normalCount, std::size_t textureUVs, std::size_t tangentCount = 0)
 		{
 			this->vertices.resize(vertexCount, 0.0f);
 			this->indices.resize(indexCount, 0);
 			this->normals.resize(normalCount, 0.0f);
 			this->textureUVs.resize(textureUVs, 0.0f);
+			this->tangents.resize(tangentCount, 0.0f);
 		}
 		/// <summary>
 		/// Initialise with another mesh
 		/// </summary>
-		inline Mesh(const Mesh& other)
+		inline BasicMesh(const BasicMesh& other)
 		{
 			this->vertices = std::vector<float>(other.vertices);
-			this->indices = std::vector<std::uint32_t>(other.indices);
+			this->indices = std::vector<IndexType>(other.indices);
 			this->normals = std::vector<float>(other.normals);
 			this->textureUVs = std::vector<float>(other.textureUVs);
+			this->tangents = std::vector<float>(other.tangents);
+			this->topology = other.topology;
+			this->bounds = other.bounds;
 		}
+		inline BasicMesh(BasicMesh&& other) noexcept = default;
+		inline BasicMesh& operator=(const BasicMesh& other) = default;
+		inline BasicMesh& operator=(BasicMesh&& other) noexcept = default;
 	};
+	/// <summary>
+	/// Mesh with 16-bit indices, for meshes with at most 65535 vertices
+	/// </summary>
+	using Mesh16 = BasicMesh<std::uint16_t>;
+	/// <summary>
+	/// Mesh with 32-bit indices, the default
+	/// </summary>
+	using Mesh = BasicMesh<std::uint32_t>;
+	/// <summary>
+	/// Mesh with 64-bit indices, for meshes too large to address with 32-bit indices
+	/// </summary>
+	using Mesh64 = BasicMesh<std::uint64_t>;
+	/// <summary>
+	/// Mesh of whichever index type was selected by GenerateWithSmallestIndex
+	/// </summary>
+	using AnyMesh = std::variant<Mesh16, Mesh, Mesh64>;
+	namespace internal
+	{
+		/// <summary>
+		/// Multiplies mesh sizes, throwing std::overflow_error instead of wrapping around
+		/// </summary>
+		inline std::uint64_t CheckedMultiply(std::uint64_t lhs, std::uint64_t rhs)
+		{
+			if (rhs != 0 && lhs > std::numeric_limits<std::uint64_t>::max() / rhs)
+			{
+				throw std::overflow_error("Construct: mesh size overflows 64 bits");
+			}
+			return lhs * rhs;
+		}
+		/// <summary>
+		/// Adds mesh sizes, throwing std::overflow_error instead of wrapping around
+		/// </summary>
+		inline std::uint64_t CheckedAdd(std::uint64_t lhs, std::uint64_t rhs)
+		{
+			if (lhs > std::numeric_limits<std::uint64_t>::max() - rhs)
+			{
+				throw std::overflow_error("Construct: mesh size overflows 64 bits");
+			}
+			return lhs + rhs;
+		}
+		/// <summary>
+		/// Rounds a count up to a multiple of an alignment
+		/// </summary>
+		inline std::uint64_t AlignUp(std::uint64_t count, std::uint64_t alignment)
+		{
+			return CheckedMultiply((CheckedAdd(count, alignment - 1)) / alignment, alignment);
+		}
+		/// <summary>
+		/// Checks that a vertex count can be addressed by the index type and allocated, throws std::overflow_error otherwise
+		/// </summary>
+		/// <returns>The vertex count</returns>
+		template <typename IndexType>
+		inline std::size_t CheckedVertexCount(std::uint64_t vertexCount)
+		{
+			if (vertexCount > MaxVertexCount<IndexType>)
+			{
+				throw std::overflow_error("Construct: vertex count exceeds the range of the mesh index type");
+			}
+			if (vertexCount > std::numeric_limits<std::size_t>::max() / (3 * sizeof(float)))
+			{
+				throw std::overflow_error("Construct: vertex count exceeds the addressable memory");
+			}
+			return static_cast<std::size_t>(vertexCount);
+		}
+		/// <summary>
+		/// Checks that an index count can be allocated, throws std::overflow_error otherwise
+		/// </summary>
+		/// <returns>The index count</returns>
+		template <typename IndexType>
+		inline std::size_t CheckedIndexCount(std::uint64_t indexCount)
+		{
+			if (indexCount > std::numeric_limits<std::size_t>::max() / sizeof(IndexType))
+			{
+				throw std::overflow_error("Construct: index count exceeds the addressable memory");
+			}
+			return static_cast<std::size_t>(indexCount);
+		}
+	}
 }
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "GeneratorSetting.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace Construct
+{
+	/// <summary>
+	/// Header at the start of a mesh file written by the out of core generators.
+	/// Every section is a tightly packed array in the layout of the matching Mesh buffer, starting on a 4096 byte boundary.
+	/// Sections of attributes that weren't generated have an offset and size of 0
+	/// </summary>
+	struct MeshFileHeader
+	{
+		/// <summary>
+		/// Always "CNSTMESH"
+		/// </summary>
+		std::array<char, 8> magic = { 'C', 'N', 'S', 'T', 'M', 'E', 'S', 'H' };
+		std::uint32_t version = 1;
+		/// <summary>
+		/// Size of each index in bytes, 2, 4 or 8
+		/// </summary>
+		std::uint32_t indexSize = 0;
+		Topology topology = Topology::TriangleList;
+		VertexAttribute attributes = VertexAttribute::None;
+		/// <summary>
+		/// Always 0, spells out the padding so no uninitialised bytes are written to the file
+		/// </summary>
+		std::array<std::uint8_t, 6> reserved = {};
+		std::uint64_t vertexCount = 0;
+		std::uint64_t indexCount = 0;
+		std::uint64_t verticesOffset = 0;
+		std::uint64_t normalsOffset = 0;
+		std::uint64_t textureUVsOffset = 0;
+		std::uint64_t tangentsOffset = 0;
+		std::uint64_t indicesOffset = 0;
+		/// <summary>
+		/// Bounds of the vertices, like Mesh::bounds
+		/// </summary>
+		std::array<float, 3> boundsMin = {};
+		std::array<float, 3> boundsMax = {};
+		std::array<float, 3> boundsCenter = {};
+		float boundsRadius = -1.0f;
+	};
+	static_assert(sizeof(MeshFileHeader) == 120, "MeshFileHeader must not have implicit padding");
+	/// <summary>
+	/// Default number of bytes each section keeps mapped while an out of core generator writes it
+	/// </summary>
+	inline constexpr std::size_t DefaultMeshFileWindow = 16 * 1024 * 1024;
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "Bounds.hpp"
+#include "MappedFile.hpp"
+#include "Mesh.hpp"
+#include "MeshFile.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+
+namespace Construct::internal
+{
+	/// <summary>
+	/// Writes a mesh into a file section by section, with at most one window per section mapped at a time.
+	/// Resident memory is bounded by 5 windows no matter how large the mesh is
+	/// </summary>
+	template <typename IndexType>
+	class MeshFileSink
+	{
+	public:
+		/// <summary>
+		/// Creates the file and lays out its sections, throws std::system_error if the file can't be created
+		/// </summary>
+		/// <param name="path">Path of the file</param>
+		/// <param name="vertexCount">Exact number of vertices that will be written</param>
+		/// <param name="indexCount">Exact number of indices that will be written</param>
+		/// <param name="topology">How the indices are assembled</param>
+		/// <param name="attributes">Attributes that will be written</param>
+		/// <param name="windowBytes">Bytes each section keeps mapped</param>
+		inline MeshFileSink(const std::filesystem::path& path, std::uint64_t vertexCount, std::uint64_t indexCount, Topology topology, VertexAttribute attributes, std::size_t windowBytes)
+		{
+			this->header.indexSize = sizeof(IndexType);
+			this->header.topology = topology;
+			this->header.attributes = attributes;
+			this->header.vertexCount = vertexCount;
+			this->header.indexCount = indexCount;
+			auto hasAttribute = [&](VertexAttribute attribute) { return (attributes & attribute) == attribute; };
+			// Lay out sections one after another on page boundaries
+			std::uint64_t offset = 0;
+			auto section = [&](std::uint64_t bytes) {
+				offset = AlignUp(offset, SectionAlignment);
+				const std::uint64_t start = (bytes == 0) ? 0 : offset;
+				offset = CheckedAdd(offset, bytes);
+				return start;
+			};
+			section(sizeof(MeshFileHeader));
+			this->header.verticesOffset = section(CheckedMultiply(vertexCount, 3 * sizeof(float)));
+			this->header.normalsOffset = section(hasAttribute(VertexAttribute::Normal) ? CheckedMultiply(vertexCount, 3 * sizeof(float)) : 0);
+			this->header.textureUVsOffset = section(hasAttribute(VertexAttribute::TextureUV) ? CheckedMultiply(vertexCount, 2 * sizeof(float)) : 0);
+			this->header.tangentsOffset = section(hasAttribute(VertexAttribute::Tangent) ? CheckedMultiply(vertexCount, 4 * sizeof(float)) : 0);
+			this->header.indicesOffset = section(CheckedMultiply(indexCount, sizeof(IndexType)));
+			this->file = std::make_unique<MappedFile>(path, offset);
+			this->vertices = MappedStream(*this->file, this->header.verticesOffset, vertexCount * 3 * sizeof(float), windowBytes);
+			if (this->header.normalsOffset != 0)
+			{
+				this->normals = MappedStream(*this->file, this->header.normalsOffset, vertexCount * 3 * sizeof(float), windowBytes);
+			}
+			if (this->header.textureUVsOffset != 0)
+			{
+				this->textureUVs = MappedStream(*this->file, this->header.textureUVsOffset, vertexCount * 2 * sizeof(float), windowBytes);
+			}
+			if (this->header.tangentsOffset != 0)
+			{
+				this->tangents = MappedStream(*this->file, this->header.tangentsOffset, vertexCount * 4 * sizeof(float), windowBytes);
+			}
+			this->indices = MappedStream(*this->file, this->header.indicesOffset, indexCount * sizeof(IndexType), windowBytes);
+		}
+		/// <summary>
+		/// Appends a vertex, attributes that weren't selected are ignored
+		/// </summary>
+		inline void Vertex(const float* position, const float* normal, const float* textureUV, const float* tangent)
+		{
+			this->vertices.Write(position, 3 * sizeof(float));
+			this->bounds.Add(position[0], position[1], position[2]);
+			if (this->header.normalsOffset != 0)
+			{
+				this->normals.Write(normal, 3 * sizeof(float));
+			}
+			if (this->header.textureUVsOffset != 0)
+			{
+				this->textureUVs.Write(textureUV, 2 * sizeof(float));
+			}
+			if (this->header.tangentsOffset != 0)
+			{
+				this->tangents.Write(tangent, 4 * sizeof(float));
+			}
+		}
+		/// <summary>
+		/// Appends a run of indices
+		/// </summary>
+		inline void Indices(const IndexType* data, std::size_t count)
+		{
+			this->indices.Write(data, count * sizeof(IndexType));
+		}
+		/// <summary>
+		/// Writes the header and unmaps every section
+		/// </summary>
+		/// <returns>Header of the written file</returns>
+		inline MeshFileHeader Finish()
+		{
+			this->vertices.Close();
+			this->normals.Close();
+			this->textureUVs.Close();
+			this->tangents.Close();
+			this->indices.Close();
+			this->header.boundsMin = { this->bounds.min.x, this->bounds.min.y, this->bounds.min.z };
+			this->header.boundsMax = { this->bounds.max.x, this->bounds.max.y, this->bounds.max.z };
+			this->header.boundsCenter = { this->bounds.center.x, this->bounds.center.y, this->bounds.center.z };
+			this->header.boundsRadius = this->bounds.radius;
+			MappedStream headerStream(*this->file, 0, sizeof(MeshFileHeader), sizeof(MeshFileHeader));
+			headerStream.Write(this->header);
+			return this->header;
+		}
+		/// <summary>
+		/// Bounds are tracked as vertices are written, the sphere is centered on center
+		/// </summary>
+		Bounds bounds;
+	private:
+		static constexpr std::uint64_t SectionAlignment = 4096;
+		MeshFileHeader header;
+		std::unique_ptr<MappedFile> file;
+		MappedStream vertices;
+		MappedStream normals;
+		MappedStream textureUVs;
+		MappedStream tangents;
+		MappedStream indices;
+	};
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "GeneratorContext.hpp"
+#include "Mesh.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace Construct
+{
+	/// <summary>
+	/// Where every vertex of a mesh lies on the next coarser level of detail, in the same layout as the mesh buffers.
+	/// Blending each vertex from its morph target to its own attributes as the camera approaches turns one level into the other without popping.
+	/// Where the surface is linear between the parents, such as a flat Plane, the target equals the mesh and displaced meshes should blend with BasicMorphMesh::parents instead.
+	/// Attributes the mesh wasn't generated with are left empty
+	/// </summary>
+	struct MorphTarget
+	{
+		/// <summary>
+		/// float list of 3 tuple positions on the coarser level (X, Y, Z)
+		/// </summary>
+		std::vector<float> vertices;
+		/// <summary>
+		/// float list of 3 tuple normals of the coarser level (NX, NY, NZ)
+		/// </summary>
+		std::vector<float> normals;
+		/// <summary>
+		/// float list of 2 tuple texture coordinates on the coarser level
+		/// </summary>
+		std::vector<float> textureUVs;
+	};
+	/// <summary>
+	/// Mesh with the morph target of every vertex
+	/// </summary>
+	template <typename IndexType>
+	struct BasicMorphMesh
+	{
+		BasicMesh<IndexType> mesh;
+		/// <summary>
+		/// Attributes of every vertex of mesh on the coarser level
+		/// </summary>
+		MorphTarget parent;
+		/// <summary>
+		/// 2 vertex indices into mesh for every vertex, the ends of the coarser edge it splits, or the vertex itself twice if it is on the coarser level.
+		/// Meshes displaced after generation, such as terrain sampling a heightmap, blend to the average of the displacement at both parents
+		/// </summary>
+		std::vector<IndexType> parents;
+	};
+	/// <summary>
+	/// Morph mesh with 32-bit indices
+	/// </summary>
+	using MorphMesh = BasicMorphMesh<std::uint32_t>;
+	namespace internal
+	{
+		/// <summary>
+		/// Builds the morph target of a mesh from the 2 vertices each vertex was split from, vertices kept from the coarser level list themselves twice.
+		/// Positions and texture UVs are the midpoint of the parents, which is where the vertex lies on the coarser level, and normals are their normalised sum
+		/// </summary>
+		/// <param name="mesh">Subdivided mesh</param>
+		/// <param name="parents">2 parent vertex indices for every vertex</param>
+		/// <param name="context">Context the morph target buffers are taken from</param>
+		/// <returns>Morph target of every vertex</returns>
+		template <typename IndexType>
+		inline MorphTarget MorphTargetFromParents(const BasicMesh<IndexType>& mesh, const std::vector<std::uint32_t>& parents, GeneratorContext& context)
+		{
+			MorphTarget target;
+			target.vertices = context.NewBuffer<float>(mesh.vertices.size());
+			target.normals = context.NewBuffer<float>(mesh.normals.size());
+			target.textureUVs = context.NewBuffer<float>(mesh.textureUVs.size());
+			for (std::size_t v = 0, size = mesh.vertices.size() / 3; v < size; v++)
+			{
+				const std::size_t a = parents[2 * v + 0], b = parents[2 * v + 1];
+				for (std::size_t k = 0; k < 3; k++)
+				{
+					target.vertices[3 * v + k] = (mesh.vertices[3 * a + k] + mesh.vertices[3 * b + k]) * 0.5f;
+				}
+				if (!target.textureUVs.empty())
+				{
+					target.textureUVs[2 * v + 0] = (mesh.textureUVs[2 * a + 0] + mesh.textureUVs[2 * b + 0]) * 0.5f;
+					target.textureUVs[2 * v + 1] = (mesh.textureUVs[2 * a + 1] + mesh.textureUVs[2 * b + 1]) * 0.5f;
+				}
+				if (!target.normals.empty())
+				{
+					float n[3];
+					for (std::size_t k = 0; k < 3; k++)
+					{
+						n[k] = mesh.normals[3 * a + k] + mesh.normals[3 * b + k];
+					}
+					const float length = std::sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+					const float inverseLength = (length > 0.0f) ? 1.0f / length : 0.0f;
+					for (std::size_t k = 0; k < 3; k++)
+					{
+						target.normals[3 * v + k] = n[k] * inverseLength;
+					}
+				}
+			}
+			return target;
+		}
+	}
+}
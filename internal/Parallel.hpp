@@ -0,0 +1,178 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Construct::internal
+{
+	/// <summary>
+	/// Number of threads worth splitting work across
+	/// </summary>
+	inline std::uint32_t HardwareThreads()
+	{
+		return std::max(1u, std::thread::hardware_concurrency());
+	}
+	/// <summary>
+	/// Number of chunks ParallelFor will split a range into
+	/// </summary>
+	/// <param name="count">Number of items</param>
+	/// <param name="minChunk">Minimum number of items per chunk, small ranges run on the calling thread</param>
+	inline std::uint32_t ChunkCount(std::size_t count, std::size_t minChunk)
+	{
+		const std::size_t chunks = (count + minChunk - 1) / std::max<std::size_t>(minChunk, 1);
+		return static_cast<std::uint32_t>(std::clamp<std::size_t>(chunks, 1, HardwareThreads()));
+	}
+	/// <summary>
+	/// Splits [0, count) into contiguous chunks and runs func(begin, end, chunkIndex) on each, one thread per chunk.
+	/// The last chunk runs on the calling thread, returns once every chunk is done
+	/// </summary>
+	/// <param name="count">Number of items</param>
+	/// <param name="minChunk">Minimum number of items per chunk, small ranges run on the calling thread</param>
+	/// <param name="func">Callback taking the item range and the chunk index</param>
+	template <typename Func>
+	inline void ParallelFor(std::size_t count, std::size_t minChunk, Func&& func)
+	{
+		const std::uint32_t chunks = ChunkCount(count, minChunk);
+		if (chunks == 1)
+		{
+			func(std::size_t(0), count, 0u);
+			return;
+		}
+		std::vector<std::thread> threads;
+		threads.reserve(chunks - 1);
+		for (std::uint32_t i = 0; i < chunks; i++)
+		{
+			const std::size_t begin = count * i / chunks;
+			const std::size_t end = count * (i + 1) / chunks;
+			if (i + 1 == chunks)
+			{
+				func(begin, end, i);
+			}
+			else
+			{
+				threads.emplace_back([&func, begin, end, i]() { func(begin, end, i); });
+			}
+		}
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+	}
+	/// <summary>
+	/// Worker threads that stay alive between ParallelFor calls, so splitting work stops allocating and spawning threads once they are started.
+	/// Workers sleep until Run hands them a chunk, a pool runs one range at a time and must not be used from inside its own chunks
+	/// </summary>
+	class WorkerPool
+	{
+	public:
+		inline WorkerPool() = default;
+		WorkerPool(const WorkerPool&) = delete;
+		WorkerPool& operator=(const WorkerPool&) = delete;
+		inline ~WorkerPool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(this->mutex);
+				this->stopping = true;
+			}
+			this->wake.notify_all();
+			for (std::thread& thread : this->threads)
+			{
+				thread.join();
+			}
+		}
+		/// <summary>
+		/// Splits [0, count) into chunks contiguous ranges and runs func(begin, end, chunkIndex) on each, like ParallelFor.
+		/// Workers are started the first time they are needed, the last chunk runs on the calling thread
+		/// </summary>
+		template <typename Func>
+		inline void Run(std::size_t count, std::uint32_t chunks, Func& func)
+		{
+			if (this->threads.size() + 1 < chunks)
+			{
+				this->threads.reserve(HardwareThreads() - 1);
+				while (this->threads.size() + 1 < chunks)
+				{
+					// Started between ranges, so the worker waits for the next generation
+					this->threads.emplace_back([this, worker = static_cast<std::uint32_t>(this->threads.size()), seen = this->generation]() { this->Work(worker, seen); });
+				}
+			}
+			{
+				std::lock_guard<std::mutex> lock(this->mutex);
+				// A function pointer and the address of func, std::function could allocate for large captures
+				this->job = [](void* data, std::size_t begin, std::size_t end, std::uint32_t chunk) { (*static_cast<Func*>(data))(begin, end, chunk); };
+				this->data = &func;
+				this->count = count;
+				this->chunks = chunks;
+				this->pending = chunks - 1;
+				this->generation++;
+			}
+			this->wake.notify_all();
+			func(count * (chunks - 1) / chunks, count, chunks - 1);
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->done.wait(lock, [this]() { return this->pending == 0; });
+		}
+	private:
+		inline void Work(std::uint32_t worker, std::uint64_t seen)
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+			while (true)
+			{
+				this->wake.wait(lock, [&]() { return this->stopping || this->generation != seen; });
+				if (this->stopping)
+				{
+					return;
+				}
+				seen = this->generation;
+				// Workers past the chunks of this range sit it out
+				if (worker + 1 >= this->chunks)
+				{
+					continue;
+				}
+				void (*job)(void*, std::size_t, std::size_t, std::uint32_t) = this->job;
+				void* data = this->data;
+				const std::size_t begin = this->count * worker / this->chunks;
+				const std::size_t end = this->count * (worker + 1) / this->chunks;
+				lock.unlock();
+				job(data, begin, end, worker);
+				lock.lock();
+				if (--this->pending == 0)
+				{
+					this->done.notify_one();
+				}
+			}
+		}
+		std::vector<std::thread> threads;
+		std::mutex mutex;
+		std::condition_variable wake;
+		std::condition_variable done;
+		void (*job)(void*, std::size_t, std::size_t, std::uint32_t) = nullptr;
+		void* data = nullptr;
+		std::size_t count = 0;
+		std::uint32_t chunks = 0;
+		std::uint32_t pending = 0;
+		std::uint64_t generation = 0;
+		bool stopping = false;
+	};
+	/// <summary>
+	/// ParallelFor on the persistent workers of a pool instead of new threads
+	/// </summary>
+	/// <param name="pool">Workers to run the chunks on</param>
+	/// <param name="count">Number of items</param>
+	/// <param name="minChunk">Minimum number of items per chunk, small ranges run on the calling thread</param>
+	/// <param name="func">Callback taking the item range and the chunk index</param>
+	template <typename Func>
+	inline void ParallelFor(WorkerPool& pool, std::size_t count, std::size_t minChunk, Func&& func)
+	{
+		const std::uint32_t chunks = ChunkCount(count, minChunk);
+		if (chunks == 1)
+		{
+			func(std::size_t(0), count, 0u);
+			return;
+		}
+		pool.Run(count, chunks, func);
+	}
+}
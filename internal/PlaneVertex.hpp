@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace Construct::internal
+{
+	/// <summary>
+	/// Calculates one vertex of an untransformed Plane, shared by the generator and PlaneView so they match exactly.
+	/// Attributes with a null output are skipped
+	/// </summary>
+	/// <param name="i">Row of the vertex, 0 to heightTiles inclusive</param>
+	/// <param name="j">Column of the vertex, 0 to widthTiles inclusive</param>
+	/// <param name="widthTiles">Number of tiles along the width</param>
+	/// <param name="heightTiles">Number of tiles along the height</param>
+	/// <param name="position">Output 3 tuple position</param>
+	/// <param name="normal">Output 3 tuple normal, or nullptr</param>
+	/// <param name="textureUV">Output 2 tuple texture coordinate, or nullptr</param>
+	/// <param name="tangent">Output 4 tuple tangent, or nullptr</param>
+	inline void PlaneVertex(std::uint32_t i, std::uint32_t j, std::uint32_t widthTiles, std::uint32_t heightTiles, float* position, float* normal, float* textureUV, float* tangent)
+	{
+		float x = static_cast<float>(j) / widthTiles - 0.5f;
+		float z = static_cast<float>(i) / heightTiles - 0.5f;
+		position[0] = x;
+		position[1] = z;
+		position[2] = 0.0f;
+		if (textureUV != nullptr)
+		{
+			textureUV[0] = x + 0.5f;
+			textureUV[1] = z + 0.5f;
+		}
+		// The plane faces +z before transforms
+		if (normal != nullptr)
+		{
+			normal[0] = 0.0f;
+			normal[1] = 0.0f;
+			normal[2] = 1.0f;
+		}
+		// U follows +x and V follows +y
+		if (tangent != nullptr)
+		{
+			tangent[0] = 1.0f;
+			tangent[1] = 0.0f;
+			tangent[2] = 0.0f;
+			tangent[3] = 1.0f;
+		}
+	}
+	/// <summary>
+	/// Finds the ends of the edge of the Plane with half the tiles along each side that vertex (i, j) splits.
+	/// Vertices on even rows and columns are kept and are their own parents, quad centers split the (i - 1, j + 1), (i + 1, j - 1) diagonal of the coarse quad.
+	/// GridIndices splits quads along that diagonal for every topology and winding, so both parents are always joined by an edge of the coarse Plane
+	/// </summary>
+	/// <param name="i">Row of the vertex</param>
+	/// <param name="j">Column of the vertex</param>
+	/// <param name="i0">Output row of the first parent</param>
+	/// <param name="j0">Output column of the first parent</param>
+	/// <param name="i1">Output row of the second parent</param>
+	/// <param name="j1">Output column of the second parent</param>
+	inline void PlaneMorphParents(std::uint32_t i, std::uint32_t j, std::uint32_t& i0, std::uint32_t& j0, std::uint32_t& i1, std::uint32_t& j1)
+	{
+		i0 = i - (i & 1);
+		i1 = i + (i & 1);
+		j0 = j - (j & 1);
+		j1 = j + (j & 1);
+		if ((i & 1) != 0 && (j & 1) != 0)
+		{
+			std::swap(j0, j1);
+		}
+	}
+	/// <summary>
+	/// Calculates where vertex (i, j) of an untransformed Plane lies on the Plane with half the tiles along each side, the midpoint of its PlaneMorphParents.
+	/// Tile counts must be even, attributes with a null output are skipped
+	/// </summary>
+	/// <param name="i">Row of the vertex, 0 to heightTiles inclusive</param>
+	/// <param name="j">Column of the vertex, 0 to widthTiles inclusive</param>
+	/// <param name="widthTiles">Number of tiles along the width</param>
+	/// <param name="heightTiles">Number of tiles along the height</param>
+	/// <param name="position">Output 3 tuple position</param>
+	/// <param name="normal">Output 3 tuple normal, or nullptr</param>
+	/// <param name="textureUV">Output 2 tuple texture coordinate, or nullptr</param>
+	inline void PlaneMorphVertex(std::uint32_t i, std::uint32_t j, std::uint32_t widthTiles, std::uint32_t heightTiles, float* position, float* normal, float* textureUV)
+	{
+		// Both parents are on the fine grid so the midpoint is exact in grid units
+		std::uint32_t i0, j0, i1, j1;
+		PlaneMorphParents(i, j, i0, j0, i1, j1);
+		float a[3], b[3], uvA[2], uvB[2];
+		PlaneVertex(i0, j0, widthTiles, heightTiles, a, normal, textureUV != nullptr ? uvA : nullptr, nullptr);
+		PlaneVertex(i1, j1, widthTiles, heightTiles, b, nullptr, textureUV != nullptr ? uvB : nullptr, nullptr);
+		for (std::size_t k = 0; k < 3; k++)
+		{
+			position[k] = (a[k] + b[k]) * 0.5f;
+		}
+		if (textureUV != nullptr)
+		{
+			textureUV[0] = (uvA[0] + uvB[0]) * 0.5f;
+			textureUV[1] = (uvA[1] + uvB[1]) * 0.5f;
+		}
+	}
+}
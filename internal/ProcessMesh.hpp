@@ -1,7 +1,12 @@
 #pragma once
 
 #include "Mesh.hpp"
+#include "GeneratorSetting.hpp"
+#include "MorphTarget.hpp"
 #include "types.hpp"
+#include "../utils/Reorder.hpp"
+
+#include <cmath>
 
 namespace Construct::internal
 {
@@ -11,45 +16,170 @@ namespace Construct::internal
 	{
 		return (static_cast<T>(0) < val) - (val < static_cast<T>(0));
 	}
-	inline void ProcessMesh(Mesh& mesh, const GeneratorSetting& settings)
+	/// <summary>
+	/// Whether a setting moves, scales or rotates the mesh
+	/// </summary>
+	inline bool HasTransform(const GeneratorSetting& settings)
+	{
+		return settings.offset != vec3(0.0f, 0.0f, 0.0f) ||
+			settings.scale != vec3(1.0f, 1.0f, 1.0f) ||
+			settings.rotation != quat(0.0f, 0.0f, 0.0f, 1.0f);
+	}
+	/// <summary>
+	/// Scales, rotates then offsets a 3 tuple position in place
+	/// </summary>
+	inline void TransformPosition(const GeneratorSetting& settings, float* position)
+	{
+		vec3 meshVertice = vec3(position[0], position[1], position[2]);
+		meshVertice = meshVertice * settings.scale;
+		meshVertice = settings.rotation * meshVertice;
+		meshVertice = meshVertice + settings.offset;
+		position[0] = meshVertice.x;
+		position[1] = meshVertice.y;
+		position[2] = meshVertice.z;
+	}
+	/// <summary>
+	/// Scales, rotates and renormalises a direction in place.
+	/// Normals are scaled by the inverse scale so they stay perpendicular to the surface under non-uniform scaling
+	/// </summary>
+	inline void TransformDirection(const quat& rotation, const vec3& scale, float* direction)
+	{
+		vec3 transformed = rotation * (vec3(direction[0], direction[1], direction[2]) * scale);
+		const float length = std::sqrtf(transformed.x * transformed.x + transformed.y * transformed.y + transformed.z * transformed.z);
+		const float inverseLength = (length != 0.0f) ? 1.0f / length : 0.0f;
+		direction[0] = transformed.x * inverseLength;
+		direction[1] = transformed.y * inverseLength;
+		direction[2] = transformed.z * inverseLength;
+	}
+	/// <summary>
+	/// Scale that normals are transformed with
+	/// </summary>
+	inline vec3 NormalScale(const GeneratorSetting& settings)
+	{
+		return vec3(1.0f / settings.scale.x, 1.0f / settings.scale.y, 1.0f / settings.scale.z);
+	}
+	/// <summary>
+	/// Applies ProcessMesh to one vertex, in the same order and with the same operations.
+	/// Used by generators that never hold the whole mesh, attributes with a null pointer are skipped
+	/// </summary>
+	inline void ProcessVertex(const GeneratorSetting& settings, float* position, float* normal, float* tangent)
+	{
+		if (HasTransform(settings))
+		{
+			TransformPosition(settings, position);
+			if (normal != nullptr)
+			{
+				TransformDirection(settings.rotation, NormalScale(settings), normal);
+			}
+			if (tangent != nullptr)
+			{
+				TransformDirection(settings.rotation, settings.scale, tangent);
+			}
+		}
+		if (settings.windingOrder == WindingOrder::CW)
+		{
+			if (normal != nullptr)
+			{
+				normal[0] *= -1.0f;
+				normal[1] *= -1.0f;
+				normal[2] *= -1.0f;
+			}
+			if (tangent != nullptr)
+			{
+				tangent[3] *= -1.0f;
+			}
+		}
+	}
+	template <typename IndexType>
+	inline void ProcessMesh(BasicMesh<IndexType>& mesh, const GeneratorSetting& settings)
 	{
 		// Process vertices for rotation, scale and offset
 		// If offset or scale is left default, then ignore
-		if (
-			settings.offset != vec3(0.0f, 0.0f, 0.0f) ||
-			settings.scale != vec3(1.0f, 1.0f, 1.0f) ||
-			settings.rotation != quat(0.0f, 0.0f, 0.0f, 1.0f)
-			)
+		if (HasTransform(settings))
 		{
+			// Bounds are rebuilt while transforming, the sphere stays centered on the transformed origin
+			Bounds bounds(settings.offset);
 			for (std::size_t i = 0, size = mesh.vertices.size(); i < size; i += 3)
 			{
-				vec3 meshVertice = vec3(mesh.vertices[i + 0], mesh.vertices[i + 1], mesh.vertices[i + 2]);
-				meshVertice = meshVertice * settings.scale;
-				meshVertice = settings.rotation * meshVertice;
-				meshVertice = meshVertice + settings.offset;
-				mesh.vertices[i + 0] = meshVertice.x;
-				mesh.vertices[i + 1] = meshVertice.y;
-				mesh.vertices[i + 2] = meshVertice.z;
+				TransformPosition(settings, &mesh.vertices[i]);
+				bounds.Add(mesh.vertices[i + 0], mesh.vertices[i + 1], mesh.vertices[i + 2]);
+			}
+			mesh.bounds = bounds;
+			// Normals and tangents are only rotated and renormalised, normals are divided by the scale
+			const vec3 inverseScale = NormalScale(settings);
+			for (std::size_t i = 0, size = mesh.normals.size(); i < size; i += 3)
+			{
+				TransformDirection(settings.rotation, inverseScale, &mesh.normals[i]);
+			}
+			for (std::size_t i = 0, size = mesh.tangents.size(); i < size; i += 4)
+			{
+				TransformDirection(settings.rotation, settings.scale, &mesh.tangents[i]);
 			}
 		}
 		// Process for face direction
 		if (settings.windingOrder == WindingOrder::CW)
 		{
-			// Flip indices
-			for (std::size_t i = 0, size = mesh.indices.size(); i < size; i += 3)
+			// Flip indices, strips are already wound by the generator
+			if (mesh.topology == Topology::TriangleList)
 			{
-				std::uint32_t temp = mesh.indices[i + 0];
-				mesh.indices[i + 0] = mesh.indices[i + 2];
-				// Ignore middle index
-				mesh.indices[i + 2] = temp;
+				for (std::size_t i = 0, size = mesh.indices.size(); i < size; i += 3)
+				{
+					IndexType temp = mesh.indices[i + 0];
+					mesh.indices[i + 0] = mesh.indices[i + 2];
+					// Ignore middle index
+					mesh.indices[i + 2] = temp;
+				}
 			}
-			// Flip normals
+			// Flip normals, skipped entirely when normals weren't generated
 			for (std::size_t i = 0, size = mesh.normals.size(); i < size; i += 3)
 			{
 				mesh.normals[i + 0] *= -1.0f;
 				mesh.normals[i + 1] *= -1.0f;
 				mesh.normals[i + 2] *= -1.0f;
 			}
+			// Flipping the normal flips the handedness of the tangent frame
+			for (std::size_t i = 0, size = mesh.tangents.size(); i < size; i += 4)
+			{
+				mesh.tangents[i + 3] *= -1.0f;
+			}
+		}
+		// Reorder last so it sees the final positions and winding
+		ReorderVertices(mesh, settings.vertexOrder);
+	}
+	/// <summary>
+	/// Applies ProcessMesh to a mesh and its morph target, the morph target is transformed like the mesh and reordered with it
+	/// </summary>
+	template <typename IndexType>
+	inline void ProcessMorphMesh(BasicMorphMesh<IndexType>& morph, const GeneratorSetting& settings)
+	{
+		GeneratorSetting generated = settings;
+		generated.vertexOrder = VertexOrder::Generated;
+		ProcessMesh(morph.mesh, generated);
+		MorphTarget& parent = morph.parent;
+		for (std::size_t v = 0, size = parent.vertices.size() / 3; v < size; v++)
+		{
+			ProcessVertex(settings, &parent.vertices[3 * v], parent.normals.empty() ? nullptr : &parent.normals[3 * v], nullptr);
+		}
+		const std::vector<IndexType> remap = ReorderVertices(morph.mesh, settings.vertexOrder);
+		if (!remap.empty())
+		{
+			// The morph target goes through the same permutation as a mesh without indices
+			BasicMesh<IndexType> parentMesh;
+			parentMesh.vertices = std::move(parent.vertices);
+			parentMesh.normals = std::move(parent.normals);
+			parentMesh.textureUVs = std::move(parent.textureUVs);
+			ApplyVertexRemap(parentMesh, remap);
+			parent.vertices = std::move(parentMesh.vertices);
+			parent.normals = std::move(parentMesh.normals);
+			parent.textureUVs = std::move(parentMesh.textureUVs);
+			// Parents move with their vertex and point at where the parent vertices moved to
+			std::vector<IndexType> parents(morph.parents.size());
+			for (std::size_t v = 0, size = parents.size() / 2; v < size; v++)
+			{
+				parents[2 * static_cast<std::size_t>(remap[v]) + 0] = remap[morph.parents[2 * v + 0]];
+				parents[2 * static_cast<std::size_t>(remap[v]) + 1] = remap[morph.parents[2 * v + 1]];
+			}
+			morph.parents.swap(parents);
 		}
 	}
 }
\ No newline at end of file
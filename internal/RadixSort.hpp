@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Parallel.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace Construct::internal
+{
+	/// <summary>
+	/// Stable least significant digit radix sort of 64-bit keys with payloads.
+	/// Every 8-bit digit is histogrammed and scattered in parallel chunks, digits that are the same for every key are skipped
+	/// </summary>
+	/// <param name="keys">Keys to sort</param>
+	/// <param name="values">Payloads, reordered alongside the keys</param>
+	template <typename ValueType>
+	inline void RadixSort(std::vector<std::uint64_t>& keys, std::vector<ValueType>& values)
+	{
+		static constexpr std::size_t MinChunk = 1 << 16;
+		const std::size_t count = keys.size();
+		const std::uint32_t chunks = ChunkCount(count, MinChunk);
+		std::vector<std::uint64_t> keysBuffer(count);
+		std::vector<ValueType> valuesBuffer(count);
+		std::vector<std::array<std::size_t, 256>> histograms(chunks);
+		for (std::uint32_t shift = 0; shift < 64; shift += 8)
+		{
+			// Count digits per chunk
+			ParallelFor(count, MinChunk, [&](std::size_t begin, std::size_t end, std::uint32_t chunk) {
+				std::array<std::size_t, 256>& histogram = histograms[chunk];
+				histogram.fill(0);
+				for (std::size_t i = begin; i < end; i++)
+				{
+					histogram[(keys[i] >> shift) & 0xFF]++;
+				}
+			});
+			// Turn counts into output offsets, digit major so the sort stays stable across chunks
+			bool skip = false;
+			std::size_t offset = 0;
+			for (std::uint32_t digit = 0; digit < 256; digit++)
+			{
+				std::size_t digitCount = 0;
+				for (std::uint32_t chunk = 0; chunk < chunks; chunk++)
+				{
+					const std::size_t chunkCount = histograms[chunk][digit];
+					histograms[chunk][digit] = offset;
+					offset += chunkCount;
+					digitCount += chunkCount;
+				}
+				skip = skip || digitCount == count;
+			}
+			if (skip)
+			{
+				continue;
+			}
+			// Scatter into the buffers
+			ParallelFor(count, MinChunk, [&](std::size_t begin, std::size_t end, std::uint32_t chunk) {
+				std::array<std::size_t, 256>& histogram = histograms[chunk];
+				for (std::size_t i = begin; i < end; i++)
+				{
+					const std::size_t destination = histogram[(keys[i] >> shift) & 0xFF]++;
+					keysBuffer[destination] = keys[i];
+					valuesBuffer[destination] = values[i];
+				}
+			});
+			keys.swap(keysBuffer);
+			values.swap(valuesBuffer);
+		}
+	}
+}
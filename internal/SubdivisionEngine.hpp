@@ -0,0 +1,727 @@
+#pragma once
+
+#include "./Mesh.hpp"
+#include "./GeneratorContext.hpp"
+#include "./Parallel.hpp"
+#include "./Topology.hpp"
+#include "./CalculateTangents.hpp"
+#include "../utils/Weld.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace Construct
+{
+	/// <summary>
+	/// Enum for Subdivide that defines where the vertices of each level are placed.
+	/// Midpoint splits every triangle into 4 without moving the surface,
+	/// Loop also smooths the vertices towards a C2 limit surface, boundaries are smoothed as curves
+	/// </summary>
+	enum class SubdivisionScheme : std::uint8_t { Midpoint, Loop };
+	namespace internal
+	{
+		/// <summary>
+		/// Number of faces, edges or vertices per chunk when a subdivision level is split across threads
+		/// </summary>
+		inline constexpr std::size_t SubdivisionParallelChunk = 1 << 14;
+		/// <summary>
+		/// Hash of a run of floats, adding 0.0f turns -0.0f into 0.0f so values that compare equal always hash the same
+		/// </summary>
+		inline std::uint64_t FloatsHash(const float* values, std::size_t count, std::uint64_t seed)
+		{
+			for (std::size_t i = 0; i < count; i++)
+			{
+				seed = (seed ^ std::bit_cast<std::uint32_t>(values[i] + 0.0f)) * 0x9e3779b97f4a7c15ull;
+			}
+			return seed ^ (seed >> 32);
+		}
+		/// <summary>
+		/// 1 to 4 triangle subdivision of arbitrary triangle meshes over a half-edge table.
+		/// Half-edge 3f + k runs from corner k to corner k + 1 of face f, and its twin is the opposite half-edge of the neighbouring face.
+		/// The table is built once by hashing, every later level derives its table directly from the previous one:
+		/// the halves of a split half-edge and the 3 new interior edges of each face have fixed positions, so levels run in parallel across faces.
+		/// Twins are matched by position, so texture seams and normal creases don't tear the smoothed surface.
+		/// A seam edge gets one new vertex for each side, a non-manifold edge keeps its extra faces as boundaries.
+		/// Old vertices keep their indices, followed by a vertex for each edge and then the second vertex of each seam edge
+		/// </summary>
+		template <typename IndexType>
+		class SubdivisionEngine
+		{
+		public:
+			/// <summary>
+			/// Marks a missing twin, edge or seam
+			/// </summary>
+			static constexpr std::uint32_t None = std::numeric_limits<std::uint32_t>::max();
+			/// <summary>
+			/// Welds exactly equal vertices and builds the half-edge table of a mesh.
+			/// Tangents are dropped and recalculated by Finish, triangle strips are expanded into lists and triangles with 2 corners at one position are dropped
+			/// </summary>
+			/// <param name="context">Context the buffers of every level and the tables are taken from, must outlive the engine</param>
+			/// <param name="mesh">Mesh to subdivide, its buffers are recycled as levels are built</param>
+			inline SubdivisionEngine(GeneratorContext& context, BasicMesh<IndexType>&& mesh) : context(context), mesh(std::move(mesh))
+			{
+				if (this->mesh.topology == Topology::TriangleStrip)
+				{
+					this->mesh.indices = ToTriangleList(this->mesh.indices, this->mesh.topology);
+					this->mesh.topology = Topology::TriangleList;
+				}
+				this->mesh.indices.resize(this->mesh.indices.size() / 3 * 3);
+				this->hasTangents = !this->mesh.tangents.empty();
+				context.Recycle(std::move(this->mesh.tangents));
+				this->Weld();
+				this->Build();
+			}
+			SubdivisionEngine(const SubdivisionEngine&) = delete;
+			SubdivisionEngine& operator=(const SubdivisionEngine&) = delete;
+			/// <summary>
+			/// Subdivides every triangle into 4
+			/// </summary>
+			inline void Level(SubdivisionScheme scheme)
+			{
+				if (scheme == SubdivisionScheme::Loop)
+				{
+					this->Refine<true>([](const float*, const float*, float*) {});
+				}
+				else
+				{
+					this->Level([](const float* a, const float* b, float* output) {
+						output[0] = (a[0] + b[0]) * 0.5f;
+						output[1] = (a[1] + b[1]) * 0.5f;
+						output[2] = (a[2] + b[2]) * 0.5f;
+					});
+				}
+			}
+			/// <summary>
+			/// Subdivides every triangle into 4, placing the new vertex of each edge with edgePoint(a, b, output).
+			/// edgePoint must be commutative, so both sides of a seam get the same position
+			/// </summary>
+			template <typename EdgePoint>
+			inline void Level(EdgePoint&& edgePoint)
+			{
+				this->Refine<false>(edgePoint);
+			}
+			/// <summary>
+			/// Makes every following level write the 2 vertices of the level before it that each vertex was split from into parents.
+			/// Kept vertices list themselves twice, parents ends up describing the last level
+			/// </summary>
+			inline void RecordParents(std::vector<std::uint32_t>& parents)
+			{
+				this->parents = &parents;
+			}
+			/// <summary>
+			/// Finishes the subdivided mesh, smoothing the normals after Loop levels and recalculating tangents
+			/// </summary>
+			/// <returns>Subdivided triangle list</returns>
+			inline BasicMesh<IndexType> Finish()
+			{
+				if (this->smoothNormals)
+				{
+					this->mesh.normals = this->context.NewBuffer<float>(3 * this->vertexCount);
+					this->SmoothNormals();
+				}
+				if (this->hasTangents)
+				{
+					this->mesh.tangents = this->context.NewBuffer<float>(4 * this->vertexCount);
+					CalculateTangents(this->mesh.vertices, this->mesh.normals, this->mesh.textureUVs, this->mesh.indices, this->mesh.tangents, this->context);
+				}
+				this->mesh.bounds = Bounds();
+				this->mesh.bounds.Add(this->mesh.vertices);
+				return std::move(this->mesh);
+			}
+		private:
+			/// <summary>
+			/// Tables of one level, each has a pair of scratch slots that levels alternate between
+			/// </summary>
+			enum Table : std::uint32_t { Twin, EdgeOf, EdgeHalf, SeamRank, VertexHalf };
+			inline std::vector<std::uint32_t>& Get(Table table, std::uint32_t generation)
+			{
+				return this->context.Scratch<std::uint32_t>(2 * table + (generation & 1));
+			}
+			static inline std::size_t Next(std::size_t h)
+			{
+				return (h % 3 == 2) ? h - 2 : h + 1;
+			}
+			static inline std::size_t Prev(std::size_t h)
+			{
+				return (h % 3 == 0) ? h + 2 : h - 1;
+			}
+			/// <summary>
+			/// Half of a split half-edge that starts at the same corner, it lies in the child face of that corner
+			/// </summary>
+			static inline std::uint32_t FirstHalf(std::size_t h)
+			{
+				return static_cast<std::uint32_t>(12 * (h / 3) + 4 * (h % 3));
+			}
+			/// <summary>
+			/// Half of a split half-edge that ends at the same corner
+			/// </summary>
+			static inline std::uint32_t SecondHalf(std::size_t h)
+			{
+				return static_cast<std::uint32_t>(12 * (h / 3) + 3 * ((h % 3 + 1) % 3) + h % 3);
+			}
+			/// <summary>
+			/// Merges vertices whose every attribute is exactly equal, keeping the first of each and their order
+			/// </summary>
+			inline void Weld()
+			{
+				const std::size_t vertexCount = this->mesh.vertices.size() / 3;
+				const bool hasNormals = !this->mesh.normals.empty();
+				const bool hasTextureUVs = !this->mesh.textureUVs.empty();
+				const auto hash = [&](std::size_t v) {
+					std::uint64_t seed = FloatsHash(&this->mesh.vertices[v * 3], 3, 0);
+					seed = hasNormals ? FloatsHash(&this->mesh.normals[v * 3], 3, seed) : seed;
+					return hasTextureUVs ? FloatsHash(&this->mesh.textureUVs[v * 2], 2, seed) : seed;
+				};
+				const auto equal = [&](std::size_t a, std::size_t b) {
+					for (std::size_t k = 0; k < 3; k++)
+					{
+						if (this->mesh.vertices[a * 3 + k] != this->mesh.vertices[b * 3 + k] || (hasNormals && this->mesh.normals[a * 3 + k] != this->mesh.normals[b * 3 + k]))
+						{
+							return false;
+						}
+					}
+					return !hasTextureUVs || (this->mesh.textureUVs[a * 2 + 0] == this->mesh.textureUVs[b * 2 + 0] && this->mesh.textureUVs[a * 2 + 1] == this->mesh.textureUVs[b * 2 + 1]);
+				};
+				std::vector<std::uint64_t>& remap = this->context.Scratch<std::uint64_t>(1);
+				const std::size_t duplicates = FirstOccurrences(vertexCount, hash, equal, remap);
+				if (duplicates == 0)
+				{
+					return;
+				}
+				// Move the first occurrences down, a vertex never moves up so this is safe in place
+				std::size_t nextIndex = 0;
+				for (std::size_t v = 0; v < vertexCount; v++)
+				{
+					if (remap[v] != v)
+					{
+						remap[v] = remap[remap[v]];
+						continue;
+					}
+					remap[v] = nextIndex;
+					for (std::size_t k = 0; k < 3; k++)
+					{
+						this->mesh.vertices[nextIndex * 3 + k] = this->mesh.vertices[v * 3 + k];
+						if (hasNormals)
+						{
+							this->mesh.normals[nextIndex * 3 + k] = this->mesh.normals[v * 3 + k];
+						}
+					}
+					if (hasTextureUVs)
+					{
+						this->mesh.textureUVs[nextIndex * 2 + 0] = this->mesh.textureUVs[v * 2 + 0];
+						this->mesh.textureUVs[nextIndex * 2 + 1] = this->mesh.textureUVs[v * 2 + 1];
+					}
+					nextIndex++;
+				}
+				this->mesh.vertices.resize(3 * nextIndex);
+				this->mesh.normals.resize(hasNormals ? 3 * nextIndex : 0);
+				this->mesh.textureUVs.resize(hasTextureUVs ? 2 * nextIndex : 0);
+				for (IndexType& index : this->mesh.indices)
+				{
+					index = static_cast<IndexType>(remap[index]);
+				}
+			}
+			/// <summary>
+			/// Maps every item to the first item equal to it with an open addressing table
+			/// </summary>
+			/// <returns>Number of items that aren't a first occurrence</returns>
+			template <typename Hash, typename Equal>
+			inline std::size_t FirstOccurrences(std::size_t count, const Hash& hash, const Equal& equal, std::vector<std::uint64_t>& first)
+			{
+				std::vector<std::uint64_t>& table = this->context.Scratch<std::uint64_t>(0);
+				std::size_t tableSize = 16;
+				while (tableSize < 2 * count)
+				{
+					tableSize *= 2;
+				}
+				table.assign(tableSize, 0);
+				first.resize(count);
+				std::size_t duplicates = 0;
+				for (std::size_t i = 0; i < count; i++)
+				{
+					std::size_t slot = hash(i) & (tableSize - 1);
+					while (table[slot] != 0 && !equal(table[slot] - 1, i))
+					{
+						slot = (slot + 1) & (tableSize - 1);
+					}
+					if (table[slot] == 0)
+					{
+						table[slot] = i + 1;
+						first[i] = i;
+					}
+					else
+					{
+						first[i] = table[slot] - 1;
+						duplicates++;
+					}
+				}
+				return duplicates;
+			}
+			/// <summary>
+			/// Builds the level 0 tables, twins are matched by welded positions
+			/// </summary>
+			inline void Build()
+			{
+				const std::size_t vertexCount = this->mesh.vertices.size() / 3;
+				// Points, the first vertex at each position
+				std::vector<std::uint64_t>& pointOf = this->context.Scratch<std::uint64_t>(1);
+				WeldPoints(this->mesh, PointTolerance, this->context, pointOf);
+				// Drop triangles that repeat a point, such as the pole triangles of strips, their half-edges would pair up twice
+				IndexType* faces = this->mesh.indices.data();
+				std::size_t keptFaces = 0;
+				for (std::size_t f = 0, count = this->mesh.indices.size() / 3; f < count; f++)
+				{
+					const std::uint64_t a = pointOf[faces[3 * f + 0]], b = pointOf[faces[3 * f + 1]], c = pointOf[faces[3 * f + 2]];
+					if (a == b || b == c || a == c)
+					{
+						continue;
+					}
+					std::copy_n(&faces[3 * f], 3, &faces[3 * keptFaces]);
+					keptFaces++;
+				}
+				this->mesh.indices.resize(3 * keptFaces);
+				const std::size_t halfEdgeCount = this->mesh.indices.size();
+				if (halfEdgeCount >= None)
+				{
+					throw std::overflow_error("Construct: subdivided mesh has too many edges");
+				}
+				const IndexType* indices = this->mesh.indices.data();
+				// Twins, each half-edge pairs with the first unpaired half-edge running the other way between the same points
+				std::vector<std::uint32_t>& twin = this->Get(Twin, 0);
+				twin.assign(halfEdgeCount, None);
+				std::vector<std::uint64_t>& table = this->context.Scratch<std::uint64_t>(0);
+				std::size_t tableSize = 16;
+				while (tableSize < 2 * halfEdgeCount)
+				{
+					tableSize *= 2;
+				}
+				table.assign(tableSize, 0);
+				for (std::size_t h = 0; h < halfEdgeCount; h++)
+				{
+					const std::uint64_t start = pointOf[indices[h]], end = pointOf[indices[Next(h)]];
+					// Unpaired half-edges are stored under their own direction and looked up in the reverse direction
+					std::size_t slot = PointPairHash(end, start) & (tableSize - 1);
+					bool paired = false;
+					while (table[slot] != 0)
+					{
+						const std::size_t g = table[slot] - 1;
+						if (twin[g] == None && pointOf[indices[g]] == end && pointOf[indices[Next(g)]] == start)
+						{
+							twin[g] = static_cast<std::uint32_t>(h);
+							twin[h] = static_cast<std::uint32_t>(g);
+							paired = true;
+							break;
+						}
+						slot = (slot + 1) & (tableSize - 1);
+					}
+					if (!paired)
+					{
+						slot = PointPairHash(start, end) & (tableSize - 1);
+						while (table[slot] != 0)
+						{
+							slot = (slot + 1) & (tableSize - 1);
+						}
+						table[slot] = h + 1;
+					}
+				}
+				// Edges, owned by their first half-edge
+				std::vector<std::uint32_t>& edgeOf = this->Get(EdgeOf, 0);
+				std::vector<std::uint32_t>& edgeHalf = this->Get(EdgeHalf, 0);
+				std::vector<std::uint32_t>& seamRank = this->Get(SeamRank, 0);
+				edgeOf.resize(halfEdgeCount);
+				edgeHalf.clear();
+				seamRank.clear();
+				this->seamCount = 0;
+				for (std::size_t h = 0; h < halfEdgeCount; h++)
+				{
+					const std::uint32_t t = twin[h];
+					if (t != None && t < h)
+					{
+						continue;
+					}
+					const std::uint32_t e = static_cast<std::uint32_t>(edgeHalf.size());
+					edgeHalf.push_back(static_cast<std::uint32_t>(h));
+					edgeOf[h] = e;
+					std::uint32_t rank = None;
+					if (t != None)
+					{
+						edgeOf[t] = e;
+						// Twins with different vertices lie on a seam, each side gets its own vertex
+						if (indices[h] != indices[Next(t)] || indices[Next(h)] != indices[t])
+						{
+							rank = static_cast<std::uint32_t>(this->seamCount++);
+						}
+					}
+					seamRank.push_back(rank);
+				}
+				// Every vertex of a point walks its ring from the same half-edge, so they are smoothed identically
+				std::vector<std::uint32_t>& vertexHalf = this->Get(VertexHalf, 0);
+				vertexHalf.assign(vertexCount, None);
+				for (std::size_t h = 0; h < halfEdgeCount; h++)
+				{
+					std::uint32_t& pointHalf = vertexHalf[pointOf[indices[h]]];
+					if (pointHalf == None)
+					{
+						pointHalf = static_cast<std::uint32_t>(h);
+					}
+				}
+				for (std::size_t v = 0; v < vertexCount; v++)
+				{
+					vertexHalf[v] = vertexHalf[pointOf[v]];
+				}
+				this->vertexCount = vertexCount;
+				this->faceCount = halfEdgeCount / 3;
+				this->edgeCount = edgeHalf.size();
+			}
+			/// <summary>
+			/// Loop vertex rule, the vertex blended with its ring or with its 2 boundary neighbours
+			/// </summary>
+			inline void SmoothVertex(std::size_t v, const std::vector<std::uint32_t>& twin, const std::vector<std::uint32_t>& vertexHalf, float* output) const
+			{
+				const float* vertices = this->mesh.vertices.data();
+				const IndexType* indices = this->mesh.indices.data();
+				const std::uint32_t h0 = vertexHalf[v];
+				if (h0 == None)
+				{
+					std::copy_n(&vertices[v * 3], 3, output);
+					return;
+				}
+				// Vertices of the same point start from the same half-edge, so they smooth to bitwise identical positions
+				const std::size_t self = indices[h0];
+				float sum[3] = { 0.0f, 0.0f, 0.0f };
+				std::size_t valence = 0;
+				std::size_t h = h0;
+				std::size_t boundary = None;
+				do
+				{
+					const std::size_t neighbour = indices[Next(h)];
+					sum[0] += vertices[neighbour * 3 + 0];
+					sum[1] += vertices[neighbour * 3 + 1];
+					sum[2] += vertices[neighbour * 3 + 2];
+					valence++;
+					const std::size_t incoming = Prev(h);
+					if (twin[incoming] == None)
+					{
+						boundary = indices[incoming];
+						break;
+					}
+					h = twin[incoming];
+				} while (h != h0);
+				if (boundary != None)
+				{
+					// Walk the other way to the outgoing boundary half-edge
+					h = h0;
+					while (twin[h] != None)
+					{
+						h = Next(twin[h]);
+					}
+					const std::size_t other = indices[Next(h)];
+					for (std::size_t k = 0; k < 3; k++)
+					{
+						output[k] = 0.75f * vertices[self * 3 + k] + 0.125f * (vertices[boundary * 3 + k] + vertices[other * 3 + k]);
+					}
+					return;
+				}
+				// Warren's weights
+				const float beta = (valence == 3) ? 3.0f / 16.0f : 3.0f / (8.0f * static_cast<float>(valence));
+				const float weight = 1.0f - static_cast<float>(valence) * beta;
+				for (std::size_t k = 0; k < 3; k++)
+				{
+					output[k] = weight * vertices[self * 3 + k] + beta * sum[k];
+				}
+			}
+			/// <summary>
+			/// Loop edge rule, 3/8 of each end and 1/8 of each opposite corner, or the midpoint on a boundary
+			/// </summary>
+			inline void SmoothEdge(std::size_t h, const std::vector<std::uint32_t>& twin, float* output) const
+			{
+				const float* vertices = this->mesh.vertices.data();
+				const IndexType* indices = this->mesh.indices.data();
+				const std::size_t a = indices[h], b = indices[Next(h)];
+				const std::uint32_t t = twin[h];
+				if (t == None)
+				{
+					for (std::size_t k = 0; k < 3; k++)
+					{
+						output[k] = (vertices[a * 3 + k] + vertices[b * 3 + k]) * 0.5f;
+					}
+					return;
+				}
+				const std::size_t c = indices[Prev(h)], d = indices[Prev(t)];
+				for (std::size_t k = 0; k < 3; k++)
+				{
+					output[k] = 0.375f * (vertices[a * 3 + k] + vertices[b * 3 + k]) + 0.125f * (vertices[c * 3 + k] + vertices[d * 3 + k]);
+				}
+			}
+			/// <summary>
+			/// Blends the texture UV and normal of an edge's new vertex from its 2 ends
+			/// </summary>
+			inline void BlendAttributes(BasicMesh<IndexType>& output, std::size_t target, std::size_t a, std::size_t b) const
+			{
+				if (!output.textureUVs.empty())
+				{
+					output.textureUVs[target * 2 + 0] = (this->mesh.textureUVs[a * 2 + 0] + this->mesh.textureUVs[b * 2 + 0]) / 2.0f;
+					output.textureUVs[target * 2 + 1] = (this->mesh.textureUVs[a * 2 + 1] + this->mesh.textureUVs[b * 2 + 1]) / 2.0f;
+				}
+				if (!output.normals.empty())
+				{
+					float n[3];
+					for (std::size_t k = 0; k < 3; k++)
+					{
+						n[k] = this->mesh.normals[a * 3 + k] + this->mesh.normals[b * 3 + k];
+					}
+					const float length = std::sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+					const float inverseLength = (length > 0.0f) ? 1.0f / length : 0.0f;
+					for (std::size_t k = 0; k < 3; k++)
+					{
+						output.normals[target * 3 + k] = n[k] * inverseLength;
+					}
+				}
+			}
+			/// <summary>
+			/// Builds the next level, Loop places vertices with the Loop rules, otherwise edgePoint places the new vertices
+			/// </summary>
+			template <bool Loop, typename EdgePoint>
+			inline void Refine(const EdgePoint& edgePoint)
+			{
+				const std::size_t vertexCount = this->vertexCount, faceCount = this->faceCount, edgeCount = this->edgeCount, seamCount = this->seamCount;
+				const std::size_t newVertexCount = CheckedVertexCount<IndexType>(CheckedAdd(CheckedAdd(vertexCount, edgeCount), seamCount));
+				const std::size_t newFaceCount = CheckedMultiply(faceCount, 4);
+				const std::size_t newEdgeCount = CheckedAdd(CheckedMultiply(edgeCount, 2), CheckedMultiply(faceCount, 3));
+				if (CheckedMultiply(newFaceCount, 3) >= None || newEdgeCount >= None)
+				{
+					throw std::overflow_error("Construct: subdivided mesh has too many edges");
+				}
+				// Normals are smoothed once at the end after Loop levels
+				if (Loop && !this->mesh.normals.empty())
+				{
+					this->smoothNormals = true;
+					this->context.Recycle(std::move(this->mesh.normals));
+				}
+				BasicMesh<IndexType> output = this->context.NewMesh<IndexType>(3 * newVertexCount, 3 * newFaceCount,
+					this->mesh.normals.empty() ? 0 : 3 * newVertexCount, this->mesh.textureUVs.empty() ? 0 : 2 * newVertexCount);
+				const std::uint32_t current = this->generation, next = this->generation + 1;
+				const std::vector<std::uint32_t>& twin = this->Get(Twin, current);
+				const std::vector<std::uint32_t>& edgeOf = this->Get(EdgeOf, current);
+				const std::vector<std::uint32_t>& edgeHalf = this->Get(EdgeHalf, current);
+				const std::vector<std::uint32_t>& seamRank = this->Get(SeamRank, current);
+				const std::vector<std::uint32_t>& vertexHalf = this->Get(VertexHalf, current);
+				std::vector<std::uint32_t>& newTwin = this->Get(Twin, next);
+				std::vector<std::uint32_t>& newEdgeOf = this->Get(EdgeOf, next);
+				std::vector<std::uint32_t>& newEdgeHalf = this->Get(EdgeHalf, next);
+				std::vector<std::uint32_t>& newSeamRank = this->Get(SeamRank, next);
+				std::vector<std::uint32_t>& newVertexHalf = this->Get(VertexHalf, next);
+				newTwin.resize(3 * newFaceCount);
+				newEdgeOf.resize(3 * newFaceCount);
+				newEdgeHalf.resize(newEdgeCount);
+				newSeamRank.resize(newEdgeCount);
+				newVertexHalf.resize(newVertexCount);
+				const IndexType* indices = this->mesh.indices.data();
+				std::uint32_t* parentOutput = nullptr;
+				if (this->parents != nullptr)
+				{
+					this->parents->resize(2 * newVertexCount);
+					parentOutput = this->parents->data();
+				}
+				// Old vertices keep their index
+				ParallelFor(this->context.Workers(), vertexCount, SubdivisionParallelChunk, [&](std::size_t begin, std::size_t end, std::uint32_t) {
+					for (std::size_t v = begin; v < end; v++)
+					{
+						if constexpr (Loop)
+						{
+							this->SmoothVertex(v, twin, vertexHalf, &output.vertices[v * 3]);
+						}
+						else
+						{
+							std::copy_n(&this->mesh.vertices[v * 3], 3, &output.vertices[v * 3]);
+						}
+						if (!output.normals.empty())
+						{
+							std::copy_n(&this->mesh.normals[v * 3], 3, &output.normals[v * 3]);
+						}
+						if (!output.textureUVs.empty())
+						{
+							std::copy_n(&this->mesh.textureUVs[v * 2], 2, &output.textureUVs[v * 2]);
+						}
+						newVertexHalf[v] = (vertexHalf[v] == None) ? None : FirstHalf(vertexHalf[v]);
+						if (parentOutput != nullptr)
+						{
+							parentOutput[2 * v + 0] = parentOutput[2 * v + 1] = static_cast<std::uint32_t>(v);
+						}
+					}
+				});
+				// A new vertex on every edge, and a second one on seams, each edge splits in 2
+				ParallelFor(this->context.Workers(), edgeCount, SubdivisionParallelChunk, [&](std::size_t begin, std::size_t end, std::uint32_t) {
+					for (std::size_t e = begin; e < end; e++)
+					{
+						const std::size_t h = edgeHalf[e];
+						const std::size_t a = indices[h], b = indices[Next(h)];
+						const std::size_t target = vertexCount + e;
+						if constexpr (Loop)
+						{
+							this->SmoothEdge(h, twin, &output.vertices[target * 3]);
+						}
+						else
+						{
+							edgePoint(&this->mesh.vertices[a * 3], &this->mesh.vertices[b * 3], &output.vertices[target * 3]);
+						}
+						this->BlendAttributes(output, target, a, b);
+						newVertexHalf[target] = SecondHalf(h);
+						if (parentOutput != nullptr)
+						{
+							parentOutput[2 * target + 0] = static_cast<std::uint32_t>(a);
+							parentOutput[2 * target + 1] = static_cast<std::uint32_t>(b);
+						}
+						newEdgeHalf[2 * e + 0] = FirstHalf(h);
+						newEdgeHalf[2 * e + 1] = SecondHalf(h);
+						const std::uint32_t rank = seamRank[e];
+						newSeamRank[2 * e + 0] = (rank == None) ? None : 2 * rank + 0;
+						newSeamRank[2 * e + 1] = (rank == None) ? None : 2 * rank + 1;
+						if (rank != None)
+						{
+							const std::size_t t = twin[h];
+							const std::size_t seamTarget = vertexCount + edgeCount + rank;
+							// Loop moves both sides to the same position, midpoints follow the vertices on each side
+							if constexpr (Loop)
+							{
+								std::copy_n(&output.vertices[target * 3], 3, &output.vertices[seamTarget * 3]);
+							}
+							else
+							{
+								edgePoint(&this->mesh.vertices[indices[Next(t)] * 3], &this->mesh.vertices[indices[t] * 3], &output.vertices[seamTarget * 3]);
+							}
+							this->BlendAttributes(output, seamTarget, indices[t], indices[Next(t)]);
+							newVertexHalf[seamTarget] = SecondHalf(h);
+							if (parentOutput != nullptr)
+							{
+								parentOutput[2 * seamTarget + 0] = static_cast<std::uint32_t>(indices[t]);
+								parentOutput[2 * seamTarget + 1] = static_cast<std::uint32_t>(indices[Next(t)]);
+							}
+						}
+					}
+				});
+				// Each face splits into its 3 corners and a middle face, matching the icosphere layout
+				ParallelFor(this->context.Workers(), faceCount, SubdivisionParallelChunk, [&](std::size_t begin, std::size_t end, std::uint32_t) {
+					for (std::size_t f = begin; f < end; f++)
+					{
+						IndexType corners[3], middles[3];
+						for (std::size_t k = 0; k < 3; k++)
+						{
+							const std::size_t h = 3 * f + k;
+							const std::uint32_t e = edgeOf[h];
+							const bool owner = edgeHalf[e] == h;
+							corners[k] = indices[h];
+							middles[k] = static_cast<IndexType>((owner || seamRank[e] == None) ? vertexCount + e : vertexCount + edgeCount + seamRank[e]);
+							// The split halves of an edge pair with the split halves of its twin, swapped
+							const std::uint32_t t = twin[h];
+							newTwin[FirstHalf(h)] = (t == None) ? None : SecondHalf(t);
+							newTwin[SecondHalf(h)] = (t == None) ? None : FirstHalf(t);
+							newEdgeOf[FirstHalf(h)] = 2 * e + (owner ? 0 : 1);
+							newEdgeOf[SecondHalf(h)] = 2 * e + (owner ? 1 : 0);
+						}
+						IndexType* child = &output.indices[12 * f];
+						const IndexType childIndices[12] = {
+							corners[0], middles[0], middles[2],
+							middles[0], corners[1], middles[1],
+							middles[2], middles[1], corners[2],
+							middles[2], middles[0], middles[1],
+						};
+						std::copy_n(childIndices, 12, child);
+						// Interior edges pair a side of the middle face with a side of a corner face
+						static constexpr std::uint32_t InteriorHalves[3][2] = { { 0 * 3 + 1, 3 * 3 + 0 }, { 1 * 3 + 2, 3 * 3 + 1 }, { 2 * 3 + 0, 3 * 3 + 2 } };
+						for (std::uint32_t k = 0; k < 3; k++)
+						{
+							const std::uint32_t e = static_cast<std::uint32_t>(2 * edgeCount + 3 * f + k);
+							const std::uint32_t corner = static_cast<std::uint32_t>(12 * f + InteriorHalves[k][0]), middle = static_cast<std::uint32_t>(12 * f + InteriorHalves[k][1]);
+							newTwin[corner] = middle;
+							newTwin[middle] = corner;
+							newEdgeOf[corner] = e;
+							newEdgeOf[middle] = e;
+							newEdgeHalf[e] = corner;
+							newSeamRank[e] = None;
+						}
+					}
+				});
+				this->context.Recycle(std::move(this->mesh));
+				this->mesh = std::move(output);
+				this->mesh.topology = Topology::TriangleList;
+				this->generation = next;
+				this->vertexCount = newVertexCount;
+				this->faceCount = newFaceCount;
+				this->edgeCount = newEdgeCount;
+				this->seamCount = 2 * seamCount;
+			}
+			/// <summary>
+			/// Area weighted normals gathered around each vertex's ring, so seams share their normals
+			/// </summary>
+			inline void SmoothNormals()
+			{
+				const std::vector<std::uint32_t>& twin = this->Get(Twin, this->generation);
+				const std::vector<std::uint32_t>& vertexHalf = this->Get(VertexHalf, this->generation);
+				const float* vertices = this->mesh.vertices.data();
+				const IndexType* indices = this->mesh.indices.data();
+				const auto addFace = [&](std::size_t h, float* sum) {
+					const std::size_t a = indices[h], b = indices[Next(h)], c = indices[Prev(h)];
+					const float ux = vertices[b * 3 + 0] - vertices[a * 3 + 0], uy = vertices[b * 3 + 1] - vertices[a * 3 + 1], uz = vertices[b * 3 + 2] - vertices[a * 3 + 2];
+					const float vx = vertices[c * 3 + 0] - vertices[a * 3 + 0], vy = vertices[c * 3 + 1] - vertices[a * 3 + 1], vz = vertices[c * 3 + 2] - vertices[a * 3 + 2];
+					sum[0] += uy * vz - uz * vy;
+					sum[1] += uz * vx - ux * vz;
+					sum[2] += ux * vy - uy * vx;
+				};
+				ParallelFor(this->context.Workers(), this->vertexCount, SubdivisionParallelChunk, [&](std::size_t begin, std::size_t end, std::uint32_t) {
+					for (std::size_t v = begin; v < end; v++)
+					{
+						float sum[3] = { 0.0f, 0.0f, 0.0f };
+						const std::uint32_t h0 = vertexHalf[v];
+						if (h0 != None)
+						{
+							std::size_t h = h0;
+							bool boundary = false;
+							do
+							{
+								addFace(h, sum);
+								const std::uint32_t t = twin[Prev(h)];
+								if (t == None)
+								{
+									boundary = true;
+									break;
+								}
+								h = t;
+							} while (h != h0);
+							// Collect the faces on the other side of the start on a boundary
+							h = h0;
+							while (boundary && twin[h] != None)
+							{
+								h = Next(twin[h]);
+								addFace(h, sum);
+							}
+						}
+						const float length = std::sqrtf(sum[0] * sum[0] + sum[1] * sum[1] + sum[2] * sum[2]);
+						const float inverseLength = (length > 0.0f) ? 1.0f / length : 0.0f;
+						for (std::size_t k = 0; k < 3; k++)
+						{
+							this->mesh.normals[v * 3 + k] = sum[k] * inverseLength;
+						}
+					}
+				});
+			}
+			GeneratorContext& context;
+			BasicMesh<IndexType> mesh;
+			std::size_t vertexCount = 0;
+			std::size_t faceCount = 0;
+			std::size_t edgeCount = 0;
+			std::size_t seamCount = 0;
+			std::uint32_t generation = 0;
+			bool hasTangents = false;
+			bool smoothNormals = false;
+			std::vector<std::uint32_t>* parents = nullptr;
+		};
+	}
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "GeneratorSetting.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <stdexcept>
+
+namespace Construct
+{
+	/// <summary>
+	/// Maximum distance between a generated mesh and the surface it approximates, in world units after GeneratorSetting::scale.
+	/// Passed to the generator overloads that derive their own tessellation
+	/// </summary>
+	struct ChordalError
+	{
+		float value;
+		/// <summary>
+		/// Define a chordal error, throws std::invalid_argument if it isn't positive
+		/// </summary>
+		/// <param name="value">Maximum distance to the surface in world units</param>
+		inline explicit ChordalError(float value) : value(value)
+		{
+			if (!(value > 0.0f))
+			{
+				throw std::invalid_argument("Construct: chordal error must be positive");
+			}
+		}
+	};
+}
+
+namespace Construct::internal
+{
+	/// <summary>
+	/// Largest absolute scale of the selected axes, rotation and offset don't change the error
+	/// </summary>
+	inline float MaxScale(const vec3& scale, bool x, bool y, bool z)
+	{
+		return std::max({ x ? std::fabs(scale.x) : 0.0f, y ? std::fabs(scale.y) : 0.0f, z ? std::fabs(scale.z) : 0.0f });
+	}
+	/// <summary>
+	/// Minimum number of equal angular steps over an arc so every chord stays within an error of the arc.
+	/// A chord spanning an angle a on a circle of radius r is at most r * (1 - cos(a / 2)) away from it.
+	/// Scaled circles are ellipses, which are bounded by their largest semi-axis
+	/// </summary>
+	/// <param name="arc">Angle of the whole arc in radians</param>
+	/// <param name="radius">Largest radius of the arc after scaling</param>
+	/// <param name="maxError">Maximum distance between a chord and the arc</param>
+	/// <param name="minimum">Smallest number of steps the generator accepts</param>
+	/// <returns>Number of steps, saturated to the range of std::uint32_t</returns>
+	inline std::uint32_t ArcSteps(float arc, float radius, float maxError, std::uint32_t minimum)
+	{
+		if (!(radius > maxError))
+		{
+			return minimum;
+		}
+		const double steps = std::ceil(static_cast<double>(arc) / (2.0 * std::acos(1.0 - static_cast<double>(maxError) / radius)));
+		// Overly small errors saturate, which makes the generator throw std::overflow_error instead of wrapping
+		const double saturated = std::min(steps, static_cast<double>(std::numeric_limits<std::uint32_t>::max()));
+		return std::max(minimum, static_cast<std::uint32_t>(saturated));
+	}
+	/// <summary>
+	/// Rings and segments of a sphere or hemisphere
+	/// </summary>
+	struct SphereTessellation
+	{
+		std::uint32_t rings;
+		std::uint32_t segments;
+	};
+	/// <summary>
+	/// Rings and segments for a sphere or hemisphere within a chordal error.
+	/// The middle of a quad is about the sum of the errors of its edges away from the surface, so each direction gets half of the error.
+	/// Segments go around the y axis and only depend on the x and z scale, rings go over the poles and depend on every axis
+	/// </summary>
+	/// <param name="ringArc">Angle covered by the rings, pi for a sphere and pi / 2 for a hemisphere</param>
+	/// <param name="radius">Radius of the sphere before scaling</param>
+	/// <param name="maxError">Maximum distance to the surface in world units</param>
+	/// <param name="scale">Scale from the generator settings</param>
+	inline SphereTessellation SphereTessellationFor(float ringArc, float radius, ChordalError maxError, const vec3& scale)
+	{
+		const float halfError = 0.5f * maxError.value;
+		return SphereTessellation{
+			ArcSteps(ringArc, radius * MaxScale(scale, true, true, true), halfError, 2),
+			ArcSteps(2.0f * std::numbers::pi_v<float>, radius * MaxScale(scale, true, false, true), halfError, 3),
+		};
+	}
+	/// <summary>
+	/// Smallest number of Icosphere subdivisions within a chordal error.
+	/// Icosphere faces aren't evenly sized, so the error is measured from the generated meshes.
+	/// Each subdivision divides the error by just under 4
+	/// </summary>
+	/// <param name="radius">Radius of the icosphere before scaling</param>
+	/// <param name="maxError">Maximum distance to the surface in world units</param>
+	/// <param name="scale">Scale from the generator settings</param>
+	inline std::uint32_t IcosphereSubdivisionsFor(float radius, ChordalError maxError, const vec3& scale)
+	{
+		// Largest distance between a face and a unit sphere, for each subdivision
+		static constexpr std::array<float, 8> IcosphereFaceErrors = {
+			0.2053456f, 0.0658279f, 0.0177533f, 0.0045286f, 0.0011381f, 0.0002850f, 0.0000715f, 0.0000180f,
+		};
+		const float scaledRadius = radius * MaxScale(scale, true, true, true);
+		std::uint32_t subdivisions = 0;
+		float error = IcosphereFaceErrors[0] * scaledRadius;
+		// Past 31 subdivisions the vertex count overflows anyway
+		while (error > maxError.value && subdivisions < 32)
+		{
+			subdivisions++;
+			error = (subdivisions < IcosphereFaceErrors.size()) ? IcosphereFaceErrors[subdivisions] * scaledRadius : error / 3.9f;
+		}
+		return subdivisions;
+	}
+}
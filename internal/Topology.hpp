@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Mesh.hpp"
+
+#include <vector>
+#include <cstdint>
+
+namespace Construct::internal
+{
+	/// <summary>
+	/// Calls func(i1, i2, i3) for every triangle in an index buffer, regardless of topology.
+	/// Strip triangles are reported with their effective winding (odd triangles are swapped)
+	/// </summary>
+	/// <param name="indices">Index buffer to walk</param>
+	/// <param name="topology">How the index buffer is assembled</param>
+	/// <param name="func">Callback taking the 3 vertex indices of a triangle</param>
+	template <typename IndexType, typename Func>
+	inline void ForEachTriangle(const std::vector<IndexType>& indices, Topology topology, Func&& func)
+	{
+		if (topology == Topology::TriangleList)
+		{
+			for (std::size_t i = 0, size = indices.size(); i + 2 < size; i += 3)
+			{
+				func(indices[i + 0], indices[i + 1], indices[i + 2]);
+			}
+			return;
+		}
+		// Number of indices seen in the current strip
+		std::size_t stripLength = 0;
+		for (std::size_t i = 0, size = indices.size(); i < size; i++)
+		{
+			if (indices[i] == PrimitiveRestart<IndexType>)
+			{
+				stripLength = 0;
+				continue;
+			}
+			stripLength++;
+			if (stripLength < 3)
+			{
+				continue;
+			}
+			// Every second triangle in a strip has its winding reversed
+			if (stripLength % 2 == 1)
+			{
+				func(indices[i - 2], indices[i - 1], indices[i]);
+			}
+			else
+			{
+				func(indices[i - 1], indices[i - 2], indices[i]);
+			}
+		}
+	}
+	/// <summary>
+	/// Counts the number of triangles in an index buffer
+	/// </summary>
+	template <typename IndexType>
+	inline std::size_t TriangleCount(const std::vector<IndexType>& indices, Topology topology)
+	{
+		if (topology == Topology::TriangleList)
+		{
+			return indices.size() / 3;
+		}
+		std::size_t count = 0;
+		ForEachTriangle(indices, topology, [&](IndexType, IndexType, IndexType) { count++; });
+		return count;
+	}
+	/// <summary>
+	/// Expands a triangle strip index buffer into a triangle list, keeping the winding of each triangle
+	/// </summary>
+	template <typename IndexType>
+	inline std::vector<IndexType> ToTriangleList(const std::vector<IndexType>& indices, Topology topology)
+	{
+		if (topology == Topology::TriangleList)
+		{
+			return indices;
+		}
+		std::vector<IndexType> list;
+		list.reserve(3 * TriangleCount(indices, topology));
+		ForEachTriangle(indices, topology, [&](IndexType i1, IndexType i2, IndexType i3) {
+			list.push_back(i1);
+			list.push_back(i2);
+			list.push_back(i3);
+		});
+		return list;
+	}
+}
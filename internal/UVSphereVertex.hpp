@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <numbers>
+#include <cmath>
+
+namespace Construct::internal
+{
+	/// <summary>
+	/// Values shared by every vertex of a UVSphere ring
+	/// </summary>
+	struct UVSphereRing
+	{
+		float latitude;
+		float y;
+		float sinTheta;
+	};
+	/// <summary>
+	/// Calculates the values shared by every vertex of a ring, ring 0 is the north pole
+	/// </summary>
+	inline UVSphereRing UVSphereRingAt(std::uint32_t i, std::uint32_t rings)
+	{
+		float latitude = (float)i / (float)rings;
+		float theta = latitude * std::numbers::pi_v<float>;
+		// sinf(pi) isn't exactly 0, the poles are pinned so their vertices coincide and their zero area triangles are found reliably
+		const bool pole = (i == 0 || i == rings);
+		return UVSphereRing{ latitude, std::cosf(theta) * 0.5f, pole ? 0.0f : std::sinf(theta) };
+	}
+	/// <summary>
+	/// Calculates one vertex of an untransformed UVSphere, shared by the generator and UVSphereView so they match exactly.
+	/// Attributes with a null output are skipped
+	/// </summary>
+	/// <param name="ring">Ring of the vertex from UVSphereRingAt</param>
+	/// <param name="j">Segment of the vertex, 0 to segments inclusive</param>
+	/// <param name="segments">Number of segments</param>
+	/// <param name="position">Output 3 tuple position</param>
+	/// <param name="normal">Output 3 tuple normal, or nullptr</param>
+	/// <param name="textureUV">Output 2 tuple texture coordinate, or nullptr</param>
+	/// <param name="tangent">Output 4 tuple tangent, or nullptr</param>
+	inline void UVSphereVertex(const UVSphereRing& ring, std::uint32_t j, std::uint32_t segments, float* position, float* normal, float* textureUV, float* tangent)
+	{
+		float longitude = (float)j / (float)segments;
+		float phi = -longitude * 2.0f * std::numbers::pi_v<float>;
+		float cosPhi = std::cosf(phi);
+		float sinPhi = std::sinf(phi);
+		position[0] = cosPhi * ring.sinTheta * 0.5f;
+		position[1] = ring.y;
+		position[2] = sinPhi * ring.sinTheta * 0.5f;
+		if (textureUV != nullptr)
+		{
+			textureUV[0] = longitude;
+			textureUV[1] = ring.latitude;
+		}
+		// Normals point straight out from the center
+		if (normal != nullptr)
+		{
+			normal[0] = cosPhi * ring.sinTheta;
+			normal[1] = ring.y * 2.0f;
+			normal[2] = sinPhi * ring.sinTheta;
+		}
+		// U runs against phi and V runs from the north pole down, so the frame is left handed.
+		// The tangent only depends on the longitude so it stays defined at the poles
+		if (tangent != nullptr)
+		{
+			tangent[0] = sinPhi;
+			tangent[1] = 0.0f;
+			tangent[2] = -cosPhi;
+			tangent[3] = -1.0f;
+		}
+	}
+}
@@ -0,0 +1,391 @@
+#pragma once
+
+#include "../internal/Mesh.hpp"
+#include "../internal/Parallel.hpp"
+#include "../internal/Topology.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace Construct
+{
+	/// <summary>
+	/// Node of a BVH, either an interior node with 2 children or a leaf with a range of triangles
+	/// </summary>
+	struct BVHNode
+	{
+		float min[3];
+		float max[3];
+		/// <summary>
+		/// Index of the left child for interior nodes (the right child follows it), or the first triangle for leaves
+		/// </summary>
+		std::uint32_t first;
+		/// <summary>
+		/// Number of triangles in a leaf, 0 for interior nodes
+		/// </summary>
+		std::uint32_t count;
+	};
+	/// <summary>
+	/// Bounding volume hierarchy over the triangles of a mesh, built by BuildBVH.
+	/// Indices are stored in the index type of the mesh, use the BVH alias for 32-bit meshes
+	/// </summary>
+	template <typename IndexType>
+	struct BasicBVH
+	{
+		/// <summary>
+		/// Nodes with the root first
+		/// </summary>
+		std::vector<BVHNode> nodes;
+		/// <summary>
+		/// 3 tuple triangle indices into the mesh vertices, in leaf order
+		/// </summary>
+		std::vector<IndexType> indices;
+		/// <summary>
+		/// Index of each leaf ordered triangle in the mesh (in list order for triangle strips)
+		/// </summary>
+		std::vector<std::uint32_t> triangles;
+	};
+	/// <summary>
+	/// BVH over a mesh with 32-bit indices
+	/// </summary>
+	using BVH = BasicBVH<std::uint32_t>;
+	/// <summary>
+	/// Result of a ray query against a BVH
+	/// </summary>
+	struct RayHit
+	{
+		bool hit = false;
+		/// <summary>
+		/// Distance along the ray direction, in multiples of the direction length
+		/// </summary>
+		float distance = std::numeric_limits<float>::max();
+		/// <summary>
+		/// Index of the hit triangle in the mesh
+		/// </summary>
+		std::uint32_t triangle = 0;
+		/// <summary>
+		/// Barycentric coordinates of the hit, weighting the second and third vertices of the triangle
+		/// </summary>
+		float u = 0.0f, v = 0.0f;
+	};
+	namespace internal
+	{
+		/// <summary>
+		/// Number of bins the surface area heuristic evaluates per split
+		/// </summary>
+		inline constexpr std::uint32_t BVHBinCount = 16;
+		/// <summary>
+		/// Nodes with more triangles than this build their children on separate threads
+		/// </summary>
+		inline constexpr std::uint32_t BVHParallelThreshold = 1 << 14;
+		struct BVHBox
+		{
+			float min[3] = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+			float max[3] = { std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+			inline void Add(const float* point)
+			{
+				for (std::uint32_t k = 0; k < 3; k++)
+				{
+					this->min[k] = std::min(this->min[k], point[k]);
+					this->max[k] = std::max(this->max[k], point[k]);
+				}
+			}
+			inline void Add(const BVHBox& other)
+			{
+				for (std::uint32_t k = 0; k < 3; k++)
+				{
+					this->min[k] = std::min(this->min[k], other.min[k]);
+					this->max[k] = std::max(this->max[k], other.max[k]);
+				}
+			}
+			inline float HalfArea() const
+			{
+				const float dx = this->max[0] - this->min[0], dy = this->max[1] - this->min[1], dz = this->max[2] - this->min[2];
+				return (dx < 0.0f) ? 0.0f : dx * dy + dy * dz + dz * dx;
+			}
+		};
+		/// <summary>
+		/// Shared state while building a BVH, nodes are allocated in pairs from an atomic counter
+		/// so subtrees can be built concurrently into one array
+		/// </summary>
+		struct BVHBuilder
+		{
+			const std::vector<BVHBox>& boxes;
+			const std::vector<float>& centroids;
+			std::vector<std::uint32_t>& order;
+			std::vector<BVHNode>& nodes;
+			std::atomic<std::uint32_t> nodeCount;
+			std::uint32_t maxLeafTriangles;
+			std::atomic<std::int32_t> spareThreads;
+
+			inline void Build(std::uint32_t nodeIndex, std::uint32_t first, std::uint32_t count)
+			{
+				// Bounds of the triangles and of their centroids
+				BVHBox bounds, centroidBounds;
+				for (std::uint32_t i = first; i < first + count; i++)
+				{
+					bounds.Add(this->boxes[this->order[i]]);
+					centroidBounds.Add(&this->centroids[this->order[i] * 3]);
+				}
+				BVHNode& node = this->nodes[nodeIndex];
+				std::copy(bounds.min, bounds.min + 3, node.min);
+				std::copy(bounds.max, bounds.max + 3, node.max);
+				node.first = first;
+				node.count = count;
+				if (count <= this->maxLeafTriangles)
+				{
+					return;
+				}
+				// Find the cheapest binned split over all axes
+				float bestCost = bounds.HalfArea() * static_cast<float>(count);
+				std::uint32_t bestAxis = 3, bestSplit = 0;
+				for (std::uint32_t axis = 0; axis < 3; axis++)
+				{
+					const float extent = centroidBounds.max[axis] - centroidBounds.min[axis];
+					if (extent <= 0.0f)
+					{
+						continue;
+					}
+					const float scale = BVHBinCount / extent;
+					std::array<BVHBox, BVHBinCount> binBoxes;
+					std::array<std::uint32_t, BVHBinCount> binCounts = {};
+					for (std::uint32_t i = first; i < first + count; i++)
+					{
+						const std::uint32_t triangle = this->order[i];
+						const std::uint32_t bin = std::min(BVHBinCount - 1, static_cast<std::uint32_t>((this->centroids[triangle * 3 + axis] - centroidBounds.min[axis]) * scale));
+						binBoxes[bin].Add(this->boxes[triangle]);
+						binCounts[bin]++;
+					}
+					// Sweep from the right to get the cost of every right hand side
+					std::array<float, BVHBinCount> rightCosts;
+					BVHBox rightBox;
+					std::uint32_t rightCount = 0;
+					for (std::uint32_t bin = BVHBinCount - 1; bin > 0; bin--)
+					{
+						rightBox.Add(binBoxes[bin]);
+						rightCount += binCounts[bin];
+						rightCosts[bin] = rightBox.HalfArea() * static_cast<float>(rightCount);
+					}
+					// Then from the left, splitting before each bin
+					BVHBox leftBox;
+					std::uint32_t leftCount = 0;
+					for (std::uint32_t bin = 1; bin < BVHBinCount; bin++)
+					{
+						leftBox.Add(binBoxes[bin - 1]);
+						leftCount += binCounts[bin - 1];
+						const float cost = leftBox.HalfArea() * static_cast<float>(leftCount) + rightCosts[bin];
+						if (leftCount > 0 && leftCount < count && cost < bestCost)
+						{
+							bestCost = cost;
+							bestAxis = axis;
+							bestSplit = bin;
+						}
+					}
+				}
+				// Splitting isn't worth it
+				if (bestAxis == 3)
+				{
+					return;
+				}
+				// Partition triangles around the split
+				const float scale = BVHBinCount / (centroidBounds.max[bestAxis] - centroidBounds.min[bestAxis]);
+				const auto middle = std::partition(this->order.begin() + first, this->order.begin() + first + count, [&](std::uint32_t triangle) {
+					return std::min(BVHBinCount - 1, static_cast<std::uint32_t>((this->centroids[triangle * 3 + bestAxis] - centroidBounds.min[bestAxis]) * scale)) < bestSplit;
+				});
+				const std::uint32_t leftCount = static_cast<std::uint32_t>(middle - this->order.begin()) - first;
+				const std::uint32_t children = this->nodeCount.fetch_add(2);
+				node.first = children;
+				node.count = 0;
+				// Build large subtrees concurrently while there are threads to spare
+				if (count > BVHParallelThreshold && this->spareThreads.fetch_sub(1) > 0)
+				{
+					std::thread left([this, children, first, leftCount]() { this->Build(children, first, leftCount); });
+					this->Build(children + 1, first + leftCount, count - leftCount);
+					left.join();
+					return;
+				}
+				this->Build(children, first, leftCount);
+				this->Build(children + 1, first + leftCount, count - leftCount);
+			}
+		};
+	}
+	/// <summary>
+	/// Builds a BVH over the triangles of a mesh using a binned surface area heuristic.
+	/// Large subtrees are built on separate threads.
+	/// Throws std::overflow_error if the mesh has too many triangles to number with 32-bit nodes
+	/// </summary>
+	/// <param name="mesh">Mesh to build the BVH over, triangle strips are expanded to triangle lists</param>
+	/// <param name="maxLeafTriangles">Nodes with at most this many triangles become leaves</param>
+	/// <returns>BVH of the mesh</returns>
+	template <typename IndexType>
+	inline BasicBVH<IndexType> BuildBVH(const BasicMesh<IndexType>& mesh, std::uint32_t maxLeafTriangles = 4)
+	{
+		BasicBVH<IndexType> bvh;
+		const std::vector<IndexType> indices = internal::ToTriangleList(mesh.indices, mesh.topology);
+		// Nodes are numbered with 32 bits and there can be up to twice as many nodes as triangles
+		if (indices.size() / 3 > std::numeric_limits<std::uint32_t>::max() / 2)
+		{
+			throw std::overflow_error("Construct: too many triangles to build a BVH over");
+		}
+		const std::uint32_t triangleCount = static_cast<std::uint32_t>(indices.size() / 3);
+		if (triangleCount == 0)
+		{
+			return bvh;
+		}
+		// Triangle bounds and centroids
+		std::vector<internal::BVHBox> boxes(triangleCount);
+		std::vector<float> centroids(3 * static_cast<std::size_t>(triangleCount));
+		internal::ParallelFor(triangleCount, 1 << 14, [&](std::size_t begin, std::size_t end, std::uint32_t) {
+			for (std::size_t i = begin; i < end; i++)
+			{
+				for (std::uint32_t j = 0; j < 3; j++)
+				{
+					boxes[i].Add(&mesh.vertices[static_cast<std::size_t>(indices[i * 3 + j]) * 3]);
+				}
+				for (std::uint32_t k = 0; k < 3; k++)
+				{
+					centroids[i * 3 + k] = 0.5f * (boxes[i].min[k] + boxes[i].max[k]);
+				}
+			}
+		});
+		bvh.triangles.resize(triangleCount);
+		for (std::uint32_t i = 0; i < triangleCount; i++)
+		{
+			bvh.triangles[i] = i;
+		}
+		// A binary tree never has more than 2n - 1 nodes
+		bvh.nodes.resize(2 * static_cast<std::size_t>(triangleCount) - 1);
+		internal::BVHBuilder builder{ boxes, centroids, bvh.triangles, bvh.nodes, 1, std::max(1u, maxLeafTriangles), static_cast<std::int32_t>(internal::HardwareThreads()) - 1 };
+		builder.Build(0, 0, triangleCount);
+		bvh.nodes.resize(builder.nodeCount.load());
+		// Store triangles in leaf order so leaves are contiguous in memory
+		bvh.indices.resize(indices.size());
+		for (std::uint32_t i = 0; i < triangleCount; i++)
+		{
+			for (std::uint32_t j = 0; j < 3; j++)
+			{
+				bvh.indices[static_cast<std::size_t>(i) * 3 + j] = indices[static_cast<std::size_t>(bvh.triangles[i]) * 3 + j];
+			}
+		}
+		return bvh;
+	}
+	/// <summary>
+	/// Finds the closest triangle hit by a ray, both sides of triangles are hit
+	/// </summary>
+	/// <param name="bvh">BVH built from the mesh</param>
+	/// <param name="mesh">Mesh the BVH was built from</param>
+	/// <param name="origin">Ray origin</param>
+	/// <param name="direction">Ray direction, doesn't need to be normalised</param>
+	/// <param name="maxDistance">Hits further than this along the ray are ignored</param>
+	/// <returns>Closest hit, if any</returns>
+	template <typename IndexType>
+	inline RayHit Raycast(const BasicBVH<IndexType>& bvh, const BasicMesh<IndexType>& mesh, const vec3& origin, const vec3& direction, float maxDistance = std::numeric_limits<float>::max())
+	{
+		RayHit result;
+		result.distance = maxDistance;
+		if (bvh.nodes.empty())
+		{
+			return result;
+		}
+		const float o[3] = { origin.x, origin.y, origin.z };
+		const float d[3] = { direction.x, direction.y, direction.z };
+		const float inverse[3] = { 1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z };
+		// Relative to the size of the triangle and the direction so tiny meshes and unnormalised directions aren't rejected
+		const float directionLengthSquared = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+		// Slab test, returns the entry distance or infinity on a miss
+		auto intersectNode = [&](const BVHNode& node) {
+			float tMin = 0.0f, tMax = result.distance;
+			for (std::uint32_t k = 0; k < 3; k++)
+			{
+				// A ray parallel to the slab would give 0 * infinity = NaN at its planes, it is either always or never between them
+				if (d[k] == 0.0f)
+				{
+					if (o[k] < node.min[k] || o[k] > node.max[k])
+					{
+						return std::numeric_limits<float>::infinity();
+					}
+					continue;
+				}
+				float t1 = (node.min[k] - o[k]) * inverse[k];
+				float t2 = (node.max[k] - o[k]) * inverse[k];
+				if (t1 > t2)
+				{
+					std::swap(t1, t2);
+				}
+				tMin = std::max(tMin, t1);
+				tMax = std::min(tMax, t2);
+			}
+			return (tMin <= tMax) ? tMin : std::numeric_limits<float>::infinity();
+		};
+		std::vector<std::uint32_t> stack;
+		stack.reserve(64);
+		stack.push_back(0);
+		while (!stack.empty())
+		{
+			const BVHNode& node = bvh.nodes[stack.back()];
+			stack.pop_back();
+			if (intersectNode(node) == std::numeric_limits<float>::infinity())
+			{
+				continue;
+			}
+			if (node.count == 0)
+			{
+				// Visit the closer child first
+				const float leftDistance = intersectNode(bvh.nodes[node.first]);
+				const float rightDistance = intersectNode(bvh.nodes[node.first + 1]);
+				const bool leftFirst = leftDistance <= rightDistance;
+				stack.push_back(leftFirst ? node.first + 1 : node.first);
+				stack.push_back(leftFirst ? node.first : node.first + 1);
+				continue;
+			}
+			// Moller-Trumbore intersection against every triangle in the leaf
+			for (std::uint32_t i = node.first; i < node.first + node.count; i++)
+			{
+				const std::size_t triangle = static_cast<std::size_t>(i) * 3;
+				const float* v0 = &mesh.vertices[3 * static_cast<std::size_t>(bvh.indices[triangle + 0])];
+				const float* v1 = &mesh.vertices[3 * static_cast<std::size_t>(bvh.indices[triangle + 1])];
+				const float* v2 = &mesh.vertices[3 * static_cast<std::size_t>(bvh.indices[triangle + 2])];
+				const float e1[3] = { v1[0] - v0[0], v1[1] - v0[1], v1[2] - v0[2] };
+				const float e2[3] = { v2[0] - v0[0], v2[1] - v0[1], v2[2] - v0[2] };
+				const float p[3] = { d[1] * e2[2] - d[2] * e2[1], d[2] * e2[0] - d[0] * e2[2], d[0] * e2[1] - d[1] * e2[0] };
+				const float determinant = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+				const float e1LengthSquared = e1[0] * e1[0] + e1[1] * e1[1] + e1[2] * e1[2];
+				const float e2LengthSquared = e2[0] * e2[0] + e2[1] * e2[1] + e2[2] * e2[2];
+				if (determinant * determinant <= 1e-14f * directionLengthSquared * e1LengthSquared * e2LengthSquared)
+				{
+					continue;
+				}
+				const float inverseDeterminant = 1.0f / determinant;
+				const float s[3] = { o[0] - v0[0], o[1] - v0[1], o[2] - v0[2] };
+				const float u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * inverseDeterminant;
+				if (u < 0.0f || u > 1.0f)
+				{
+					continue;
+				}
+				const float q[3] = { s[1] * e1[2] - s[2] * e1[1], s[2] * e1[0] - s[0] * e1[2], s[0] * e1[1] - s[1] * e1[0] };
+				const float v = (d[0] * q[0] + d[1] * q[1] + d[2] * q[2]) * inverseDeterminant;
+				if (v < 0.0f || u + v > 1.0f)
+				{
+					continue;
+				}
+				const float t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * inverseDeterminant;
+				if (t >= 0.0f && t < result.distance)
+				{
+					result.hit = true;
+					result.distance = t;
+					result.triangle = bvh.triangles[i];
+					result.u = u;
+					result.v = v;
+				}
+			}
+		}
+		return result;
+	}
+}
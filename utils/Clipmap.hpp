@@ -0,0 +1,344 @@
+#pragma once
+
+#include "../internal/GeneratorContext.hpp"
+#include "../internal/GeneratorSetting.hpp"
+#include "../internal/GridIndices.hpp"
+#include "../internal/Mesh.hpp"
+#include "../internal/ProcessMesh.hpp"
+#include "./Instancing.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace Construct
+{
+	/// <summary>
+	/// Geometry clipmap for terrain, nested square levels around a viewer where each level has twice the spacing of the one inside it.
+	/// Every piece is one small mesh in grid units, placed by its instances, so the clipmap is a handful of buffers however many levels it has.
+	/// Instances are grouped by level from the finest, so the instances of one level are a contiguous range
+	/// </summary>
+	template <typename IndexType>
+	struct BasicClipmap
+	{
+		/// <summary>
+		/// Quads along each side of a tile
+		/// </summary>
+		std::uint32_t tileResolution = 0;
+		/// <summary>
+		/// Number of levels, level 0 is the finest
+		/// </summary>
+		std::uint32_t levels = 0;
+		/// <summary>
+		/// Transform applied on top of every instance, one grid unit of level 0 is one unit before it
+		/// </summary>
+		GeneratorSetting settings;
+		/// <summary>
+		/// Square of tiles, 16 on level 0 and the 12 around the hole of every other level
+		/// </summary>
+		BasicInstancedMesh<IndexType> tile;
+		/// <summary>
+		/// The four 1 quad wide arms between the tiles of a ring, one per level except level 0
+		/// </summary>
+		BasicInstancedMesh<IndexType> filler;
+		/// <summary>
+		/// The full 1 quad wide cross between the tiles of level 0, one instance
+		/// </summary>
+		BasicInstancedMesh<IndexType> cross;
+		/// <summary>
+		/// L shaped strip along two sides of a level that fills the rest of the next level's hole, rotated towards the viewer.
+		/// One per level except the last
+		/// </summary>
+		BasicInstancedMesh<IndexType> trim;
+		/// <summary>
+		/// Zero area triangles around the outside of a level, between every second vertex of its border.
+		/// Once the vertex shader moves the odd vertices onto the coarser level they fill the cracks at the T-junctions.
+		/// One per level except the last
+		/// </summary>
+		BasicInstancedMesh<IndexType> seam;
+	};
+	/// <summary>
+	/// Clipmap with 32-bit indices
+	/// </summary>
+	using Clipmap = BasicClipmap<std::uint32_t>;
+	namespace internal
+	{
+		/// <summary>
+		/// Rectangle of quads in grid units, the pieces of a clipmap are made of them
+		/// </summary>
+		struct ClipmapRect
+		{
+			std::int32_t x, y;
+			std::uint32_t width, height;
+		};
+		/// <summary>
+		/// Quads along the side of a level with its trim, which is also the side of the next level's hole
+		/// </summary>
+		inline std::uint32_t ClipmapLevelSide(std::uint32_t tileResolution)
+		{
+			return 4 * tileResolution + 2;
+		}
+		/// <summary>
+		/// Writes one vertex of a clipmap piece, the piece lies on the z = 0 plane facing +z like Plane.
+		/// Texture UVs are the grid coordinates, attributes with a null output are skipped
+		/// </summary>
+		inline void ClipmapVertex(float x, float y, float* position, float* normal, float* textureUV, float* tangent)
+		{
+			position[0] = x;
+			position[1] = y;
+			position[2] = 0.0f;
+			if (normal != nullptr)
+			{
+				normal[0] = 0.0f;
+				normal[1] = 0.0f;
+				normal[2] = 1.0f;
+			}
+			if (textureUV != nullptr)
+			{
+				textureUV[0] = x;
+				textureUV[1] = y;
+			}
+			if (tangent != nullptr)
+			{
+				tangent[0] = 1.0f;
+				tangent[1] = 0.0f;
+				tangent[2] = 0.0f;
+				tangent[3] = 1.0f;
+			}
+		}
+		/// <summary>
+		/// Builds a clipmap piece out of grids of quads.
+		/// Rectangles keep their own vertices, positions are whole grid units so shared borders match exactly
+		/// </summary>
+		template <typename IndexType, std::size_t Count>
+		inline BasicMesh<IndexType> ClipmapGridPiece(GeneratorContext& context, const std::array<ClipmapRect, Count>& rects, const GeneratorSetting& settings)
+		{
+			std::uint64_t vertexCount = 0, indexCount = 0;
+			for (const ClipmapRect& rect : rects)
+			{
+				vertexCount = CheckedAdd(vertexCount, CheckedMultiply(static_cast<std::uint64_t>(rect.width) + 1, static_cast<std::uint64_t>(rect.height) + 1));
+				indexCount = CheckedAdd(indexCount, GridIndexCount(rect.height, rect.width, settings.topology));
+			}
+			CheckedVertexCount<IndexType>(vertexCount);
+			CheckedIndexCount<IndexType>(indexCount);
+			const bool hasNormals = settings.HasAttribute(VertexAttribute::Normal);
+			const bool hasTextureUVs = settings.HasAttribute(VertexAttribute::TextureUV);
+			const bool hasTangents = settings.HasAttribute(VertexAttribute::Tangent);
+			BasicMesh<IndexType> mesh = context.NewMesh<IndexType>(3 * vertexCount, indexCount, hasNormals ? 3 * vertexCount : 0, hasTextureUVs ? 2 * vertexCount : 0, hasTangents ? 4 * vertexCount : 0);
+			mesh.topology = settings.topology;
+			// Strips are wound here as ProcessMesh only flips triangle lists
+			const bool flip = settings.topology == Topology::TriangleStrip && settings.windingOrder == WindingOrder::CW;
+			std::size_t vertex = 0;
+			IndexType* output = mesh.indices.data();
+			for (const ClipmapRect& rect : rects)
+			{
+				const IndexType baseVertex = static_cast<IndexType>(vertex);
+				for (std::uint32_t i = 0; i <= rect.height; i++)
+				{
+					for (std::uint32_t j = 0; j <= rect.width; j++)
+					{
+						const float x = static_cast<float>(rect.x + static_cast<std::int64_t>(j));
+						const float y = static_cast<float>(rect.y + static_cast<std::int64_t>(i));
+						ClipmapVertex(x, y, &mesh.vertices[3 * vertex],
+							hasNormals ? &mesh.normals[3 * vertex] : nullptr,
+							hasTextureUVs ? &mesh.textureUVs[2 * vertex] : nullptr,
+							hasTangents ? &mesh.tangents[4 * vertex] : nullptr);
+						mesh.bounds.Add(x, y, 0.0f);
+						vertex++;
+					}
+				}
+				output = GridIndices<IndexType>(output, baseVertex, rect.height, rect.width, flip, settings.topology);
+			}
+			ProcessMesh(mesh, settings);
+			return mesh;
+		}
+		/// <summary>
+		/// Builds the seam piece, a ring of vertices around a level with a zero area triangle over every second vertex.
+		/// Strips restart after every triangle
+		/// </summary>
+		template <typename IndexType>
+		inline BasicMesh<IndexType> ClipmapSeam(GeneratorContext& context, std::uint32_t tileResolution, const GeneratorSetting& settings)
+		{
+			const std::uint64_t side = ClipmapLevelSide(tileResolution);
+			const std::size_t vertexCount = CheckedVertexCount<IndexType>(CheckedMultiply(4, side));
+			const std::size_t triangleCount = vertexCount / 2;
+			const bool strip = settings.topology == Topology::TriangleStrip;
+			const std::size_t indexCount = CheckedIndexCount<IndexType>(CheckedMultiply(triangleCount, strip ? 4 : 3));
+			const bool hasNormals = settings.HasAttribute(VertexAttribute::Normal);
+			const bool hasTextureUVs = settings.HasAttribute(VertexAttribute::TextureUV);
+			const bool hasTangents = settings.HasAttribute(VertexAttribute::Tangent);
+			BasicMesh<IndexType> mesh = context.NewMesh<IndexType>(3 * vertexCount, indexCount, hasNormals ? 3 * vertexCount : 0, hasTextureUVs ? 2 * vertexCount : 0, hasTangents ? 4 * vertexCount : 0);
+			mesh.topology = settings.topology;
+			// Counter clockwise around the square from (0, 0), the corners land on even vertices as the side is even
+			for (std::size_t v = 0; v < vertexCount; v++)
+			{
+				const float along = static_cast<float>(v % side), end = static_cast<float>(side);
+				const std::array<float, 2> corners[4] = { { along, 0.0f }, { end, along }, { end - along, end }, { 0.0f, end - along } };
+				const std::array<float, 2>& point = corners[v / side];
+				ClipmapVertex(point[0], point[1], &mesh.vertices[3 * v],
+					hasNormals ? &mesh.normals[3 * v] : nullptr,
+					hasTextureUVs ? &mesh.textureUVs[2 * v] : nullptr,
+					hasTangents ? &mesh.tangents[4 * v] : nullptr);
+				mesh.bounds.Add(point[0], point[1], 0.0f);
+			}
+			const bool flip = strip && settings.windingOrder == WindingOrder::CW;
+			IndexType* output = mesh.indices.data();
+			for (std::size_t t = 0; t < triangleCount; t++)
+			{
+				const IndexType first = static_cast<IndexType>(2 * t), middle = static_cast<IndexType>(2 * t + 1), last = static_cast<IndexType>((2 * t + 2) % vertexCount);
+				*output++ = flip ? last : first;
+				*output++ = middle;
+				*output++ = flip ? first : last;
+				if (strip)
+				{
+					*output++ = PrimitiveRestart<IndexType>;
+				}
+			}
+			ProcessMesh(mesh, settings);
+			return mesh;
+		}
+		/// <summary>
+		/// Places a piece, the piece is turned by quarter turns around (pivot, pivot), scaled, moved to (x, y), then transformed by the clipmap
+		/// </summary>
+		inline InstanceTransform ClipmapTransform(const InstanceTransform& clipmap, float scale, std::uint32_t quarterTurns, float pivot, float x, float y)
+		{
+			static constexpr float Cosines[4] = { 1.0f, 0.0f, -1.0f, 0.0f };
+			static constexpr float Sines[4] = { 0.0f, 1.0f, 0.0f, -1.0f };
+			const float c = Cosines[quarterTurns & 3] * scale, s = Sines[quarterTurns & 3] * scale;
+			// Rotating about the pivot is the same as rotating about the origin and moving by pivot - R * pivot
+			const float tx = x + scale * pivot - (c * pivot - s * pivot);
+			const float ty = y + scale * pivot - (s * pivot + c * pivot);
+			const std::array<float, 12> local = {
+				c, -s, 0.0f, tx,
+				s, c, 0.0f, ty,
+				0.0f, 0.0f, 1.0f, 0.0f,
+			};
+			const std::array<float, 12>& m = clipmap.matrix;
+			InstanceTransform result;
+			for (std::size_t row = 0; row < 3; row++)
+			{
+				for (std::size_t column = 0; column < 4; column++)
+				{
+					result.matrix[4 * row + column] = m[4 * row + 0] * local[column] + m[4 * row + 1] * local[4 + column] + m[4 * row + 2] * local[8 + column] + ((column == 3) ? m[4 * row + 3] : 0.0f);
+				}
+			}
+			return result;
+		}
+	}
+	/// <summary>
+	/// Moves every level of a clipmap to a viewer, only the instances change so nothing is regenerated.
+	/// Each level snaps to its own grid spacing and turns its trim towards the viewer, so vertices never swim
+	/// </summary>
+	/// <param name="clipmap">Clipmap to move</param>
+	/// <param name="viewer">Position of the viewer after the clipmap's settings transform</param>
+	template <typename IndexType>
+	inline void UpdateClipmap(BasicClipmap<IndexType>& clipmap, const vec3& viewer)
+	{
+		// Undo the settings transform to find the viewer in grid units
+		const GeneratorSetting& settings = clipmap.settings;
+		const quat& q = settings.rotation;
+		const vec3 local = quat(-q.x, -q.y, -q.z, q.w) * vec3(viewer.x - settings.offset.x, viewer.y - settings.offset.y, viewer.z - settings.offset.z);
+		const float viewerX = local.x / settings.scale.x, viewerY = local.y / settings.scale.y;
+		const InstanceTransform transform = InstanceTransform::FromSetting(settings);
+		const std::uint32_t t = clipmap.tileResolution;
+		const float resolution = static_cast<float>(t), trimPivot = 0.5f * static_cast<float>(internal::ClipmapLevelSide(t));
+		clipmap.tile.instances.clear();
+		clipmap.filler.instances.clear();
+		clipmap.cross.instances.clear();
+		clipmap.trim.instances.clear();
+		clipmap.seam.instances.clear();
+		for (std::uint32_t level = 0; level < clipmap.levels; level++)
+		{
+			const float scale = std::ldexp(1.0f, static_cast<int>(level));
+			const float snappedX = std::floor(viewerX / scale) * scale, snappedY = std::floor(viewerY / scale) * scale;
+			// 4x4 tiles with a 1 quad gap through the middle, every level but the finest has the middle 2x2 cut out
+			const float baseX = snappedX - 2.0f * resolution * scale, baseY = snappedY - 2.0f * resolution * scale;
+			for (std::uint32_t y = 0; y < 4; y++)
+			{
+				for (std::uint32_t x = 0; x < 4; x++)
+				{
+					if (level != 0 && (x == 1 || x == 2) && (y == 1 || y == 2))
+					{
+						continue;
+					}
+					const float tileX = baseX + (static_cast<float>(x * t) + ((x >= 2) ? 1.0f : 0.0f)) * scale;
+					const float tileY = baseY + (static_cast<float>(y * t) + ((y >= 2) ? 1.0f : 0.0f)) * scale;
+					clipmap.tile.instances.push_back(internal::ClipmapTransform(transform, scale, 0, 0.0f, tileX, tileY));
+				}
+			}
+			BasicInstancedMesh<IndexType>& gap = (level == 0) ? clipmap.cross : clipmap.filler;
+			gap.instances.push_back(internal::ClipmapTransform(transform, scale, 0, 0.0f, snappedX, snappedY));
+			if (level + 1 == clipmap.levels)
+			{
+				break;
+			}
+			// The next level's hole is one quad of this level wider than this level, the trim goes on whichever side the snapping left open
+			const float nextScale = 2.0f * scale;
+			const float nextX = std::floor(viewerX / nextScale) * nextScale, nextY = std::floor(viewerY / nextScale) * nextScale;
+			const float holeX = nextX - 2.0f * resolution * scale, holeY = nextY - 2.0f * resolution * scale;
+			const bool highX = snappedX == nextX, highY = snappedY == nextY;
+			// Quarter turns that move the corner of the L from (low, low) to the open corner
+			const std::uint32_t quarterTurns = highX ? (highY ? 2 : 1) : (highY ? 3 : 0);
+			clipmap.trim.instances.push_back(internal::ClipmapTransform(transform, scale, quarterTurns, trimPivot, holeX, holeY));
+			clipmap.seam.instances.push_back(internal::ClipmapTransform(transform, scale, 0, 0.0f, holeX, holeY));
+		}
+	}
+	/// <summary>
+	/// Generates every piece of a geometry clipmap once and places the levels around the origin of the settings.
+	/// One grid unit of the finest level is one unit before the settings transform, each level doubles it.
+	/// Call UpdateClipmap as the viewer moves, the meshes can be uploaded once or packed together with PackMultiDraw.
+	/// Throws std::invalid_argument if tileResolution or levels is 0
+	/// </summary>
+	/// <param name="context">Context whose buffers are reused, see GeneratorContext</param>
+	/// <param name="tileResolution">Quads along each side of a tile, a level is 4 * tileResolution + 2 quads across</param>
+	/// <param name="levels">Number of levels</param>
+	/// <param name="settings">Settings of the pieces, the transform is applied through the instances</param>
+	/// <returns>Pieces of the clipmap with the instances of every level</returns>
+	template <typename IndexType = std::uint32_t>
+	inline BasicClipmap<IndexType> GenerateClipmap(GeneratorContext& context, std::uint32_t tileResolution, std::uint32_t levels, const GeneratorSetting& settings = GeneratorSetting())
+	{
+		if (tileResolution == 0 || levels == 0)
+		{
+			throw std::invalid_argument("Construct: a clipmap needs at least one level and one quad per tile");
+		}
+		const GeneratorSetting canonical = CanonicalSetting(settings);
+		const std::int32_t t = static_cast<std::int32_t>(tileResolution);
+		const std::uint32_t side = internal::ClipmapLevelSide(tileResolution);
+		BasicClipmap<IndexType> clipmap;
+		clipmap.tileResolution = tileResolution;
+		clipmap.levels = levels;
+		clipmap.settings = settings;
+		clipmap.tile.mesh = internal::ClipmapGridPiece<IndexType>(context, std::array<internal::ClipmapRect, 1>{ { { 0, 0, tileResolution, tileResolution } } }, canonical);
+		// Arms of the gap through the ring, relative to the quad at the viewer
+		clipmap.filler.mesh = internal::ClipmapGridPiece<IndexType>(context, std::array<internal::ClipmapRect, 4>{ {
+			{ 0, -2 * t, 1, tileResolution }, { 0, t + 1, 1, tileResolution },
+			{ -2 * t, 0, tileResolution, 1 }, { t + 1, 0, tileResolution, 1 },
+		} }, canonical);
+		clipmap.cross.mesh = internal::ClipmapGridPiece<IndexType>(context, std::array<internal::ClipmapRect, 3>{ {
+			{ 0, -2 * t, 1, 4 * tileResolution + 1 },
+			{ -2 * t, 0, 2 * tileResolution, 1 }, { 1, 0, 2 * tileResolution, 1 },
+		} }, canonical);
+		// Along the low x and low y sides of the next level's hole
+		clipmap.trim.mesh = internal::ClipmapGridPiece<IndexType>(context, std::array<internal::ClipmapRect, 2>{ {
+			{ 0, 0, 1, side }, { 1, 0, side - 1, 1 },
+		} }, canonical);
+		clipmap.seam.mesh = internal::ClipmapSeam<IndexType>(context, tileResolution, canonical);
+		UpdateClipmap(clipmap, settings.offset);
+		return clipmap;
+	}
+	/// <summary>
+	/// Generates every piece of a geometry clipmap once and places the levels around the origin of the settings, using a temporary context
+	/// </summary>
+	/// <param name="tileResolution">Quads along each side of a tile, a level is 4 * tileResolution + 2 quads across</param>
+	/// <param name="levels">Number of levels</param>
+	/// <param name="settings">Settings of the pieces, the transform is applied through the instances</param>
+	/// <returns>Pieces of the clipmap with the instances of every level</returns>
+	template <typename IndexType = std::uint32_t>
+	inline BasicClipmap<IndexType> GenerateClipmap(std::uint32_t tileResolution, std::uint32_t levels, const GeneratorSetting& settings = GeneratorSetting())
+	{
+		GeneratorContext context;
+		return GenerateClipmap<IndexType>(context, tileResolution, levels, settings);
+	}
+}
@@ -0,0 +1,707 @@
+#pragma once
+
+#include "../internal/GeneratorSetting.hpp"
+#include "../internal/Mesh.hpp"
+#include "../internal/types.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace Construct
+{
+	/// <summary>
+	/// Shape of an AnalyticCollider
+	/// </summary>
+	enum class ColliderShape : std::uint8_t { Sphere, Capsule, Box, Cylinder };
+	/// <summary>
+	/// Exact collision shape of a generated primitive, after the transform of its GeneratorSetting.
+	/// Capsules and cylinders run along the local y axis
+	/// </summary>
+	struct AnalyticCollider
+	{
+		ColliderShape shape = ColliderShape::Sphere;
+		/// <summary>
+		/// Center of the shape
+		/// </summary>
+		vec3 center;
+		/// <summary>
+		/// Rotation of the local axes
+		/// </summary>
+		quat rotation;
+		/// <summary>
+		/// Half size along each local axis for boxes.
+		/// x is the radius of spheres, capsules and cylinders, y is half the length of the capsule segment or cylinder
+		/// </summary>
+		vec3 halfExtents;
+	};
+	/// <summary>
+	/// Convex hull of a mesh, built by BuildConvexHull.
+	/// Every buffer is tightly packed, planes and vertices can be streamed straight into a narrow phase
+	/// </summary>
+	struct ConvexHull
+	{
+		/// <summary>
+		/// float list of 3 tuple hull vertices (X, Y, Z)
+		/// </summary>
+		std::vector<float> vertices;
+		/// <summary>
+		/// float list of 4 tuple face planes (NX, NY, NZ, D) with unit normals pointing out, points inside have dot(N, p) &lt;= D.
+		/// Coplanar triangles share one plane
+		/// </summary>
+		std::vector<float> planes;
+		/// <summary>
+		/// 3 tuple triangles into vertices, wound CCW seen from outside
+		/// </summary>
+		std::vector<std::uint8_t> triangles;
+		/// <summary>
+		/// How far the mesh sticks out of the hull, the largest distance of a left out point in front of any hull plane.
+		/// 0 unless the hull was cut short by maxVertices
+		/// </summary>
+		float error = 0.0f;
+	};
+	/// <summary>
+	/// Discrete oriented polytope, the slabs of a mesh along a fixed set of k / 2 directions, built by BuildKDop
+	/// </summary>
+	struct KDop
+	{
+		/// <summary>
+		/// Number of planes, 6, 14, 18 or 26
+		/// </summary>
+		std::uint32_t k = 0;
+		/// <summary>
+		/// Minimum then maximum along each direction of KDopDirection, only the first k are used
+		/// </summary>
+		std::array<float, 26> extents{};
+	};
+	namespace internal
+	{
+		/// <summary>
+		/// Unnormalised k-DOP directions, the 3 axes then the 6 edge diagonals then the 4 corner diagonals
+		/// </summary>
+		inline constexpr float KDopAxes[13][3] = {
+			{ 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f },
+			{ 1.0f, 1.0f, 0.0f }, { 1.0f, -1.0f, 0.0f }, { 1.0f, 0.0f, 1.0f }, { 1.0f, 0.0f, -1.0f }, { 0.0f, 1.0f, 1.0f }, { 0.0f, 1.0f, -1.0f },
+			{ 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f, -1.0f }, { 1.0f, -1.0f, 1.0f }, { -1.0f, 1.0f, 1.0f },
+		};
+		/// <summary>
+		/// Whether the absolute scale is the same along the given axes
+		/// </summary>
+		inline bool UniformScale(const vec3& scale, bool x, bool y, bool z)
+		{
+			const float sx = std::fabs(scale.x), sy = std::fabs(scale.y), sz = std::fabs(scale.z);
+			const float reference = x ? sx : sy;
+			return (!x || sx == reference) && (!y || sy == reference) && (!z || sz == reference);
+		}
+		/// <summary>
+		/// Collider of a primitive centered on the origin before transforms
+		/// </summary>
+		inline AnalyticCollider TransformedCollider(ColliderShape shape, const vec3& halfExtents, const GeneratorSetting& settings)
+		{
+			AnalyticCollider collider;
+			collider.shape = shape;
+			collider.center = settings.offset;
+			collider.rotation = settings.rotation;
+			collider.halfExtents = halfExtents;
+			return collider;
+		}
+		/// <summary>
+		/// Incremental 3D quickhull over a point cloud, adding the furthest outside point first so stopping early leaves the best hull for its size
+		/// </summary>
+		class QuickHull
+		{
+		public:
+			inline QuickHull(const float* points, std::size_t count) : points(points), count(count) {}
+			/// <summary>
+			/// Builds the hull, returns false if the points don't span a volume
+			/// </summary>
+			inline bool Build(std::size_t maxVertices)
+			{
+				this->epsilon = this->Epsilon();
+				std::uint32_t simplex[4];
+				if (!this->Simplex(simplex))
+				{
+					return false;
+				}
+				// Orient the first 3 vertices so the fourth is behind them
+				if (this->PlaneDistance(simplex[0], simplex[1], simplex[2], simplex[3]) > 0.0f)
+				{
+					std::swap(simplex[1], simplex[2]);
+				}
+				const std::uint32_t a = simplex[0], b = simplex[1], c = simplex[2], d = simplex[3];
+				const std::uint32_t first[4] = { this->AddFace(a, b, c), this->AddFace(a, d, b), this->AddFace(b, d, c), this->AddFace(c, d, a) };
+				std::vector<std::uint32_t> candidates;
+				candidates.reserve(this->count);
+				for (std::uint32_t p = 0; p < this->count; p++)
+				{
+					if (p != a && p != b && p != c && p != d)
+					{
+						candidates.push_back(p);
+					}
+				}
+				this->Assign(candidates, first, 4);
+				std::vector<std::uint32_t> visible, horizon, created, orphans;
+				while (this->vertexFaces.size() < maxVertices)
+				{
+					// Greedy, the face with the furthest point gets extended first
+					std::uint32_t face = NoFace;
+					float furthest = this->epsilon;
+					for (std::uint32_t f = 0; f < this->faces.size(); f++)
+					{
+						if (this->faces[f].alive && !this->faces[f].outside.empty() && this->faces[f].furthestDistance > furthest)
+						{
+							face = f;
+							furthest = this->faces[f].furthestDistance;
+						}
+					}
+					if (face == NoFace)
+					{
+						break;
+					}
+					const std::uint32_t eye = this->faces[face].furthest;
+					// Flood the faces the eye sees, the edges where that stops form the horizon
+					visible.assign(1, face);
+					this->faces[face].visited = true;
+					horizon.clear();
+					for (std::size_t i = 0; i < visible.size(); i++)
+					{
+						const Face& current = this->faces[visible[i]];
+						for (std::uint32_t e = 0; e < 3; e++)
+						{
+							const std::uint32_t from = current.v[e], to = current.v[(e + 1) % 3];
+							const std::uint32_t neighbour = this->edges.at(EdgeKey(to, from));
+							Face& other = this->faces[neighbour];
+							if (other.visited)
+							{
+								continue;
+							}
+							if (this->Distance(other, eye) > this->epsilon)
+							{
+								other.visited = true;
+								visible.push_back(neighbour);
+							}
+							else
+							{
+								horizon.push_back(from);
+								horizon.push_back(to);
+							}
+						}
+					}
+					// Visible faces are removed before the cone is added so their edges can be reused
+					orphans.clear();
+					for (std::uint32_t f : visible)
+					{
+						Face& removed = this->faces[f];
+						for (std::uint32_t p : removed.outside)
+						{
+							if (p != eye)
+							{
+								orphans.push_back(p);
+							}
+						}
+						this->RemoveFace(f);
+					}
+					created.clear();
+					for (std::size_t i = 0; i < horizon.size(); i += 2)
+					{
+						created.push_back(this->AddFace(horizon[i], horizon[i + 1], eye));
+					}
+					this->Assign(orphans, created.data(), created.size());
+				}
+				// Only points still outside a face can be outside the hull, but they can stick out further past a face they weren't assigned to
+				this->error = 0.0f;
+				for (const Face& face : this->faces)
+				{
+					if (!face.alive)
+					{
+						continue;
+					}
+					for (std::uint32_t p : face.outside)
+					{
+						for (const Face& other : this->faces)
+						{
+							if (other.alive)
+							{
+								this->error = std::max(this->error, this->Distance(other, p));
+							}
+						}
+					}
+				}
+				return true;
+			}
+			/// <summary>
+			/// Normal of the plane through the starting triangle, the plane flat points lie in when Build fails
+			/// </summary>
+			inline const float* PlaneNormal() const
+			{
+				return this->planeNormal;
+			}
+			/// <summary>
+			/// Packs the built hull
+			/// </summary>
+			inline ConvexHull Output() const
+			{
+				ConvexHull hull;
+				hull.error = this->error;
+				std::unordered_map<std::uint32_t, std::uint8_t> remap;
+				for (const Face& face : this->faces)
+				{
+					if (!face.alive)
+					{
+						continue;
+					}
+					for (std::uint32_t k = 0; k < 3; k++)
+					{
+						auto [it, inserted] = remap.try_emplace(face.v[k], static_cast<std::uint8_t>(remap.size()));
+						if (inserted)
+						{
+							hull.vertices.insert(hull.vertices.end(), this->points + 3 * static_cast<std::size_t>(face.v[k]), this->points + 3 * static_cast<std::size_t>(face.v[k]) + 3);
+						}
+						hull.triangles.push_back(it->second);
+					}
+					// Triangles of the same face share its plane
+					bool shared = false;
+					for (std::size_t p = 0; p < hull.planes.size() && !shared; p += 4)
+					{
+						const float alignment = hull.planes[p + 0] * face.normal[0] + hull.planes[p + 1] * face.normal[1] + hull.planes[p + 2] * face.normal[2];
+						shared = alignment > 1.0f - 1e-5f && std::fabs(hull.planes[p + 3] - face.offset) <= this->epsilon;
+					}
+					if (!shared)
+					{
+						hull.planes.insert(hull.planes.end(), { face.normal[0], face.normal[1], face.normal[2], face.offset });
+					}
+				}
+				return hull;
+			}
+		private:
+			static constexpr std::uint32_t NoFace = std::numeric_limits<std::uint32_t>::max();
+			struct Face
+			{
+				std::uint32_t v[3];
+				float normal[3];
+				float offset;
+				std::vector<std::uint32_t> outside;
+				std::uint32_t furthest = 0;
+				float furthestDistance = 0.0f;
+				bool alive = true;
+				bool visited = false;
+			};
+			static inline std::uint64_t EdgeKey(std::uint32_t from, std::uint32_t to)
+			{
+				return (static_cast<std::uint64_t>(from) << 32) | to;
+			}
+			inline const float* Point(std::uint32_t p) const
+			{
+				return this->points + 3 * static_cast<std::size_t>(p);
+			}
+			inline float Distance(const Face& face, std::uint32_t p) const
+			{
+				const float* point = this->Point(p);
+				return face.normal[0] * point[0] + face.normal[1] * point[1] + face.normal[2] * point[2] - face.offset;
+			}
+			/// <summary>
+			/// Signed volume of the tetrahedron, positive if d is in front of the CCW triangle a, b, c
+			/// </summary>
+			inline float PlaneDistance(std::uint32_t a, std::uint32_t b, std::uint32_t c, std::uint32_t d) const
+			{
+				const float* pa = this->Point(a);
+				const float* pb = this->Point(b);
+				const float* pc = this->Point(c);
+				const float* pd = this->Point(d);
+				const float u[3] = { pb[0] - pa[0], pb[1] - pa[1], pb[2] - pa[2] };
+				const float v[3] = { pc[0] - pa[0], pc[1] - pa[1], pc[2] - pa[2] };
+				const float w[3] = { pd[0] - pa[0], pd[1] - pa[1], pd[2] - pa[2] };
+				return (u[1] * v[2] - u[2] * v[1]) * w[0] + (u[2] * v[0] - u[0] * v[2]) * w[1] + (u[0] * v[1] - u[1] * v[0]) * w[2];
+			}
+			/// <summary>
+			/// Tolerance scaled to the coordinates of the points
+			/// </summary>
+			inline float Epsilon() const
+			{
+				float extent[3] = { 0.0f, 0.0f, 0.0f };
+				for (std::size_t p = 0; p < this->count; p++)
+				{
+					for (std::size_t k = 0; k < 3; k++)
+					{
+						extent[k] = std::max(extent[k], std::fabs(this->points[3 * p + k]));
+					}
+				}
+				return 3.0f * std::numeric_limits<float>::epsilon() * (extent[0] + extent[1] + extent[2]);
+			}
+			/// <summary>
+			/// Picks the largest starting tetrahedron from the extreme points, returns false for flat or coincident points
+			/// </summary>
+			inline bool Simplex(std::uint32_t simplex[4])
+			{
+				std::uint32_t extremes[6] = {};
+				for (std::uint32_t p = 0; p < this->count; p++)
+				{
+					for (std::uint32_t k = 0; k < 3; k++)
+					{
+						if (this->Point(p)[k] < this->Point(extremes[2 * k])[k])
+						{
+							extremes[2 * k] = p;
+						}
+						if (this->Point(p)[k] > this->Point(extremes[2 * k + 1])[k])
+						{
+							extremes[2 * k + 1] = p;
+						}
+					}
+				}
+				auto squaredDistance = [&](std::uint32_t a, std::uint32_t b) {
+					const float* pa = this->Point(a);
+					const float* pb = this->Point(b);
+					return (pa[0] - pb[0]) * (pa[0] - pb[0]) + (pa[1] - pb[1]) * (pa[1] - pb[1]) + (pa[2] - pb[2]) * (pa[2] - pb[2]);
+				};
+				float best = 0.0f;
+				for (std::uint32_t i = 0; i < 6; i++)
+				{
+					for (std::uint32_t j = i + 1; j < 6; j++)
+					{
+						const float distance = squaredDistance(extremes[i], extremes[j]);
+						if (distance > best)
+						{
+							best = distance;
+							simplex[0] = extremes[i];
+							simplex[1] = extremes[j];
+						}
+					}
+				}
+				if (best <= this->epsilon * this->epsilon)
+				{
+					return false;
+				}
+				// Furthest from the line through the first 2
+				const float* a = this->Point(simplex[0]);
+				const float* b = this->Point(simplex[1]);
+				const float line[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+				best = 0.0f;
+				for (std::uint32_t p = 0; p < this->count; p++)
+				{
+					const float* point = this->Point(p);
+					const float w[3] = { point[0] - a[0], point[1] - a[1], point[2] - a[2] };
+					const float cross[3] = { line[1] * w[2] - line[2] * w[1], line[2] * w[0] - line[0] * w[2], line[0] * w[1] - line[1] * w[0] };
+					const float distance = cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2];
+					if (distance > best)
+					{
+						best = distance;
+						simplex[2] = p;
+					}
+				}
+				const float lineLength = std::sqrtf(line[0] * line[0] + line[1] * line[1] + line[2] * line[2]);
+				if (std::sqrtf(best) <= this->epsilon * lineLength)
+				{
+					return false;
+				}
+				// Furthest from the plane through the first 3
+				const float area = std::sqrtf(best);
+				const float* c = this->Point(simplex[2]);
+				const float side[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+				this->planeNormal[0] = line[1] * side[2] - line[2] * side[1];
+				this->planeNormal[1] = line[2] * side[0] - line[0] * side[2];
+				this->planeNormal[2] = line[0] * side[1] - line[1] * side[0];
+				best = 0.0f;
+				for (std::uint32_t p = 0; p < this->count; p++)
+				{
+					const float distance = std::fabs(this->PlaneDistance(simplex[0], simplex[1], simplex[2], p));
+					if (distance > best)
+					{
+						best = distance;
+						simplex[3] = p;
+					}
+				}
+				return best > this->epsilon * area;
+			}
+			inline std::uint32_t AddFace(std::uint32_t a, std::uint32_t b, std::uint32_t c)
+			{
+				std::uint32_t index;
+				if (!this->freeFaces.empty())
+				{
+					index = this->freeFaces.back();
+					this->freeFaces.pop_back();
+				}
+				else
+				{
+					index = static_cast<std::uint32_t>(this->faces.size());
+					this->faces.emplace_back();
+				}
+				Face& face = this->faces[index];
+				face.v[0] = a;
+				face.v[1] = b;
+				face.v[2] = c;
+				face.alive = true;
+				face.visited = false;
+				face.outside.clear();
+				face.furthestDistance = 0.0f;
+				const float* pa = this->Point(a);
+				const float* pb = this->Point(b);
+				const float* pc = this->Point(c);
+				const float u[3] = { pb[0] - pa[0], pb[1] - pa[1], pb[2] - pa[2] };
+				const float v[3] = { pc[0] - pa[0], pc[1] - pa[1], pc[2] - pa[2] };
+				float n[3] = { u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0] };
+				const float length = std::sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+				const float inverseLength = (length > 0.0f) ? 1.0f / length : 0.0f;
+				for (std::size_t k = 0; k < 3; k++)
+				{
+					face.normal[k] = n[k] * inverseLength;
+				}
+				face.offset = face.normal[0] * pa[0] + face.normal[1] * pa[1] + face.normal[2] * pa[2];
+				for (std::uint32_t e = 0; e < 3; e++)
+				{
+					this->edges[EdgeKey(face.v[e], face.v[(e + 1) % 3])] = index;
+					this->vertexFaces[face.v[e]]++;
+				}
+				return index;
+			}
+			inline void RemoveFace(std::uint32_t index)
+			{
+				Face& face = this->faces[index];
+				face.alive = false;
+				face.outside.clear();
+				for (std::uint32_t e = 0; e < 3; e++)
+				{
+					this->edges.erase(EdgeKey(face.v[e], face.v[(e + 1) % 3]));
+					auto vertex = this->vertexFaces.find(face.v[e]);
+					if (--vertex->second == 0)
+					{
+						this->vertexFaces.erase(vertex);
+					}
+				}
+				this->freeFaces.push_back(index);
+			}
+			/// <summary>
+			/// Gives each point to the first face it is in front of, points behind every face are inside the hull and dropped
+			/// </summary>
+			inline void Assign(const std::vector<std::uint32_t>& candidates, const std::uint32_t* faceList, std::size_t faceCount)
+			{
+				for (std::uint32_t p : candidates)
+				{
+					for (std::size_t i = 0; i < faceCount; i++)
+					{
+						Face& face = this->faces[faceList[i]];
+						const float distance = this->Distance(face, p);
+						if (distance > this->epsilon)
+						{
+							face.outside.push_back(p);
+							if (distance > face.furthestDistance)
+							{
+								face.furthestDistance = distance;
+								face.furthest = p;
+							}
+							break;
+						}
+					}
+				}
+			}
+			const float* points;
+			std::size_t count;
+			float epsilon = 0.0f;
+			float error = 0.0f;
+			float planeNormal[3] = { 0.0f, 0.0f, 0.0f };
+			std::vector<Face> faces;
+			std::vector<std::uint32_t> freeFaces;
+			std::unordered_map<std::uint64_t, std::uint32_t> edges;
+			std::unordered_map<std::uint32_t, std::uint32_t> vertexFaces;
+		};
+	}
+	/// <summary>
+	/// Collider for UVSphere and Icosphere, nullopt if the scale isn't uniform
+	/// </summary>
+	/// <param name="settings">Settings the sphere was generated with</param>
+	/// <returns>Sphere collider</returns>
+	inline std::optional<AnalyticCollider> SphereCollider(const GeneratorSetting& settings = GeneratorSetting())
+	{
+		if (!internal::UniformScale(settings.scale, true, true, true))
+		{
+			return std::nullopt;
+		}
+		const float radius = 0.5f * std::fabs(settings.scale.x);
+		return internal::TransformedCollider(ColliderShape::Sphere, vec3(radius, radius, radius), settings);
+	}
+	/// <summary>
+	/// Collider for Cube, which stays a box under any scale
+	/// </summary>
+	/// <param name="settings">Settings the cube was generated with</param>
+	/// <returns>Box collider</returns>
+	inline AnalyticCollider CubeCollider(const GeneratorSetting& settings = GeneratorSetting())
+	{
+		return internal::TransformedCollider(ColliderShape::Box, vec3(0.5f * std::fabs(settings.scale.x), 0.5f * std::fabs(settings.scale.y), 0.5f * std::fabs(settings.scale.z)), settings);
+	}
+	/// <summary>
+	/// Collider for Plane and Quad, a box with no thickness
+	/// </summary>
+	/// <param name="settings">Settings the plane was generated with</param>
+	/// <returns>Box collider</returns>
+	inline AnalyticCollider PlaneCollider(const GeneratorSetting& settings = GeneratorSetting())
+	{
+		return internal::TransformedCollider(ColliderShape::Box, vec3(0.5f * std::fabs(settings.scale.x), 0.5f * std::fabs(settings.scale.y), 0.0f), settings);
+	}
+	/// <summary>
+	/// Collider for Cylinder, nullopt if the x and z scale differ
+	/// </summary>
+	/// <param name="radius">Radius the cylinder was generated with</param>
+	/// <param name="height">Height the cylinder was generated with</param>
+	/// <param name="settings">Settings the cylinder was generated with</param>
+	/// <returns>Cylinder collider</returns>
+	inline std::optional<AnalyticCollider> CylinderCollider(float radius, float height, const GeneratorSetting& settings = GeneratorSetting())
+	{
+		if (!internal::UniformScale(settings.scale, true, false, true))
+		{
+			return std::nullopt;
+		}
+		const float scaledRadius = radius * std::fabs(settings.scale.x);
+		return internal::TransformedCollider(ColliderShape::Cylinder, vec3(scaledRadius, 0.5f * height * std::fabs(settings.scale.y), scaledRadius), settings);
+	}
+	/// <summary>
+	/// Collider for Cylinder with the default size, nullopt if the x and z scale differ
+	/// </summary>
+	/// <param name="settings">Settings the cylinder was generated with</param>
+	/// <returns>Cylinder collider</returns>
+	inline std::optional<AnalyticCollider> CylinderCollider(const GeneratorSetting& settings = GeneratorSetting())
+	{
+		return CylinderCollider(0.5f, 1.0f, settings);
+	}
+	/// <summary>
+	/// Collider for Capsule, nullopt if the scale isn't uniform as the hemispheres would stretch
+	/// </summary>
+	/// <param name="radius">Radius the capsule was generated with</param>
+	/// <param name="height">Height of the cylindrical section the capsule was generated with</param>
+	/// <param name="settings">Settings the capsule was generated with</param>
+	/// <returns>Capsule collider</returns>
+	inline std::optional<AnalyticCollider> CapsuleCollider(float radius, float height, const GeneratorSetting& settings = GeneratorSetting())
+	{
+		if (!internal::UniformScale(settings.scale, true, true, true))
+		{
+			return std::nullopt;
+		}
+		const float scale = std::fabs(settings.scale.x);
+		return internal::TransformedCollider(ColliderShape::Capsule, vec3(radius * scale, 0.5f * height * scale, radius * scale), settings);
+	}
+	/// <summary>
+	/// Collider for Capsule with the default size, nullopt if the scale isn't uniform
+	/// </summary>
+	/// <param name="settings">Settings the capsule was generated with</param>
+	/// <returns>Capsule collider</returns>
+	inline std::optional<AnalyticCollider> CapsuleCollider(const GeneratorSetting& settings = GeneratorSetting())
+	{
+		return CapsuleCollider(0.5f, 1.0f, settings);
+	}
+	/// <summary>
+	/// Builds the convex hull of a point cloud with quickhull, adding the furthest point first until maxVertices are on the hull.
+	/// A hull cut short lies inside the points, ConvexHull::error says by how much.
+	/// Flat point clouds such as Plane get a hull thickened by a few float epsilons.
+	/// Throws std::invalid_argument if there are fewer than 4 points, they are all on one line or maxVertices isn't between 4 and 255
+	/// </summary>
+	/// <param name="points">float list of 3 tuple positions</param>
+	/// <param name="maxVertices">Maximum number of hull vertices</param>
+	/// <returns>Convex hull</returns>
+	inline ConvexHull BuildConvexHull(const std::vector<float>& points, std::size_t maxVertices = 32)
+	{
+		if (maxVertices < 4 || maxVertices > 255)
+		{
+			throw std::invalid_argument("Construct: convex hulls need between 4 and 255 vertices");
+		}
+		const std::size_t count = points.size() / 3;
+		if (count < 4)
+		{
+			throw std::invalid_argument("Construct: a convex hull needs at least 4 points");
+		}
+		internal::QuickHull quickHull(points.data(), count);
+		if (quickHull.Build(maxVertices))
+		{
+			return quickHull.Output();
+		}
+		// Flat points are pushed to both sides of their plane, the hull stays closed for the narrow phase
+		const float* normal = quickHull.PlaneNormal();
+		const float length = std::sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+		if (!(length > 0.0f))
+		{
+			throw std::invalid_argument("Construct: a convex hull needs points that aren't on one line");
+		}
+		const Bounds bounds = Bounds::FromVertices(points);
+		const float extent = std::max({ std::fabs(bounds.min.x), std::fabs(bounds.max.x), std::fabs(bounds.min.y), std::fabs(bounds.max.y), std::fabs(bounds.min.z), std::fabs(bounds.max.z) });
+		const float thickness = 64.0f * std::numeric_limits<float>::epsilon() * std::max(extent, 1.0f) / length;
+		std::vector<float> slab(2 * points.size());
+		for (std::size_t p = 0; p < count; p++)
+		{
+			for (std::size_t k = 0; k < 3; k++)
+			{
+				slab[3 * p + k] = points[3 * p + k] + normal[k] * thickness;
+				slab[3 * (count + p) + k] = points[3 * p + k] - normal[k] * thickness;
+			}
+		}
+		internal::QuickHull slabHull(slab.data(), 2 * count);
+		if (!slabHull.Build(maxVertices))
+		{
+			throw std::invalid_argument("Construct: a convex hull needs points that aren't on one line");
+		}
+		return slabHull.Output();
+	}
+	/// <summary>
+	/// Builds the convex hull of a mesh, including Merge results, see BuildConvexHull for points.
+	/// Throws std::invalid_argument if the mesh has fewer than 4 vertices, they are all on one line or maxVertices isn't between 4 and 255
+	/// </summary>
+	/// <param name="mesh">Mesh to wrap</param>
+	/// <param name="maxVertices">Maximum number of hull vertices</param>
+	/// <returns>Convex hull</returns>
+	template <typename IndexType>
+	inline ConvexHull BuildConvexHull(const BasicMesh<IndexType>& mesh, std::size_t maxVertices = 32)
+	{
+		return BuildConvexHull(mesh.vertices, maxVertices);
+	}
+	/// <summary>
+	/// Direction i of a k-DOP, unnormalised so extents along diagonals are in the same units as dot products with it
+	/// </summary>
+	/// <param name="k">Number of planes, 6, 14, 18 or 26</param>
+	/// <param name="i">Direction, less than k / 2</param>
+	/// <returns>Direction</returns>
+	inline vec3 KDopDirection(std::uint32_t k, std::uint32_t i)
+	{
+		// 14-DOPs skip the edge diagonals
+		const std::uint32_t axis = (k == 14 && i >= 3) ? i + 6 : i;
+		return vec3(internal::KDopAxes[axis][0], internal::KDopAxes[axis][1], internal::KDopAxes[axis][2]);
+	}
+	/// <summary>
+	/// Builds the k-DOP of a mesh, a tighter bound than the box in Mesh::bounds that is still tested with k / 2 interval checks.
+	/// Throws std::invalid_argument if k isn't 6, 14, 18 or 26
+	/// </summary>
+	/// <param name="mesh">Mesh to bound</param>
+	/// <param name="k">Number of planes</param>
+	/// <returns>k-DOP of the mesh</returns>
+	template <typename IndexType>
+	inline KDop BuildKDop(const BasicMesh<IndexType>& mesh, std::uint32_t k = 14)
+	{
+		if (k != 6 && k != 14 && k != 18 && k != 26)
+		{
+			throw std::invalid_argument("Construct: k-DOPs have 6, 14, 18 or 26 planes");
+		}
+		KDop kdop;
+		kdop.k = k;
+		float directions[13][3];
+		for (std::uint32_t i = 0; i < k / 2; i++)
+		{
+			const vec3 direction = KDopDirection(k, i);
+			directions[i][0] = direction.x;
+			directions[i][1] = direction.y;
+			directions[i][2] = direction.z;
+			kdop.extents[2 * i + 0] = std::numeric_limits<float>::max();
+			kdop.extents[2 * i + 1] = std::numeric_limits<float>::lowest();
+		}
+		for (std::size_t v = 0, size = mesh.vertices.size(); v < size; v += 3)
+		{
+			for (std::uint32_t i = 0; i < k / 2; i++)
+			{
+				const float distance = directions[i][0] * mesh.vertices[v + 0] + directions[i][1] * mesh.vertices[v + 1] + directions[i][2] * mesh.vertices[v + 2];
+				kdop.extents[2 * i + 0] = std::min(kdop.extents[2 * i + 0], distance);
+				kdop.extents[2 * i + 1] = std::max(kdop.extents[2 * i + 1], distance);
+			}
+		}
+		return kdop;
+	}
+}
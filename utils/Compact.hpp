@@ -0,0 +1,245 @@
+#pragma once
+
+#include "../internal/Mesh.hpp"
+#include "../internal/GeneratorContext.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Construct
+{
+	/// <summary>
+	/// Statistics on what Compact removed from a mesh
+	/// </summary>
+	struct CompactReport
+	{
+		/// <summary>
+		/// Triangles removed for repeating an index or having zero area
+		/// </summary>
+		std::size_t degenerateTriangles = 0;
+		/// <summary>
+		/// Triangles removed for repeating an earlier triangle with the same winding
+		/// </summary>
+		std::size_t duplicateTriangles = 0;
+		/// <summary>
+		/// Vertices removed for not being referenced by any triangle
+		/// </summary>
+		std::size_t unusedVertices = 0;
+		/// <summary>
+		/// Total size of the removed indices and vertex attributes in bytes
+		/// </summary>
+		std::size_t bytesReclaimed = 0;
+	};
+	namespace internal
+	{
+		struct TriangleHash
+		{
+			template <typename IndexType>
+			std::size_t operator()(const std::array<IndexType, 3>& triangle) const
+			{
+				std::uint64_t seed = triangle[0];
+				seed = seed * 0x9e3779b97f4a7c15ull + triangle[1];
+				seed = seed * 0x9e3779b97f4a7c15ull + triangle[2];
+				return static_cast<std::size_t>(seed ^ (seed >> 32));
+			}
+		};
+		/// <summary>
+		/// Checks if a triangle has (close to) zero area relative to its longest edge
+		/// </summary>
+		inline bool IsDegenerate(const std::vector<float>& vertices, std::size_t i1, std::size_t i2, std::size_t i3, float epsilon)
+		{
+			const float ux = vertices[i2 * 3 + 0] - vertices[i1 * 3 + 0],
+				uy = vertices[i2 * 3 + 1] - vertices[i1 * 3 + 1],
+				uz = vertices[i2 * 3 + 2] - vertices[i1 * 3 + 2];
+			const float vx = vertices[i3 * 3 + 0] - vertices[i1 * 3 + 0],
+				vy = vertices[i3 * 3 + 1] - vertices[i1 * 3 + 1],
+				vz = vertices[i3 * 3 + 2] - vertices[i1 * 3 + 2];
+			const float wx = vx - ux, wy = vy - uy, wz = vz - uz;
+			const float nx = (uy * vz) - (uz * vy),
+				ny = (uz * vx) - (ux * vz),
+				nz = (ux * vy) - (uy * vx);
+			// Twice the area compared against the squared longest edge, so the test doesn't depend on scale
+			float longestEdge = ux * ux + uy * uy + uz * uz;
+			longestEdge = std::max(longestEdge, vx * vx + vy * vy + vz * vz);
+			longestEdge = std::max(longestEdge, wx * wx + wy * wy + wz * wz);
+			const float threshold = epsilon * longestEdge;
+			return nx * nx + ny * ny + nz * nz <= threshold * threshold;
+		}
+		/// <summary>
+		/// Rotates a triangle so its smallest index is first, this keeps the winding
+		/// </summary>
+		template <typename IndexType>
+		inline std::array<IndexType, 3> TriangleKey(IndexType i1, IndexType i2, IndexType i3)
+		{
+			if (i2 < i1 && i2 < i3)
+			{
+				return { i2, i3, i1 };
+			}
+			if (i3 < i1 && i3 < i2)
+			{
+				return { i3, i1, i2 };
+			}
+			return { i1, i2, i3 };
+		}
+	}
+	/// <summary>
+	/// Removes degenerate triangles, duplicate triangles and unreferenced vertices from a mesh in place.
+	/// Surviving vertices and triangles keep their relative order.
+	/// Triangle strips are left intact, only their unreferenced vertices are removed.
+	/// The vertex remap and the duplicate triangle table live in the scratch buffers of the context
+	/// </summary>
+	/// <param name="mesh">Mesh to compact</param>
+	/// <param name="context">Context whose scratch buffers are reused</param>
+	/// <param name="degenerateEpsilon">Triangles with an area below this fraction of their squared longest edge are removed</param>
+	/// <returns>What was removed from the mesh</returns>
+	template <typename IndexType>
+	inline CompactReport Compact(BasicMesh<IndexType>& mesh, GeneratorContext& context, float degenerateEpsilon = 1e-6f)
+	{
+		static constexpr IndexType Unused = std::numeric_limits<IndexType>::max();
+		CompactReport report;
+		const std::size_t vertexCount = mesh.vertices.size() / 3;
+		const std::size_t indexCount = mesh.indices.size();
+		// Vertex remap, marks referenced vertices first
+		std::vector<IndexType>& remap = context.Scratch<IndexType>(0);
+		remap.assign(vertexCount, Unused);
+		if (mesh.topology == Topology::TriangleList)
+		{
+			// Open addressing table of kept triangles, each slot holds the position of the triangle in the output plus one.
+			// Kept triangles are already written to the front of the index buffer, so the table doesn't store keys
+			std::vector<std::uint64_t>& seen = context.Scratch<std::uint64_t>(1);
+			std::size_t tableSize = 16;
+			while (tableSize < indexCount / 3 * 2)
+			{
+				tableSize *= 2;
+			}
+			seen.assign(tableSize, 0);
+			std::size_t writeIndex = 0;
+			for (std::size_t i = 0; i + 2 < indexCount; i += 3)
+			{
+				const IndexType i1 = mesh.indices[i + 0],
+					i2 = mesh.indices[i + 1],
+					i3 = mesh.indices[i + 2];
+				if (i1 == i2 || i2 == i3 || i1 == i3 || internal::IsDegenerate(mesh.vertices, i1, i2, i3, degenerateEpsilon))
+				{
+					report.degenerateTriangles++;
+					continue;
+				}
+				const std::array<IndexType, 3> key = internal::TriangleKey(i1, i2, i3);
+				std::size_t slot = internal::TriangleHash()(key) & (tableSize - 1);
+				bool duplicate = false;
+				while (seen[slot] != 0)
+				{
+					const std::size_t kept = static_cast<std::size_t>(seen[slot] - 1) * 3;
+					if (internal::TriangleKey(mesh.indices[kept + 0], mesh.indices[kept + 1], mesh.indices[kept + 2]) == key)
+					{
+						duplicate = true;
+						break;
+					}
+					slot = (slot + 1) & (tableSize - 1);
+				}
+				if (duplicate)
+				{
+					report.duplicateTriangles++;
+					continue;
+				}
+				seen[slot] = writeIndex / 3 + 1;
+				mesh.indices[writeIndex + 0] = i1;
+				mesh.indices[writeIndex + 1] = i2;
+				mesh.indices[writeIndex + 2] = i3;
+				writeIndex += 3;
+				remap[i1] = remap[i2] = remap[i3] = 0;
+			}
+			mesh.indices.resize(writeIndex);
+		}
+		else
+		{
+			for (IndexType index : mesh.indices)
+			{
+				if (index != PrimitiveRestart<IndexType>)
+				{
+					remap[index] = 0;
+				}
+			}
+		}
+		// Assign new indices in order and move attributes down, a vertex never moves up so this is safe in place
+		const bool hasNormals = !mesh.normals.empty();
+		const bool hasTextureUVs = !mesh.textureUVs.empty();
+		const bool hasTangents = !mesh.tangents.empty();
+		std::size_t nextIndex = 0;
+		for (std::size_t i = 0; i < vertexCount; i++)
+		{
+			if (remap[i] == Unused)
+			{
+				continue;
+			}
+			remap[i] = static_cast<IndexType>(nextIndex);
+			for (std::uint32_t k = 0; k < 3; k++)
+			{
+				mesh.vertices[nextIndex * 3 + k] = mesh.vertices[i * 3 + k];
+			}
+			if (hasNormals)
+			{
+				for (std::uint32_t k = 0; k < 3; k++)
+				{
+					mesh.normals[nextIndex * 3 + k] = mesh.normals[i * 3 + k];
+				}
+			}
+			if (hasTextureUVs)
+			{
+				for (std::uint32_t k = 0; k < 2; k++)
+				{
+					mesh.textureUVs[nextIndex * 2 + k] = mesh.textureUVs[i * 2 + k];
+				}
+			}
+			if (hasTangents)
+			{
+				for (std::uint32_t k = 0; k < 4; k++)
+				{
+					mesh.tangents[nextIndex * 4 + k] = mesh.tangents[i * 4 + k];
+				}
+			}
+			nextIndex++;
+		}
+		mesh.vertices.resize(3 * nextIndex);
+		if (hasNormals)
+		{
+			mesh.normals.resize(3 * nextIndex);
+		}
+		if (hasTextureUVs)
+		{
+			mesh.textureUVs.resize(2 * nextIndex);
+		}
+		if (hasTangents)
+		{
+			mesh.tangents.resize(4 * nextIndex);
+		}
+		// Remap indices to the compacted vertices
+		for (IndexType& index : mesh.indices)
+		{
+			if (index != PrimitiveRestart<IndexType>)
+			{
+				index = remap[index];
+			}
+		}
+		// Tally up what was removed
+		report.unusedVertices = vertexCount - nextIndex;
+		const std::size_t floatsPerVertex = 3 + (hasNormals ? 3 : 0) + (hasTextureUVs ? 2 : 0) + (hasTangents ? 4 : 0);
+		report.bytesReclaimed = (indexCount - mesh.indices.size()) * sizeof(IndexType) + report.unusedVertices * floatsPerVertex * sizeof(float);
+		return report;
+	}
+	/// <summary>
+	/// Removes degenerate triangles, duplicate triangles and unreferenced vertices from a mesh in place, using a temporary context
+	/// </summary>
+	/// <param name="mesh">Mesh to compact</param>
+	/// <param name="degenerateEpsilon">Triangles with an area below this fraction of their squared longest edge are removed</param>
+	/// <returns>What was removed from the mesh</returns>
+	template <typename IndexType>
+	inline CompactReport Compact(BasicMesh<IndexType>& mesh, float degenerateEpsilon = 1e-6f)
+	{
+		GeneratorContext context;
+		return Compact(mesh, context, degenerateEpsilon);
+	}
+}
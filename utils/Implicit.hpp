@@ -0,0 +1,549 @@
+#pragma once
+
+#include "../internal/CalculateTangents.hpp"
+#include "../internal/GeneratorContext.hpp"
+#include "../internal/GeneratorSetting.hpp"
+#include "../internal/Mesh.hpp"
+#include "../internal/Parallel.hpp"
+#include "../internal/ProcessMesh.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace Construct
+{
+	/// <summary>
+	/// Batch of points an implicit field is evaluated at, laid out as one array per component so a field can be vectorised.
+	/// Lanes past count repeat the last point, so a field can loop over all Size lanes without a remainder
+	/// </summary>
+	struct ImplicitBatch
+	{
+		/// <summary>
+		/// Lanes per batch
+		/// </summary>
+		static constexpr std::size_t Size = 8;
+		/// <summary>
+		/// Lanes holding points that are used
+		/// </summary>
+		std::size_t count = 0;
+		/// <summary>
+		/// Points in the [-0.5, 0.5] cube
+		/// </summary>
+		alignas(32) std::array<float, Size> x, y, z;
+		/// <summary>
+		/// Field output, negative inside the surface and positive outside like a signed distance
+		/// </summary>
+		alignas(32) std::array<float, Size> value;
+		/// <summary>
+		/// Optional gradient output
+		/// </summary>
+		alignas(32) std::array<float, Size> gx, gy, gz;
+		/// <summary>
+		/// Set by a field that wrote the gradient, normals are otherwise taken from central differences of the field
+		/// </summary>
+		bool gradients = false;
+	};
+	/// <summary>
+	/// Metaballs, the field is threshold minus the sum of radius^2 / distance^2 over the balls, with exact gradients
+	/// </summary>
+	struct MetaballField
+	{
+		/// <summary>
+		/// Balls as (X, Y, Z, radius), a lone ball's surface is at its radius
+		/// </summary>
+		std::vector<std::array<float, 4>> balls;
+		/// <summary>
+		/// Field strength the surface is at, higher values shrink the blobs
+		/// </summary>
+		float threshold = 1.0f;
+		inline void operator()(ImplicitBatch& batch) const
+		{
+			batch.value.fill(this->threshold);
+			batch.gx.fill(0.0f);
+			batch.gy.fill(0.0f);
+			batch.gz.fill(0.0f);
+			// Lanes are the inner loop so it vectorises
+			for (const std::array<float, 4>& ball : this->balls)
+			{
+				const float radiusSquared = ball[3] * ball[3];
+				for (std::size_t i = 0; i < ImplicitBatch::Size; i++)
+				{
+					const float dx = batch.x[i] - ball[0], dy = batch.y[i] - ball[1], dz = batch.z[i] - ball[2];
+					// Clamped so a sample on a center stays finite
+					const float inverseDistanceSquared = 1.0f / std::max(dx * dx + dy * dy + dz * dz, 1e-12f);
+					const float strength = radiusSquared * inverseDistanceSquared;
+					const float slope = 2.0f * strength * inverseDistanceSquared;
+					batch.value[i] -= strength;
+					batch.gx[i] += slope * dx;
+					batch.gy[i] += slope * dy;
+					batch.gz[i] += slope * dz;
+				}
+			}
+			batch.gradients = true;
+		}
+	};
+	namespace internal
+	{
+		/// <summary>
+		/// Number of grid points per chunk when an implicit field is split across threads by planes
+		/// </summary>
+		inline constexpr std::size_t ImplicitParallelChunk = 1 << 15;
+		/// <summary>
+		/// Triangles of every marching cubes case, as edge numbers
+		/// </summary>
+		struct MarchingCubesTable
+		{
+			std::array<std::uint8_t, 256> triangleCount;
+			std::array<std::array<std::uint8_t, 36>, 256> edges;
+		};
+		/// <summary>
+		/// Corners of the cube edges, corner c is at (c &amp; 1, c &gt;&gt; 1 &amp; 1, c &gt;&gt; 2 &amp; 1).
+		/// Edges 0 to 3 run along x, 4 to 7 along y and 8 to 11 along z, each group ordered by the lowest corner
+		/// </summary>
+		inline constexpr std::uint8_t MarchingCubesEdgeCorners[12][2] = {
+			{ 0, 1 }, { 2, 3 }, { 4, 5 }, { 6, 7 },
+			{ 0, 2 }, { 1, 3 }, { 4, 6 }, { 5, 7 },
+			{ 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 },
+		};
+		/// <summary>
+		/// Whether 2 cube edges lie on a common face of the cube, all 4 corners then agree on one coordinate
+		/// </summary>
+		inline bool MarchingCubesEdgesShareFace(std::uint8_t a, std::uint8_t b)
+		{
+			const std::uint8_t* ca = MarchingCubesEdgeCorners[a];
+			const std::uint8_t* cb = MarchingCubesEdgeCorners[b];
+			const std::uint32_t all = ca[0] & ca[1] & cb[0] & cb[1], any = ca[0] | ca[1] | cb[0] | cb[1];
+			return ((all | ~any) & 7) != 0;
+		}
+		/// <summary>
+		/// Triangulates the part of a loop from first to last, whose ends are already joined, without a diagonal between edges on one face of the cube.
+		/// A diagonal on a face would lie in the cube next to it too, which puts overlapping triangles in the face on ambiguous faces
+		/// </summary>
+		/// <returns>False if there is no such triangulation, nothing is kept then</returns>
+		inline bool TriangulateMarchingCubesLoop(const std::uint8_t* loop, std::uint8_t length, std::uint8_t first, std::uint8_t last, std::uint8_t* edges, std::uint8_t& triangles)
+		{
+			if (last - first < 2)
+			{
+				return true;
+			}
+			auto joinable = [&](std::uint8_t a, std::uint8_t b) { return b - a == 1 || b - a == length - 1 || !MarchingCubesEdgesShareFace(loop[a], loop[b]); };
+			for (std::uint8_t k = first + 1; k < last; k++)
+			{
+				if (!joinable(first, k) || !joinable(k, last))
+				{
+					continue;
+				}
+				const std::uint8_t kept = triangles;
+				if (TriangulateMarchingCubesLoop(loop, length, first, k, edges, triangles) && TriangulateMarchingCubesLoop(loop, length, k, last, edges, triangles))
+				{
+					edges[3 * triangles + 0] = loop[first];
+					edges[3 * triangles + 1] = loop[k];
+					edges[3 * triangles + 2] = loop[last];
+					triangles++;
+					return true;
+				}
+				triangles = kept;
+			}
+			return false;
+		}
+		/// <summary>
+		/// Builds the marching cubes table from the cube faces instead of storing it.
+		/// On each face the edges where the boundary enters the surface are joined to the next edge where it leaves,
+		/// which keeps the corners inside the surface apart on ambiguous faces.
+		/// Both cubes sharing a face make the same choice and the segments chain into loops, which are triangulated without diagonals on the cube faces,
+		/// so every edge of the mesh inside the grid has exactly 2 triangles
+		/// </summary>
+		inline MarchingCubesTable BuildMarchingCubesTable()
+		{
+			// Corners of each face, CCW seen from outside the cube
+			constexpr std::uint8_t faces[6][4] = {
+				{ 0, 4, 6, 2 }, { 1, 3, 7, 5 },
+				{ 0, 1, 5, 4 }, { 2, 6, 7, 3 },
+				{ 0, 2, 3, 1 }, { 4, 5, 7, 6 },
+			};
+			auto edgeOf = [](std::uint8_t a, std::uint8_t b) {
+				for (std::uint8_t e = 0; e < 12; e++)
+				{
+					if ((MarchingCubesEdgeCorners[e][0] == a && MarchingCubesEdgeCorners[e][1] == b) || (MarchingCubesEdgeCorners[e][0] == b && MarchingCubesEdgeCorners[e][1] == a))
+					{
+						return e;
+					}
+				}
+				return std::uint8_t(0);
+			};
+			MarchingCubesTable table{};
+			for (std::uint32_t cube = 0; cube < 256; cube++)
+			{
+				auto inside = [&](std::uint8_t corner) { return ((cube >> corner) & 1) != 0; };
+				std::array<std::int8_t, 12> next;
+				next.fill(-1);
+				for (const auto& face : faces)
+				{
+					std::uint8_t crossings[4], entering[4], crossingCount = 0;
+					for (std::uint8_t k = 0; k < 4; k++)
+					{
+						const std::uint8_t a = face[k], b = face[(k + 1) % 4];
+						if (inside(a) != inside(b))
+						{
+							crossings[crossingCount] = edgeOf(a, b);
+							entering[crossingCount] = inside(b) ? 1 : 0;
+							crossingCount++;
+						}
+					}
+					for (std::uint8_t k = 0; k < crossingCount; k++)
+					{
+						if (entering[k] != 0)
+						{
+							next[crossings[k]] = static_cast<std::int8_t>(crossings[(k + 1) % crossingCount]);
+						}
+					}
+				}
+				// Every crossed edge is entered on one of its faces, so following next walks closed loops
+				std::array<bool, 12> visited{};
+				std::uint8_t triangles = 0;
+				for (std::uint8_t start = 0; start < 12; start++)
+				{
+					if (next[start] < 0 || visited[start])
+					{
+						continue;
+					}
+					std::uint8_t loop[12], length = 0;
+					for (std::int8_t e = static_cast<std::int8_t>(start); !visited[e]; e = next[e])
+					{
+						visited[e] = true;
+						loop[length++] = static_cast<std::uint8_t>(e);
+					}
+					// Every loop of the 256 cases has such a triangulation
+					TriangulateMarchingCubesLoop(loop, length, 0, length - 1, table.edges[cube].data(), triangles);
+				}
+				table.triangleCount[cube] = triangles;
+			}
+			return table;
+		}
+		inline const MarchingCubesTable& MarchingCubesCases()
+		{
+			static const MarchingCubesTable table = BuildMarchingCubesTable();
+			return table;
+		}
+	}
+	/// <summary>
+	/// Generates the surface where an implicit field crosses 0, with marching cubes over a grid of resolution^3 cells spanning the [-0.5, 0.5] cube.
+	/// The field is called with batches of ImplicitBatch::Size points from several threads at once, so it must be safe to call concurrently.
+	/// Vertices on a grid edge are shared by every cell around it and normals follow the gradient of the field.
+	/// Texture UVs project the position along the axis the normal is closest to, tangents follow them.
+	/// Surfaces cut by the cube are left open there. Always outputs a triangle list.
+	/// Throws std::invalid_argument if resolution is 0
+	/// </summary>
+	/// <param name="context">Context whose buffers are reused, see GeneratorContext</param>
+	/// <param name="resolution">Number of cells along each axis</param>
+	/// <param name="field">Callable taking an ImplicitBatch&amp; that writes the value, and optionally the gradient, of each lane</param>
+	/// <param name="settings">Settings that affect how the mesh is generated</param>
+	/// <returns>Mesh data for the surface</returns>
+	template <typename IndexType = std::uint32_t, typename Field>
+	inline BasicMesh<IndexType> Implicit(GeneratorContext& context, std::uint32_t resolution, Field&& field, const GeneratorSetting& settings = GeneratorSetting())
+	{
+		if (resolution == 0)
+		{
+			throw std::invalid_argument("Construct: an implicit surface needs at least one cell along each axis");
+		}
+		const internal::MarchingCubesTable& cases = internal::MarchingCubesCases();
+		const std::size_t points = static_cast<std::size_t>(resolution) + 1;
+		const std::size_t planeSize = points * points;
+		const std::size_t planesPerChunk = std::max<std::size_t>(1, internal::ImplicitParallelChunk / planeSize);
+		const float cell = 1.0f / static_cast<float>(resolution);
+		auto coordinate = [&](std::size_t i) { return static_cast<float>(i) * cell - 0.5f; };
+		const std::uint32_t chunks = internal::ChunkCount(points, planesPerChunk);
+		// Grid coordinates, padded with the last one for the lanes past the end of a row
+		std::vector<float>& axis = context.Scratch<float>(7);
+		axis.resize(points + ImplicitBatch::Size);
+		for (std::size_t i = 0; i < axis.size(); i++)
+		{
+			axis[i] = coordinate(std::min(i, points - 1));
+		}
+		// Sample the field at every grid point, a row at a time in batches along x.
+		// Each row also records whether it has points inside (1) and outside (2) the surface
+		std::vector<float>& values = context.Scratch<float>(6);
+		values.resize(points * planeSize);
+		std::vector<std::uint8_t>& rowSigns = context.Scratch<std::uint8_t>(0);
+		rowSigns.resize(planeSize);
+		internal::ParallelFor(context.Workers(), points, planesPerChunk, [&](std::size_t begin, std::size_t end, std::uint32_t) {
+			ImplicitBatch batch;
+			for (std::size_t k = begin; k < end; k++)
+			{
+				batch.z.fill(axis[k]);
+				for (std::size_t j = 0; j < points; j++)
+				{
+					batch.y.fill(axis[j]);
+					float* row = &values[k * planeSize + j * points];
+					for (std::size_t first = 0; first < points; first += ImplicitBatch::Size)
+					{
+						batch.count = std::min(ImplicitBatch::Size, points - first);
+						std::copy_n(&axis[first], ImplicitBatch::Size, batch.x.begin());
+						batch.gradients = false;
+						field(batch);
+						std::copy_n(batch.value.begin(), batch.count, row + first);
+					}
+					std::uint8_t signs = 0;
+					for (std::size_t i = 0; i < points; i++)
+					{
+						signs |= (row[i] < 0.0f) ? 1 : 2;
+					}
+					rowSigns[k * points + j] = signs;
+				}
+			}
+		});
+		// Whether the cells between rows j, j + 1 and planes k, k + 1 have corners on both sides, rows past the grid repeat row j
+		auto activeRow = [&](std::size_t j, std::size_t k) {
+			const std::size_t j1 = std::min(j + 1, points - 1), k1 = std::min(k + 1, points - 1);
+			return (rowSigns[k * points + j] | rowSigns[k * points + j1] | rowSigns[k1 * points + j] | rowSigns[k1 * points + j1]) == 3;
+		};
+		// Inside bits of the 4 points (i, j, k), (i, j + 1, k), (i, j, k + 1), (i, j + 1, k + 1) of every column i, rows past the grid repeat row j
+		auto rowMasks = [&](std::size_t j, std::size_t k, std::uint8_t* masks) {
+			const float* row = &values[k * planeSize + j * points];
+			const float* up = (j + 1 < points) ? row + points : row;
+			const float* front = (k + 1 < points) ? row + planeSize : row;
+			const float* frontUp = (j + 1 < points) ? front + points : front;
+			for (std::size_t i = 0; i < points; i++)
+			{
+				masks[i] = static_cast<std::uint8_t>(static_cast<std::uint32_t>(row[i] < 0.0f) | (static_cast<std::uint32_t>(up[i] < 0.0f) << 1) | (static_cast<std::uint32_t>(front[i] < 0.0f) << 2) | (static_cast<std::uint32_t>(frontUp[i] < 0.0f) << 3));
+			}
+			// The padding column repeats the last so it adds no x edge
+			masks[points] = masks[points - 1];
+		};
+		// Corners with x = 0 of a cube are 0, 2, 4 and 6, the column after gives 1, 3, 5 and 7
+		constexpr std::uint8_t Spread[16] = { 0, 1, 4, 5, 16, 17, 20, 21, 64, 65, 68, 69, 80, 81, 84, 85 };
+		auto cubeCase = [&](const std::uint8_t* masks, std::size_t i) { return static_cast<std::uint32_t>(Spread[masks[i]] | (Spread[masks[i + 1]] << 1)); };
+		auto crossings = [](std::uint8_t mask, std::uint8_t nextMask) { return ((mask ^ nextMask) & 1) + (((mask >> 1) ^ mask) & 1) + (((mask >> 2) ^ mask) & 1); };
+		// Plane k owns the vertices on its x and y edges and on the z edges up to plane k + 1, and the triangles of the cells up to plane k + 1
+		std::vector<std::uint64_t>& vertexBase = context.Scratch<std::uint64_t>(6);
+		std::vector<std::uint64_t>& triangleBase = context.Scratch<std::uint64_t>(7);
+		vertexBase.assign(points + 1, 0);
+		triangleBase.assign(points + 1, 0);
+		// Every chunk keeps its own row of masks and, when building, the edge caches of 2 planes
+		std::vector<std::uint8_t>& chunkMasks = context.Scratch<std::uint8_t>(1);
+		chunkMasks.resize(chunks * (points + 1));
+		internal::ParallelFor(context.Workers(), points, planesPerChunk, [&](std::size_t begin, std::size_t end, std::uint32_t chunk) {
+			std::uint8_t* masks = &chunkMasks[chunk * (points + 1)];
+			for (std::size_t k = begin; k < end; k++)
+			{
+				std::uint64_t vertexCount = 0, triangleCount = 0;
+				for (std::size_t j = 0; j < points; j++)
+				{
+					if (!activeRow(j, k))
+					{
+						continue;
+					}
+					rowMasks(j, k, masks);
+					for (std::size_t i = 0; i < points; i++)
+					{
+						vertexCount += crossings(masks[i], masks[i + 1]);
+					}
+					for (std::size_t i = 0; i + 1 < points && j + 1 < points && k + 1 < points; i++)
+					{
+						triangleCount += cases.triangleCount[cubeCase(masks, i)];
+					}
+				}
+				vertexBase[k + 1] = vertexCount;
+				triangleBase[k + 1] = triangleCount;
+			}
+		});
+		for (std::size_t k = 0; k < points; k++)
+		{
+			vertexBase[k + 1] += vertexBase[k];
+			triangleBase[k + 1] += triangleBase[k];
+		}
+		const std::size_t vertexCount = internal::CheckedVertexCount<IndexType>(vertexBase[points]);
+		const std::size_t indexCount = internal::CheckedIndexCount<IndexType>(internal::CheckedMultiply(3, triangleBase[points]));
+		const bool hasNormals = settings.HasAttribute(VertexAttribute::Normal);
+		const bool hasTextureUVs = settings.HasAttribute(VertexAttribute::TextureUV);
+		const bool hasTangents = settings.HasAttribute(VertexAttribute::Tangent);
+		// Tangents need the normals and texture UVs, they are dropped afterwards if they weren't asked for
+		const bool frame = hasNormals || hasTextureUVs || hasTangents;
+		BasicMesh<IndexType> mesh = context.NewMesh<IndexType>(3 * vertexCount, indexCount, frame ? 3 * vertexCount : 0, (hasTextureUVs || hasTangents) ? 2 * vertexCount : 0, 0);
+		mesh.topology = Topology::TriangleList;
+		std::vector<IndexType>& edgeCaches = context.Scratch<IndexType>(8);
+		edgeCaches.resize(chunks * 6 * planeSize);
+		// Each chunk walks its planes keeping the vertex indices of the edges of 2 planes, the edge cache
+		internal::ParallelFor(context.Workers(), points, planesPerChunk, [&](std::size_t begin, std::size_t end, std::uint32_t chunk) {
+			IndexType* current = &edgeCaches[chunk * 6 * planeSize];
+			IndexType* next = current + 3 * planeSize;
+			std::uint8_t* masks = &chunkMasks[chunk * (points + 1)];
+			// Numbers the crossed edges of plane k in the order plane k owns them, writing the vertices if this chunk owns the plane
+			auto cachePlane = [&](std::size_t k, IndexType* cache, bool write) {
+				IndexType vertex = static_cast<IndexType>(vertexBase[k]);
+				auto edge = [&](std::size_t i, std::size_t j, std::size_t axis, std::size_t di, std::size_t dj, std::size_t dk) {
+					cache[3 * (j * points + i) + axis] = vertex;
+					if (write)
+					{
+						const float from = values[k * planeSize + j * points + i];
+						const float to = values[(k + dk) * planeSize + (j + dj) * points + i + di];
+						const float t = from / (from - to);
+						float* position = &mesh.vertices[3 * static_cast<std::size_t>(vertex)];
+						position[0] = coordinate(i) + static_cast<float>(di) * t * cell;
+						position[1] = coordinate(j) + static_cast<float>(dj) * t * cell;
+						position[2] = coordinate(k) + static_cast<float>(dk) * t * cell;
+					}
+					vertex++;
+				};
+				for (std::size_t j = 0; j < points; j++)
+				{
+					if (!activeRow(j, k))
+					{
+						continue;
+					}
+					rowMasks(j, k, masks);
+					for (std::size_t i = 0; i < points; i++)
+					{
+						const std::uint8_t mask = masks[i];
+						if (((mask ^ masks[i + 1]) & 1) != 0)
+						{
+							edge(i, j, 0, 1, 0, 0);
+						}
+						if ((((mask >> 1) ^ mask) & 1) != 0)
+						{
+							edge(i, j, 1, 0, 1, 0);
+						}
+						if ((((mask >> 2) ^ mask) & 1) != 0)
+						{
+							edge(i, j, 2, 0, 0, 1);
+						}
+					}
+				}
+			};
+			cachePlane(begin, current, true);
+			for (std::size_t k = begin; k < end && k + 1 < points; k++)
+			{
+				// The next chunk owns its first plane, only its indices are needed here
+				cachePlane(k + 1, next, k + 1 < end);
+				IndexType* output = mesh.indices.data() + 3 * triangleBase[k];
+				for (std::size_t j = 0; j + 1 < points; j++)
+				{
+					if (!activeRow(j, k))
+					{
+						continue;
+					}
+					rowMasks(j, k, masks);
+					for (std::size_t i = 0; i + 1 < points; i++)
+					{
+						const std::uint32_t cube = cubeCase(masks, i);
+						if (cases.triangleCount[cube] == 0)
+						{
+							continue;
+						}
+						const std::size_t corner = j * points + i;
+						const IndexType edgeVertex[12] = {
+							current[3 * corner + 0], current[3 * (corner + points) + 0], next[3 * corner + 0], next[3 * (corner + points) + 0],
+							current[3 * corner + 1], current[3 * (corner + 1) + 1], next[3 * corner + 1], next[3 * (corner + 1) + 1],
+							current[3 * corner + 2], current[3 * (corner + 1) + 2], current[3 * (corner + points) + 2], current[3 * (corner + points + 1) + 2],
+						};
+						for (std::uint32_t e = 0, size = 3u * cases.triangleCount[cube]; e < size; e++)
+						{
+							*output++ = edgeVertex[cases.edges[cube][e]];
+						}
+					}
+				}
+				std::swap(current, next);
+			}
+		});
+		mesh.bounds.Add(mesh.vertices);
+		// Normals from the gradient at each vertex, central differences half a cell wide for fields that don't write it
+		if (frame)
+		{
+			const float step = 0.25f * cell;
+			internal::ParallelFor(context.Workers(), vertexCount, internal::ImplicitParallelChunk, [&](std::size_t begin, std::size_t end, std::uint32_t) {
+				ImplicitBatch batch, offset;
+				for (std::size_t first = begin; first < end; first += ImplicitBatch::Size)
+				{
+					batch.count = std::min(ImplicitBatch::Size, end - first);
+					for (std::size_t lane = 0; lane < ImplicitBatch::Size; lane++)
+					{
+						const float* position = &mesh.vertices[3 * (first + std::min(lane, batch.count - 1))];
+						batch.x[lane] = position[0];
+						batch.y[lane] = position[1];
+						batch.z[lane] = position[2];
+					}
+					batch.gradients = false;
+					field(batch);
+					if (!batch.gradients)
+					{
+						std::array<float, ImplicitBatch::Size>* gradient[3] = { &batch.gx, &batch.gy, &batch.gz };
+						offset.count = batch.count;
+						for (std::size_t axis = 0; axis < 3; axis++)
+						{
+							for (float side : { 1.0f, -1.0f })
+							{
+								offset.x = batch.x;
+								offset.y = batch.y;
+								offset.z = batch.z;
+								std::array<float, ImplicitBatch::Size>& moved = (axis == 0) ? offset.x : (axis == 1) ? offset.y : offset.z;
+								for (float& component : moved)
+								{
+									component += side * step;
+								}
+								field(offset);
+								for (std::size_t lane = 0; lane < ImplicitBatch::Size; lane++)
+								{
+									(*gradient[axis])[lane] = (side > 0.0f) ? offset.value[lane] : (*gradient[axis])[lane] - offset.value[lane];
+								}
+							}
+						}
+					}
+					for (std::size_t lane = 0; lane < batch.count; lane++)
+					{
+						const std::size_t index = first + lane;
+						const float gx = batch.gx[lane], gy = batch.gy[lane], gz = batch.gz[lane];
+						const float length = std::sqrtf(gx * gx + gy * gy + gz * gz);
+						const float inverseLength = (length != 0.0f) ? 1.0f / length : 0.0f;
+						mesh.normals[3 * index + 0] = gx * inverseLength;
+						mesh.normals[3 * index + 1] = gy * inverseLength;
+						mesh.normals[3 * index + 2] = gz * inverseLength;
+						if (!mesh.textureUVs.empty())
+						{
+							// Project along the axis the surface faces most
+							const float* position = &mesh.vertices[3 * index];
+							const float ax = std::fabs(gx), ay = std::fabs(gy), az = std::fabs(gz);
+							const std::size_t u = (ax >= ay && ax >= az) ? 1 : 0;
+							const std::size_t v = (az >= ax && az >= ay) ? 1 : 2;
+							mesh.textureUVs[2 * index + 0] = position[u] + 0.5f;
+							mesh.textureUVs[2 * index + 1] = position[v] + 0.5f;
+						}
+					}
+				}
+			});
+		}
+		if (hasTangents)
+		{
+			mesh.tangents = context.NewBuffer<float>(4 * vertexCount);
+			internal::CalculateTangents(mesh.vertices, mesh.normals, mesh.textureUVs, mesh.indices, mesh.tangents, context);
+		}
+		if (!hasNormals)
+		{
+			context.Recycle(std::move(mesh.normals));
+		}
+		if (!hasTextureUVs)
+		{
+			context.Recycle(std::move(mesh.textureUVs));
+		}
+		internal::ProcessMesh(mesh, settings);
+		return mesh;
+	}
+	/// <summary>
+	/// Generates the surface where an implicit field crosses 0, using a temporary context
+	/// </summary>
+	/// <param name="resolution">Number of cells along each axis</param>
+	/// <param name="field">Callable taking an ImplicitBatch&amp; that writes the value, and optionally the gradient, of each lane</param>
+	/// <param name="settings">Settings that affect how the mesh is generated</param>
+	/// <returns>Mesh data for the surface</returns>
+	template <typename IndexType = std::uint32_t, typename Field>
+	inline BasicMesh<IndexType> Implicit(std::uint32_t resolution, Field&& field, const GeneratorSetting& settings = GeneratorSetting())
+	{
+		GeneratorContext context;
+		return Implicit<IndexType>(context, resolution, std::forward<Field>(field), settings);
+	}
+}
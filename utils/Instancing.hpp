@@ -0,0 +1,220 @@
+#pragma once
+
+#include "../internal/GeneratorSetting.hpp"
+#include "../internal/Mesh.hpp"
+#include "../internal/Topology.hpp"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <stdexcept>
+
+namespace Construct
+{
+	/// <summary>
+	/// Per instance transform, a row major 3x4 matrix.
+	/// Each row is (m0, m1, m2, translation), so a vertex is transformed by matrix * (X, Y, Z, 1).
+	/// Tightly packed at 48 bytes, a vector of them can be uploaded directly as an instance buffer
+	/// </summary>
+	struct InstanceTransform
+	{
+		std::array<float, 12> matrix;
+		/// <summary>
+		/// Builds the matrix that ProcessMesh would apply for a setting: scale, then rotate, then offset
+		/// </summary>
+		/// <param name="settings">Settings holding the offset, scale and rotation</param>
+		/// <returns>Transform of the setting</returns>
+		static inline InstanceTransform FromSetting(const GeneratorSetting& settings)
+		{
+			const quat& q = settings.rotation;
+			const vec3& s = settings.scale;
+			const float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+			const float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+			const float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+			// Rotation matrix with each column multiplied by the scale of its axis
+			return InstanceTransform{ {
+				(1.0f - 2.0f * (yy + zz)) * s.x, 2.0f * (xy - wz) * s.y, 2.0f * (xz + wy) * s.z, settings.offset.x,
+				2.0f * (xy + wz) * s.x, (1.0f - 2.0f * (xx + zz)) * s.y, 2.0f * (yz - wx) * s.z, settings.offset.y,
+				2.0f * (xz - wy) * s.x, 2.0f * (yz + wx) * s.y, (1.0f - 2.0f * (xx + yy)) * s.z, settings.offset.z,
+			} };
+		}
+	};
+	/// <summary>
+	/// One canonical mesh drawn many times, each with its own transform
+	/// </summary>
+	template <typename IndexType>
+	struct BasicInstancedMesh
+	{
+		/// <summary>
+		/// Mesh generated without any offset, scale or rotation
+		/// </summary>
+		BasicMesh<IndexType> mesh;
+		/// <summary>
+		/// Transform of every instance
+		/// </summary>
+		std::vector<InstanceTransform> instances;
+	};
+	/// <summary>
+	/// Instanced mesh with 32-bit indices
+	/// </summary>
+	using InstancedMesh = BasicInstancedMesh<std::uint32_t>;
+	/// <summary>
+	/// Strips the offset, scale and rotation from a setting, keeping everything else.
+	/// Canonical meshes for instancing are generated with it
+	/// </summary>
+	inline GeneratorSetting CanonicalSetting(const GeneratorSetting& settings)
+	{
+		GeneratorSetting canonical = settings;
+		canonical.offset = vec3(0.0f, 0.0f, 0.0f);
+		canonical.scale = vec3(1.0f, 1.0f, 1.0f);
+		canonical.rotation = quat(0.0f, 0.0f, 0.0f, 1.0f);
+		return canonical;
+	}
+	/// <summary>
+	/// Packs the transforms of settings into an instance buffer
+	/// </summary>
+	/// <param name="settings">Settings of every instance</param>
+	/// <returns>Transform of every instance, in the same order</returns>
+	inline std::vector<InstanceTransform> PackInstances(const std::vector<GeneratorSetting>& settings)
+	{
+		std::vector<InstanceTransform> instances;
+		instances.reserve(settings.size());
+		for (const GeneratorSetting& setting : settings)
+		{
+			instances.push_back(InstanceTransform::FromSetting(setting));
+		}
+		return instances;
+	}
+	/// <summary>
+	/// Generates one canonical mesh for many settings, instead of baking every transform into its own copy of the mesh.
+	/// For example GenerateInstanced(settings, [&](const GeneratorSetting& setting) { return Cylinder(16, setting); }).
+	/// Throws std::invalid_argument if settings is empty or the settings differ in anything but their transform
+	/// </summary>
+	/// <param name="settings">Settings of every instance</param>
+	/// <param name="generator">Callable taking a GeneratorSetting and returning a mesh, called once</param>
+	/// <returns>Canonical mesh and the transform of every instance</returns>
+	template <typename Generator>
+	inline auto GenerateInstanced(const std::vector<GeneratorSetting>& settings, Generator&& generator)
+	{
+		if (settings.empty())
+		{
+			throw std::invalid_argument("Construct: instancing needs at least one setting");
+		}
+		const GeneratorSetting canonical = CanonicalSetting(settings.front());
+		for (const GeneratorSetting& setting : settings)
+		{
+			if (setting.windingOrder != canonical.windingOrder || setting.topology != canonical.topology || setting.attributes != canonical.attributes || setting.vertexOrder != canonical.vertexOrder)
+			{
+				throw std::invalid_argument("Construct: instanced settings can only differ in offset, scale and rotation");
+			}
+		}
+		auto mesh = generator(canonical);
+		using IndexType = typename decltype(mesh.indices)::value_type;
+		return BasicInstancedMesh<IndexType>{ std::move(mesh), PackInstances(settings) };
+	}
+	/// <summary>
+	/// Expands instances into one merged mesh, for consumers that can't draw instances.
+	/// Gives the same result as generating each instance with its transform baked in and merging them, unless the mesh was reordered along a space filling curve.
+	/// Throws std::overflow_error if the expanded mesh has more vertices than the index type can address
+	/// </summary>
+	/// <param name="mesh">Canonical mesh</param>
+	/// <param name="instances">Transform of every instance</param>
+	/// <returns>Mesh with every instance transformed, in the topology of the canonical mesh</returns>
+	template <typename IndexType>
+	inline BasicMesh<IndexType> ExpandInstances(const BasicMesh<IndexType>& mesh, const std::vector<InstanceTransform>& instances)
+	{
+		const std::size_t vertexCount = mesh.vertices.size() / 3;
+		internal::CheckedVertexCount<IndexType>(internal::CheckedMultiply(vertexCount, instances.size()));
+		// Strips of different instances must not be joined together
+		const bool separateStrips = mesh.topology == Topology::TriangleStrip && !mesh.indices.empty() && mesh.indices.back() != PrimitiveRestart<IndexType>;
+		const std::size_t indicesPerInstance = mesh.indices.size() + (separateStrips ? 1 : 0);
+		BasicMesh<IndexType> expanded(mesh.vertices.size() * instances.size(), indicesPerInstance * instances.size(),
+			mesh.normals.size() * instances.size(), mesh.textureUVs.size() * instances.size(), mesh.tangents.size() * instances.size());
+		expanded.topology = mesh.topology;
+		for (std::size_t instance = 0; instance < instances.size(); instance++)
+		{
+			const std::array<float, 12>& m = instances[instance].matrix;
+			const std::size_t baseVertex = instance * vertexCount;
+			// Positions
+			for (std::size_t i = 0; i < vertexCount; i++)
+			{
+				const float x = mesh.vertices[3 * i + 0], y = mesh.vertices[3 * i + 1], z = mesh.vertices[3 * i + 2];
+				float* output = &expanded.vertices[3 * (baseVertex + i)];
+				output[0] = m[0] * x + m[1] * y + m[2] * z + m[3];
+				output[1] = m[4] * x + m[5] * y + m[6] * z + m[7];
+				output[2] = m[8] * x + m[9] * y + m[10] * z + m[11];
+			}
+			// Normals use the inverse transpose, which is the cofactor matrix divided by the determinant.
+			// Only the sign of the determinant matters as the normals are renormalised
+			if (!mesh.normals.empty())
+			{
+				const std::array<float, 9> cofactor = {
+					m[5] * m[10] - m[6] * m[9], m[6] * m[8] - m[4] * m[10], m[4] * m[9] - m[5] * m[8],
+					m[2] * m[9] - m[1] * m[10], m[0] * m[10] - m[2] * m[8], m[1] * m[8] - m[0] * m[9],
+					m[1] * m[6] - m[2] * m[5], m[2] * m[4] - m[0] * m[6], m[0] * m[5] - m[1] * m[4],
+				};
+				const float determinant = m[0] * cofactor[0] + m[1] * cofactor[1] + m[2] * cofactor[2];
+				const float orientation = (determinant < 0.0f) ? -1.0f : 1.0f;
+				for (std::size_t i = 0; i < vertexCount; i++)
+				{
+					const float x = mesh.normals[3 * i + 0], y = mesh.normals[3 * i + 1], z = mesh.normals[3 * i + 2];
+					const float nx = cofactor[0] * x + cofactor[1] * y + cofactor[2] * z;
+					const float ny = cofactor[3] * x + cofactor[4] * y + cofactor[5] * z;
+					const float nz = cofactor[6] * x + cofactor[7] * y + cofactor[8] * z;
+					const float length = std::sqrtf(nx * nx + ny * ny + nz * nz);
+					const float inverseLength = (length != 0.0f) ? orientation / length : 0.0f;
+					float* output = &expanded.normals[3 * (baseVertex + i)];
+					output[0] = nx * inverseLength;
+					output[1] = ny * inverseLength;
+					output[2] = nz * inverseLength;
+				}
+			}
+			// Tangents follow the surface like positions, the handedness is kept
+			for (std::size_t i = 0, size = mesh.tangents.size() / 4; i < size; i++)
+			{
+				const float x = mesh.tangents[4 * i + 0], y = mesh.tangents[4 * i + 1], z = mesh.tangents[4 * i + 2];
+				const float tx = m[0] * x + m[1] * y + m[2] * z;
+				const float ty = m[4] * x + m[5] * y + m[6] * z;
+				const float tz = m[8] * x + m[9] * y + m[10] * z;
+				const float length = std::sqrtf(tx * tx + ty * ty + tz * tz);
+				const float inverseLength = (length != 0.0f) ? 1.0f / length : 0.0f;
+				float* output = &expanded.tangents[4 * (baseVertex + i)];
+				output[0] = tx * inverseLength;
+				output[1] = ty * inverseLength;
+				output[2] = tz * inverseLength;
+				output[3] = mesh.tangents[4 * i + 3];
+			}
+			// Texture UVs are copied as is
+			std::copy(mesh.textureUVs.begin(), mesh.textureUVs.end(), expanded.textureUVs.begin() + instance * mesh.textureUVs.size());
+			// Indices are offset to the vertices of the instance
+			IndexType* indexOutput = &expanded.indices[instance * indicesPerInstance];
+			for (IndexType index : mesh.indices)
+			{
+				*indexOutput++ = (mesh.topology == Topology::TriangleStrip && index == PrimitiveRestart<IndexType>) ? index : static_cast<IndexType>(index + baseVertex);
+			}
+			if (separateStrips)
+			{
+				*indexOutput = PrimitiveRestart<IndexType>;
+			}
+		}
+		// The trailing restart isn't needed
+		if (separateStrips && !expanded.indices.empty())
+		{
+			expanded.indices.pop_back();
+		}
+		expanded.bounds = Bounds::FromVertices(expanded.vertices);
+		return expanded;
+	}
+	/// <summary>
+	/// Expands an instanced mesh into one merged mesh, for consumers that can't draw instances
+	/// </summary>
+	/// <param name="instanced">Canonical mesh and the transform of every instance</param>
+	/// <returns>Mesh with every instance transformed</returns>
+	template <typename IndexType>
+	inline BasicMesh<IndexType> ExpandInstances(const BasicInstancedMesh<IndexType>& instanced)
+	{
+		return ExpandInstances(instanced.mesh, instanced.instances);
+	}
+}
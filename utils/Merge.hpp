@@ -1,34 +1,85 @@
 #pragma once
 
 #include "../internal/Mesh.hpp"
+#include "../internal/Topology.hpp"
+
+#include <stdexcept>
 
 namespace Construct
 {
 	/// <summary>
-	/// Naively merges meshes into one mesh
+	/// Naively merges meshes into one mesh.
+	/// The result is a triangle strip if every mesh is a strip, otherwise strips are expanded to triangle lists.
+	/// Throws std::invalid_argument if the meshes have different vertex attributes,
+	/// and std::overflow_error if the merged mesh has more vertices than the index type can address
 	/// </summary>
 	/// <param name="meshes">A vector of pointers to meshes</param>
 	/// <returns>Merged mesh</returns>
-    inline Mesh Merge(const std::vector<Mesh*>& meshes)
+    template <typename IndexType>
+    inline BasicMesh<IndexType> Merge(const std::vector<BasicMesh<IndexType>*>& meshes)
     {
-        Mesh mergedMesh;
-        std::uint32_t currentIndex = 0;
-        for (Mesh* mesh : meshes)
+        BasicMesh<IndexType> mergedMesh;
+        IndexType currentIndex = 0;
+        // Keep strips only if there is nothing else to merge with
+        bool allStrips = !meshes.empty();
+        std::uint64_t vertexCount = 0;
+        for (BasicMesh<IndexType>* mesh : meshes)
+        {
+            // Attributes only some meshes have would belong to the wrong vertices once concatenated
+            if (mesh->normals.empty() != meshes.front()->normals.empty() || mesh->textureUVs.empty() != meshes.front()->textureUVs.empty() || mesh->tangents.empty() != meshes.front()->tangents.empty())
+            {
+                throw std::invalid_argument("Construct: merged meshes must all have the same vertex attributes");
+            }
+            allStrips = allStrips && mesh->topology == Topology::TriangleStrip;
+            vertexCount += mesh->vertices.size() / 3;
+        }
+        internal::CheckedVertexCount<IndexType>(vertexCount);
+        mergedMesh.topology = allStrips ? Topology::TriangleStrip : Topology::TriangleList;
+        for (BasicMesh<IndexType>* mesh : meshes)
         {
             // Add vertices to the merged mesh
             mergedMesh.vertices.insert(mergedMesh.vertices.end(), mesh->vertices.begin(), mesh->vertices.end());
             // Add indices to the merged mesh
-            for (std::uint32_t index : mesh->indices)
+            if (allStrips)
+            {
+                // Strips of different meshes must not be joined together
+                if (!mergedMesh.indices.empty() && mergedMesh.indices.back() != PrimitiveRestart<IndexType>)
+                {
+                    mergedMesh.indices.push_back(PrimitiveRestart<IndexType>);
+                }
+                for (IndexType index : mesh->indices)
+                {
+                    mergedMesh.indices.push_back(index == PrimitiveRestart<IndexType> ? index : static_cast<IndexType>(index + currentIndex));
+                }
+            }
+            else
             {
-                mergedMesh.indices.push_back(index + currentIndex);
+                internal::ForEachTriangle(mesh->indices, mesh->topology, [&](IndexType i1, IndexType i2, IndexType i3) {
+                    mergedMesh.indices.push_back(static_cast<IndexType>(i1 + currentIndex));
+                    mergedMesh.indices.push_back(static_cast<IndexType>(i2 + currentIndex));
+                    mergedMesh.indices.push_back(static_cast<IndexType>(i3 + currentIndex));
+                });
             }
             // Add normals to the merged mesh
             mergedMesh.normals.insert(mergedMesh.normals.end(), mesh->normals.begin(), mesh->normals.end());
             // Add textureUVs to the merged mesh
             mergedMesh.textureUVs.insert(mergedMesh.textureUVs.end(), mesh->textureUVs.begin(), mesh->textureUVs.end());
+            // Add tangents to the merged mesh
+            mergedMesh.tangents.insert(mergedMesh.tangents.end(), mesh->tangents.begin(), mesh->tangents.end());
+            // Combine bounds, calculating them for meshes that weren't generated
+            mergedMesh.bounds.Add((mesh->bounds.Empty() && !mesh->vertices.empty()) ? Bounds::FromVertices(mesh->vertices) : mesh->bounds);
             // Update the current index to be the last vertex index + 1
-            currentIndex += mesh->vertices.size() / 3;
+            currentIndex += static_cast<IndexType>(mesh->vertices.size() / 3);
         }
         return mergedMesh;
     }
-}
\ No newline at end of file
+	/// <summary>
+	/// Merges 32-bit meshes, allows Merge({ &a, &b }) where the index type can't be deduced
+	/// </summary>
+	/// <param name="meshes">A vector of pointers to meshes</param>
+	/// <returns>Merged mesh</returns>
+    inline Mesh Merge(const std::vector<Mesh*>& meshes)
+    {
+        return Merge<std::uint32_t>(meshes);
+    }
+}
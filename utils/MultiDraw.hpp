@@ -0,0 +1,222 @@
+#pragma once
+
+#include "../internal/Mesh.hpp"
+#include "../internal/Topology.hpp"
+
+#include <algorithm>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace Construct
+{
+	/// <summary>
+	/// Indexed indirect draw command, laid out like DrawElementsIndirectCommand in OpenGL and VkDrawIndexedIndirectCommand in Vulkan
+	/// </summary>
+	struct DrawElementsIndirectCommand
+	{
+		/// <summary>
+		/// Number of indices to draw
+		/// </summary>
+		std::uint32_t count;
+		/// <summary>
+		/// Number of instances to draw
+		/// </summary>
+		std::uint32_t instanceCount;
+		/// <summary>
+		/// First index of the draw in the shared index buffer
+		/// </summary>
+		std::uint32_t firstIndex;
+		/// <summary>
+		/// Added to every index of the draw, the first vertex of the mesh in the shared vertex buffers
+		/// </summary>
+		std::int32_t baseVertex;
+		/// <summary>
+		/// First instance of the draw, the index of the mesh that was packed so per draw data can be looked up
+		/// </summary>
+		std::uint32_t baseInstance;
+	};
+	/// <summary>
+	/// Meshes packed into shared buffers, with an indirect draw command and bounds for each mesh
+	/// </summary>
+	template <typename IndexType>
+	struct BasicMultiDrawBuffer
+	{
+		/// <summary>
+		/// Shared buffers of every packed mesh.
+		/// Indices are relative to the first vertex of their mesh, which is given by DrawElementsIndirectCommand::baseVertex
+		/// </summary>
+		BasicMesh<IndexType> mesh;
+		/// <summary>
+		/// Draw command of every packed mesh, in the order the meshes were given
+		/// </summary>
+		std::vector<DrawElementsIndirectCommand> commands;
+		/// <summary>
+		/// Bounds of every draw command, for culling on the GPU
+		/// </summary>
+		std::vector<Bounds> bounds;
+	};
+	/// <summary>
+	/// Multi draw buffer with 32-bit indices
+	/// </summary>
+	using MultiDrawBuffer = BasicMultiDrawBuffer<std::uint32_t>;
+	namespace internal
+	{
+		/// <summary>
+		/// FNV-1a hash of the bytes of a vector
+		/// </summary>
+		template <typename T>
+		inline std::uint64_t HashBytes(const std::vector<T>& data, std::uint64_t hash)
+		{
+			const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data.data());
+			for (std::size_t i = 0, size = data.size() * sizeof(T); i < size; i++)
+			{
+				hash = (hash ^ bytes[i]) * 1099511628211ull;
+			}
+			// Separates the vectors so moving data between them changes the hash
+			return (hash ^ data.size()) * 1099511628211ull;
+		}
+		/// <summary>
+		/// Hash of every buffer of a mesh, identical meshes have identical hashes
+		/// </summary>
+		template <typename IndexType>
+		inline std::uint64_t HashMesh(const BasicMesh<IndexType>& mesh)
+		{
+			std::uint64_t hash = 14695981039346656037ull ^ static_cast<std::uint64_t>(mesh.topology);
+			hash = HashBytes(mesh.vertices, hash);
+			hash = HashBytes(mesh.indices, hash);
+			hash = HashBytes(mesh.normals, hash);
+			hash = HashBytes(mesh.textureUVs, hash);
+			return HashBytes(mesh.tangents, hash);
+		}
+		/// <summary>
+		/// Whether two meshes have bitwise identical buffers
+		/// </summary>
+		template <typename IndexType>
+		inline bool IdenticalMeshes(const BasicMesh<IndexType>& lhs, const BasicMesh<IndexType>& rhs)
+		{
+			auto sameBytes = [](const auto& a, const auto& b) {
+				return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(a[0])) == 0);
+			};
+			return lhs.topology == rhs.topology && sameBytes(lhs.vertices, rhs.vertices) && sameBytes(lhs.indices, rhs.indices) &&
+				sameBytes(lhs.normals, rhs.normals) && sameBytes(lhs.textureUVs, rhs.textureUVs) && sameBytes(lhs.tangents, rhs.tangents);
+		}
+	}
+	/// <summary>
+	/// Packs meshes into shared vertex and index buffers for multi draw indirect rendering.
+	/// Every mesh gets its own draw command and bounds, meshes with identical buffers share one suballocation.
+	/// The result is a triangle strip if every mesh is a strip, otherwise strips are expanded to triangle lists.
+	/// Throws std::invalid_argument if the meshes have different vertex attributes or an alignment is 0,
+	/// and std::overflow_error if the buffers outgrow the 32-bit fields of the draw commands
+	/// </summary>
+	/// <param name="meshes">A vector of pointers to meshes</param>
+	/// <param name="vertexAlignment">Each mesh starts at a multiple of this many vertices, padding is zeroed</param>
+	/// <param name="indexAlignment">Each mesh starts at a multiple of this many indices, padding is zeroed</param>
+	/// <returns>Shared buffers, draw commands and bounds</returns>
+	template <typename IndexType>
+	inline BasicMultiDrawBuffer<IndexType> PackMultiDraw(const std::vector<BasicMesh<IndexType>*>& meshes, std::uint32_t vertexAlignment = 1, std::uint32_t indexAlignment = 1)
+	{
+		if (vertexAlignment == 0 || indexAlignment == 0)
+		{
+			throw std::invalid_argument("Construct: multi draw alignment must be at least 1");
+		}
+		if (meshes.size() > std::numeric_limits<std::uint32_t>::max())
+		{
+			throw std::overflow_error("Construct: too many meshes for the base instance of the draw commands");
+		}
+		BasicMultiDrawBuffer<IndexType> packed;
+		if (meshes.empty())
+		{
+			return packed;
+		}
+		// Every mesh shares the same buffers, so they must have the same attributes
+		const BasicMesh<IndexType>& first = *meshes.front();
+		bool allStrips = true;
+		for (BasicMesh<IndexType>* mesh : meshes)
+		{
+			if (mesh->normals.empty() != first.normals.empty() || mesh->textureUVs.empty() != first.textureUVs.empty() || mesh->tangents.empty() != first.tangents.empty())
+			{
+				throw std::invalid_argument("Construct: packed meshes must all have the same vertex attributes");
+			}
+			allStrips = allStrips && mesh->topology == Topology::TriangleStrip;
+		}
+		const Topology topology = allStrips ? Topology::TriangleStrip : Topology::TriangleList;
+		packed.mesh.topology = topology;
+		// Lay out the unique meshes, duplicates reuse the command of the first copy
+		std::unordered_map<std::uint64_t, std::vector<std::size_t>> uniqueMeshes;
+		std::vector<std::vector<IndexType>> convertedIndices;
+		std::vector<std::size_t> uniqueIndices;
+		std::uint64_t vertexCount = 0, indexCount = 0;
+		packed.commands.reserve(meshes.size());
+		packed.bounds.reserve(meshes.size());
+		for (std::size_t i = 0; i < meshes.size(); i++)
+		{
+			const BasicMesh<IndexType>& mesh = *meshes[i];
+			std::vector<std::size_t>& candidates = uniqueMeshes[internal::HashMesh(mesh)];
+			auto duplicate = std::find_if(candidates.begin(), candidates.end(), [&](std::size_t candidate) {
+				return meshes[candidate] == meshes[i] || internal::IdenticalMeshes(*meshes[candidate], mesh);
+			});
+			if (duplicate != candidates.end())
+			{
+				DrawElementsIndirectCommand command = packed.commands[*duplicate];
+				command.baseInstance = static_cast<std::uint32_t>(i);
+				packed.commands.push_back(command);
+				packed.bounds.push_back(packed.bounds[*duplicate]);
+				continue;
+			}
+			candidates.push_back(i);
+			uniqueIndices.push_back(i);
+			// Indices stay relative to the mesh, so only strips that are merged with lists need converting
+			convertedIndices.push_back(topology == mesh.topology ? std::vector<IndexType>() : internal::ToTriangleList(mesh.indices, mesh.topology));
+			const std::size_t meshIndexCount = (topology == mesh.topology) ? mesh.indices.size() : convertedIndices.back().size();
+			vertexCount = internal::AlignUp(vertexCount, vertexAlignment);
+			indexCount = internal::AlignUp(indexCount, indexAlignment);
+			if (vertexCount > static_cast<std::uint64_t>(std::numeric_limits<std::int32_t>::max()) ||
+				indexCount > std::numeric_limits<std::uint32_t>::max() ||
+				meshIndexCount > std::numeric_limits<std::uint32_t>::max() - indexCount)
+			{
+				throw std::overflow_error("Construct: packed buffers exceed the range of the draw commands");
+			}
+			packed.commands.push_back(DrawElementsIndirectCommand{
+				static_cast<std::uint32_t>(meshIndexCount), 1, static_cast<std::uint32_t>(indexCount), static_cast<std::int32_t>(vertexCount), static_cast<std::uint32_t>(i),
+			});
+			packed.bounds.push_back((mesh.bounds.Empty() && !mesh.vertices.empty()) ? Bounds::FromVertices(mesh.vertices) : mesh.bounds);
+			vertexCount = internal::CheckedAdd(vertexCount, mesh.vertices.size() / 3);
+			indexCount += meshIndexCount;
+		}
+		// Copy the unique meshes into place, padding is left zeroed
+		const std::size_t totalVertices = internal::CheckedVertexCount<std::uint64_t>(vertexCount);
+		const std::size_t totalIndices = internal::CheckedIndexCount<IndexType>(indexCount);
+		packed.mesh = BasicMesh<IndexType>(3 * totalVertices, totalIndices,
+			first.normals.empty() ? 0 : 3 * totalVertices, first.textureUVs.empty() ? 0 : 2 * totalVertices, first.tangents.empty() ? 0 : 4 * totalVertices);
+		packed.mesh.topology = topology;
+		for (std::size_t u = 0; u < uniqueIndices.size(); u++)
+		{
+			const BasicMesh<IndexType>& mesh = *meshes[uniqueIndices[u]];
+			const DrawElementsIndirectCommand& command = packed.commands[uniqueIndices[u]];
+			const std::size_t baseVertex = static_cast<std::size_t>(command.baseVertex);
+			std::copy(mesh.vertices.begin(), mesh.vertices.end(), packed.mesh.vertices.begin() + 3 * baseVertex);
+			std::copy(mesh.normals.begin(), mesh.normals.end(), packed.mesh.normals.begin() + 3 * baseVertex);
+			std::copy(mesh.textureUVs.begin(), mesh.textureUVs.end(), packed.mesh.textureUVs.begin() + 2 * baseVertex);
+			std::copy(mesh.tangents.begin(), mesh.tangents.end(), packed.mesh.tangents.begin() + 4 * baseVertex);
+			const std::vector<IndexType>& indices = (topology == mesh.topology) ? mesh.indices : convertedIndices[u];
+			std::copy(indices.begin(), indices.end(), packed.mesh.indices.begin() + command.firstIndex);
+			packed.mesh.bounds.Add(packed.bounds[uniqueIndices[u]]);
+		}
+		return packed;
+	}
+	/// <summary>
+	/// Packs 32-bit meshes, allows PackMultiDraw({ &a, &b }) where the index type can't be deduced
+	/// </summary>
+	/// <param name="meshes">A vector of pointers to meshes</param>
+	/// <param name="vertexAlignment">Each mesh starts at a multiple of this many vertices, padding is zeroed</param>
+	/// <param name="indexAlignment">Each mesh starts at a multiple of this many indices, padding is zeroed</param>
+	/// <returns>Shared buffers, draw commands and bounds</returns>
+	inline MultiDrawBuffer PackMultiDraw(const std::vector<Mesh*>& meshes, std::uint32_t vertexAlignment = 1, std::uint32_t indexAlignment = 1)
+	{
+		return PackMultiDraw<std::uint32_t>(meshes, vertexAlignment, indexAlignment);
+	}
+}
@@ -0,0 +1,339 @@
+#pragma once
+
+#include "../internal/GeneratorContext.hpp"
+#include "../internal/GeneratorSetting.hpp"
+#include "../internal/GridIndices.hpp"
+#include "../internal/Mesh.hpp"
+#include "../internal/Parallel.hpp"
+#include "../internal/ProcessMesh.hpp"
+#include "./Compact.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace Construct
+{
+	/// <summary>
+	/// Batch of (u, v) parameters a parametric surface is evaluated at, laid out as one array per component so a surface can be vectorised.
+	/// Lanes past count repeat the last parameter, so a surface can loop over all Size lanes without a remainder
+	/// </summary>
+	struct ParametricBatch
+	{
+		/// <summary>
+		/// Lanes per batch
+		/// </summary>
+		static constexpr std::size_t Size = 8;
+		/// <summary>
+		/// Lanes holding vertices of the mesh
+		/// </summary>
+		std::size_t count = 0;
+		/// <summary>
+		/// Parameters in [0, 1], u runs along a row of the grid and v from row to row
+		/// </summary>
+		alignas(32) std::array<float, Size> u, v;
+		/// <summary>
+		/// Position output
+		/// </summary>
+		alignas(32) std::array<float, Size> x, y, z;
+		/// <summary>
+		/// Optional partial derivative output along u (dux, duy, duz) and along v (dvx, dvy, dvz)
+		/// </summary>
+		alignas(32) std::array<float, Size> dux, duy, duz, dvx, dvy, dvz;
+		/// <summary>
+		/// Set by a surface that wrote the partial derivatives, normals and tangents are then exact.
+		/// Otherwise they are taken from the differences between neighbouring vertices
+		/// </summary>
+		bool derivatives = false;
+	};
+	namespace internal
+	{
+		/// <summary>
+		/// Number of vertices per chunk when a parametric surface is split across threads by rows
+		/// </summary>
+		inline constexpr std::size_t ParametricParallelChunk = 1 << 14;
+		/// <summary>
+		/// Squared length, relative to the squared size of the mesh, below which a grid edge counts as collapsed
+		/// </summary>
+		inline constexpr float ParametricCollapsedEdge = 1e-12f;
+		inline float LengthSquared(const std::array<float, 3>& a)
+		{
+			return a[0] * a[0] + a[1] * a[1] + a[2] * a[2];
+		}
+		inline std::array<float, 3> Cross(const std::array<float, 3>& a, const std::array<float, 3>& b)
+		{
+			return { a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+		}
+	}
+	/// <summary>
+	/// Torus around the y axis, (u, v) is (angle around the y axis, angle around the tube), with exact derivatives
+	/// </summary>
+	struct TorusSurface
+	{
+		/// <summary>
+		/// Distance from the center to the middle of the tube
+		/// </summary>
+		float majorRadius = 0.375f;
+		/// <summary>
+		/// Radius of the tube
+		/// </summary>
+		float minorRadius = 0.125f;
+		inline void operator()(ParametricBatch& batch) const
+		{
+			constexpr float Tau = 2.0f * std::numbers::pi_v<float>;
+			for (std::size_t i = 0; i < ParametricBatch::Size; i++)
+			{
+				const float phi = -Tau * batch.u[i], theta = Tau * batch.v[i];
+				const float cosPhi = std::cosf(phi), sinPhi = std::sinf(phi);
+				const float cosTheta = std::cosf(theta), sinTheta = std::sinf(theta);
+				const float ring = this->majorRadius + this->minorRadius * cosTheta;
+				batch.x[i] = ring * cosPhi;
+				batch.y[i] = this->minorRadius * sinTheta;
+				batch.z[i] = ring * sinPhi;
+				batch.dux[i] = Tau * ring * sinPhi;
+				batch.duy[i] = 0.0f;
+				batch.duz[i] = -Tau * ring * cosPhi;
+				batch.dvx[i] = -Tau * this->minorRadius * sinTheta * cosPhi;
+				batch.dvy[i] = Tau * this->minorRadius * cosTheta;
+				batch.dvz[i] = -Tau * this->minorRadius * sinTheta * sinPhi;
+			}
+			batch.derivatives = true;
+		}
+	};
+	/// <summary>
+	/// Number of vertices a parametric surface is generated with, before collapsed rows are compacted
+	/// </summary>
+	inline std::uint64_t ParametricVertexCount(std::uint32_t uSegments, std::uint32_t vSegments)
+	{
+		return internal::CheckedMultiply(static_cast<std::uint64_t>(uSegments) + 1, static_cast<std::uint64_t>(vSegments) + 1);
+	}
+	/// <summary>
+	/// Generates the mesh of any surface p(u, v) over [0, 1] x [0, 1], on the same grid and topology as UVSphere and Plane.
+	/// The surface is called with batches of ParametricBatch::Size vertices from several threads at once, so it must be safe to call concurrently.
+	/// Front faces are on the side of dp/du x dp/dv, texture UVs are (u, v) and tangents follow dp/du.
+	/// Seams where the first and last row or column meet get smooth normals, and the zero area triangles of rows or columns
+	/// that collapse to a point (such as poles) are removed from triangle lists.
+	/// Throws std::invalid_argument if uSegments or vSegments is 0
+	/// </summary>
+	/// <param name="context">Context whose buffers are reused, see GeneratorContext</param>
+	/// <param name="uSegments">Number of quads along u</param>
+	/// <param name="vSegments">Number of quads along v</param>
+	/// <param name="surface">Callable taking a ParametricBatch& that writes the position, and optionally the partial derivatives, of each lane</param>
+	/// <param name="settings">Settings that affect how the mesh is generated</param>
+	/// <returns>Mesh data for the surface</returns>
+	template <typename IndexType = std::uint32_t, typename Surface>
+	inline BasicMesh<IndexType> Parametric(GeneratorContext& context, std::uint32_t uSegments, std::uint32_t vSegments, Surface&& surface, const GeneratorSetting& settings = GeneratorSetting())
+	{
+		if (uSegments == 0 || vSegments == 0)
+		{
+			throw std::invalid_argument("Construct: a parametric surface needs at least one segment along u and v");
+		}
+		const std::size_t vertexCount = internal::CheckedVertexCount<IndexType>(ParametricVertexCount(uSegments, vSegments));
+		const std::size_t indexCount = internal::CheckedIndexCount<IndexType>(internal::GridIndexCount(vSegments, uSegments, settings.topology));
+		const bool hasNormals = settings.HasAttribute(VertexAttribute::Normal);
+		const bool hasTextureUVs = settings.HasAttribute(VertexAttribute::TextureUV);
+		const bool hasTangents = settings.HasAttribute(VertexAttribute::Tangent);
+		BasicMesh<IndexType> mesh = context.NewMesh<IndexType>(3 * vertexCount, indexCount, hasNormals ? 3 * vertexCount : 0, hasTextureUVs ? 2 * vertexCount : 0, hasTangents ? 4 * vertexCount : 0);
+		mesh.topology = settings.topology;
+		const std::size_t columns = static_cast<std::size_t>(uSegments) + 1, rows = static_cast<std::size_t>(vSegments) + 1;
+		const std::size_t rowsPerChunk = std::max<std::size_t>(1, internal::ParametricParallelChunk / columns);
+		// Derivatives are only kept when the surface writes them and the frame is needed
+		const bool frame = hasNormals || hasTangents;
+		std::vector<float>& derivativesU = context.Scratch<float>(0);
+		std::vector<float>& derivativesV = context.Scratch<float>(1);
+		derivativesU.resize(frame ? 3 * vertexCount : 0);
+		derivativesV.resize(frame ? 3 * vertexCount : 0);
+		const std::uint32_t chunks = internal::ChunkCount(rows, rowsPerChunk);
+		std::vector<std::uint8_t>& chunkDerivatives = context.Scratch<std::uint8_t>(0);
+		chunkDerivatives.assign(chunks, 1);
+		// Evaluate the surface a row at a time, in batches along the row
+		internal::ParallelFor(context.Workers(), rows, rowsPerChunk, [&](std::size_t begin, std::size_t end, std::uint32_t chunk) {
+			ParametricBatch batch;
+			for (std::size_t i = begin; i < end; i++)
+			{
+				const float v = static_cast<float>(i) / static_cast<float>(vSegments);
+				for (std::size_t first = 0; first < columns; first += ParametricBatch::Size)
+				{
+					batch.count = std::min(ParametricBatch::Size, columns - first);
+					for (std::size_t lane = 0; lane < ParametricBatch::Size; lane++)
+					{
+						batch.u[lane] = static_cast<float>(first + std::min(lane, batch.count - 1)) / static_cast<float>(uSegments);
+						batch.v[lane] = v;
+					}
+					batch.derivatives = false;
+					surface(batch);
+					chunkDerivatives[chunk] &= batch.derivatives ? 1 : 0;
+					for (std::size_t lane = 0; lane < batch.count; lane++)
+					{
+						const std::size_t index = i * columns + first + lane;
+						mesh.vertices[3 * index + 0] = batch.x[lane];
+						mesh.vertices[3 * index + 1] = batch.y[lane];
+						mesh.vertices[3 * index + 2] = batch.z[lane];
+						if (hasTextureUVs)
+						{
+							mesh.textureUVs[2 * index + 0] = batch.u[lane];
+							mesh.textureUVs[2 * index + 1] = v;
+						}
+						if (frame && batch.derivatives)
+						{
+							derivativesU[3 * index + 0] = batch.dux[lane];
+							derivativesU[3 * index + 1] = batch.duy[lane];
+							derivativesU[3 * index + 2] = batch.duz[lane];
+							derivativesV[3 * index + 0] = batch.dvx[lane];
+							derivativesV[3 * index + 1] = batch.dvy[lane];
+							derivativesV[3 * index + 2] = batch.dvz[lane];
+						}
+					}
+				}
+			}
+		});
+		mesh.bounds.Add(mesh.vertices);
+		const bool analytic = std::all_of(chunkDerivatives.begin(), chunkDerivatives.end(), [](std::uint8_t derivatives) { return derivatives != 0; });
+		auto position = [&](std::size_t i, std::size_t j) {
+			const float* p = &mesh.vertices[3 * (i * columns + j)];
+			return std::array<float, 3>{ p[0], p[1], p[2] };
+		};
+		auto difference = [](const std::array<float, 3>& a, const std::array<float, 3>& b) {
+			return std::array<float, 3>{ a[0] - b[0], a[1] - b[1], a[2] - b[2] };
+		};
+		const float extent = mesh.bounds.Empty() ? 0.0f : internal::LengthSquared(difference({ mesh.bounds.max.x, mesh.bounds.max.y, mesh.bounds.max.z }, { mesh.bounds.min.x, mesh.bounds.min.y, mesh.bounds.min.z }));
+		const float collapsed = internal::ParametricCollapsedEdge * extent;
+		// Closed directions wrap around for their differences, so seams get the same normal on both sides
+		auto sameSpot = [&](const std::array<float, 3>& a, const std::array<float, 3>& b) { return internal::LengthSquared(difference(a, b)) <= collapsed; };
+		bool wrapU = uSegments > 1, wrapV = vSegments > 1;
+		for (std::size_t i = 0; i < rows && wrapU; i++)
+		{
+			wrapU = sameSpot(position(i, 0), position(i, uSegments));
+		}
+		for (std::size_t j = 0; j < columns && wrapV; j++)
+		{
+			wrapV = sameSpot(position(0, j), position(vSegments, j));
+		}
+		auto derivativeU = [&](std::size_t i, std::size_t j) {
+			if (analytic)
+			{
+				const float* d = &derivativesU[3 * (i * columns + j)];
+				return std::array<float, 3>{ d[0], d[1], d[2] };
+			}
+			const std::size_t previous = (j > 0) ? j - 1 : (wrapU ? uSegments - 1 : 0);
+			const std::size_t next = (j < uSegments) ? j + 1 : (wrapU ? 1 : uSegments);
+			return difference(position(i, next), position(i, previous));
+		};
+		auto derivativeV = [&](std::size_t i, std::size_t j) {
+			if (analytic)
+			{
+				const float* d = &derivativesV[3 * (i * columns + j)];
+				return std::array<float, 3>{ d[0], d[1], d[2] };
+			}
+			const std::size_t previous = (i > 0) ? i - 1 : (wrapV ? vSegments - 1 : 0);
+			const std::size_t next = (i < vSegments) ? i + 1 : (wrapV ? 1 : vSegments);
+			return difference(position(next, j), position(previous, j));
+		};
+		// Where a row or column collapses to a point its derivative vanishes, the neighbouring row or column gives the direction instead
+		auto frameDerivatives = [&](std::size_t i, std::size_t j) {
+			std::array<float, 3> du = derivativeU(i, j), dv = derivativeV(i, j);
+			if (internal::LengthSquared(du) <= collapsed)
+			{
+				du = derivativeU((i < vSegments) ? i + 1 : i - 1, j);
+			}
+			if (internal::LengthSquared(dv) <= collapsed)
+			{
+				dv = derivativeV(i, (j < uSegments) ? j + 1 : j - 1);
+			}
+			return std::pair<std::array<float, 3>, std::array<float, 3>>(du, dv);
+		};
+		std::vector<std::uint8_t>& chunkCollapsed = context.Scratch<std::uint8_t>(1);
+		chunkCollapsed.assign(chunks, 0);
+		// Frames and indices, split by rows again now every position is known
+		const bool flip = settings.topology == Topology::TriangleStrip && settings.windingOrder == WindingOrder::CW;
+		internal::ParallelFor(context.Workers(), rows, rowsPerChunk, [&](std::size_t begin, std::size_t end, std::uint32_t chunk) {
+			for (std::size_t i = begin; i < end; i++)
+			{
+				// A row that collapses to a point (a pole) gets one normal, the average around it, like the poles of UVSphere
+				bool pointRow = hasNormals;
+				for (std::size_t j = 1; j < columns && pointRow; j++)
+				{
+					pointRow = sameSpot(position(i, 0), position(i, j));
+				}
+				std::array<float, 3> rowNormal = { 0.0f, 0.0f, 0.0f };
+				for (std::size_t j = 0; j < columns && pointRow; j++)
+				{
+					const auto [du, dv] = frameDerivatives(i, j);
+					const std::array<float, 3> normal = internal::Cross(du, dv);
+					const float length = std::sqrtf(internal::LengthSquared(normal));
+					for (std::size_t k = 0; k < 3 && length != 0.0f; k++)
+					{
+						rowNormal[k] += normal[k] / length;
+					}
+				}
+				for (std::size_t j = 0; j < columns; j++)
+				{
+					// A collapsed edge along the row or column leaves zero area triangles to compact
+					if ((j < uSegments && sameSpot(position(i, j), position(i, j + 1))) || (i < vSegments && sameSpot(position(i, j), position(i + 1, j))))
+					{
+						chunkCollapsed[chunk] = 1;
+					}
+					if (!frame)
+					{
+						continue;
+					}
+					const auto [du, dv] = frameDerivatives(i, j);
+					const std::size_t index = i * columns + j;
+					if (hasNormals)
+					{
+						const std::array<float, 3> normal = pointRow ? rowNormal : internal::Cross(du, dv);
+						const float length = std::sqrtf(internal::LengthSquared(normal));
+						const float inverseLength = (length != 0.0f) ? 1.0f / length : 0.0f;
+						mesh.normals[3 * index + 0] = normal[0] * inverseLength;
+						mesh.normals[3 * index + 1] = normal[1] * inverseLength;
+						mesh.normals[3 * index + 2] = normal[2] * inverseLength;
+					}
+					// dp/dv is always on the positive side of normal x tangent, so the frame is right handed
+					if (hasTangents)
+					{
+						const float length = std::sqrtf(internal::LengthSquared(du));
+						const float inverseLength = (length != 0.0f) ? 1.0f / length : 0.0f;
+						mesh.tangents[4 * index + 0] = du[0] * inverseLength;
+						mesh.tangents[4 * index + 1] = du[1] * inverseLength;
+						mesh.tangents[4 * index + 2] = du[2] * inverseLength;
+						mesh.tangents[4 * index + 3] = 1.0f;
+					}
+				}
+			}
+			// Quad rows between this chunk's vertex rows and the next
+			const std::size_t quadEnd = std::min<std::size_t>(end, vSegments);
+			if (begin < quadEnd)
+			{
+				IndexType* output = mesh.indices.data() + internal::GridIndexCount(static_cast<std::uint32_t>(begin), uSegments, settings.topology);
+				internal::GridIndices<IndexType>(output, static_cast<IndexType>(begin * columns), static_cast<std::uint32_t>(quadEnd - begin), uSegments, flip, settings.topology);
+			}
+		});
+		// Remove the zero area triangles of collapsed rows and columns, strips are kept whole
+		const bool hasCollapsed = std::any_of(chunkCollapsed.begin(), chunkCollapsed.end(), [](std::uint8_t collapsedEdge) { return collapsedEdge != 0; });
+		if (hasCollapsed && mesh.topology == Topology::TriangleList)
+		{
+			Compact(mesh, context);
+		}
+		internal::ProcessMesh(mesh, settings);
+		return mesh;
+	}
+	/// <summary>
+	/// Generates the mesh of any surface p(u, v) over [0, 1] x [0, 1], using a temporary context
+	/// </summary>
+	/// <param name="uSegments">Number of quads along u</param>
+	/// <param name="vSegments">Number of quads along v</param>
+	/// <param name="surface">Callable taking a ParametricBatch& that writes the position, and optionally the partial derivatives, of each lane</param>
+	/// <param name="settings">Settings that affect how the mesh is generated</param>
+	/// <returns>Mesh data for the surface</returns>
+	template <typename IndexType = std::uint32_t, typename Surface>
+	inline BasicMesh<IndexType> Parametric(std::uint32_t uSegments, std::uint32_t vSegments, Surface&& surface, const GeneratorSetting& settings = GeneratorSetting())
+	{
+		GeneratorContext context;
+		return Parametric<IndexType>(context, uSegments, vSegments, std::forward<Surface>(surface), settings);
+	}
+}
@@ -0,0 +1,215 @@
+#pragma once
+
+#include "../internal/GeneratorSetting.hpp"
+#include "../internal/Mesh.hpp"
+#include "../internal/Parallel.hpp"
+#include "../internal/RadixSort.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Construct
+{
+	namespace internal
+	{
+		/// <summary>
+		/// Minimum number of vertices or indices per thread when reordering
+		/// </summary>
+		inline constexpr std::size_t VertexOrderParallelChunk = 1 << 16;
+		/// <summary>
+		/// Bits per axis of the space filling curve keys
+		/// </summary>
+		inline constexpr std::uint32_t CurveBits = 21;
+		/// <summary>
+		/// Spreads the low 21 bits of a value out to every third bit
+		/// </summary>
+		inline std::uint64_t SpreadBits3(std::uint64_t value)
+		{
+			value &= 0x1FFFFF;
+			value = (value | (value << 32)) & 0x001F00000000FFFFull;
+			value = (value | (value << 16)) & 0x001F0000FF0000FFull;
+			value = (value | (value << 8)) & 0x100F00F00F00F00Full;
+			value = (value | (value << 4)) & 0x10C30C30C30C30C3ull;
+			value = (value | (value << 2)) & 0x1249249249249249ull;
+			return value;
+		}
+		/// <summary>
+		/// Interleaves 3 21-bit coordinates, x takes the most significant bit of each triple
+		/// </summary>
+		inline std::uint64_t MortonKey(std::uint32_t x, std::uint32_t y, std::uint32_t z)
+		{
+			return (SpreadBits3(x) << 2) | (SpreadBits3(y) << 1) | SpreadBits3(z);
+		}
+		/// <summary>
+		/// Distance along a 3D Hilbert curve of 21 bits per axis, using Skilling's transpose
+		/// ("Programming the Hilbert curve", AIP Conference Proceedings 707, 2004)
+		/// </summary>
+		inline std::uint64_t HilbertKey(std::uint32_t x, std::uint32_t y, std::uint32_t z)
+		{
+			std::uint32_t axes[3] = { x, y, z };
+			// Inverse undo
+			for (std::uint32_t bit = CurveBits - 1; bit > 0; bit--)
+			{
+				const std::uint32_t p = (1u << bit) - 1;
+				for (std::uint32_t i = 0; i < 3; i++)
+				{
+					// If this bit of axis i is set invert the low bits of axis 0, otherwise swap the low bits of axis 0 and axis i.
+					// Written without branches as the bits are close to random
+					const std::uint32_t set = 0u - ((axes[i] >> bit) & 1u);
+					const std::uint32_t t = (axes[0] ^ axes[i]) & p & ~set;
+					axes[0] ^= (p & set) | t;
+					axes[i] ^= t;
+				}
+			}
+			// Gray encode
+			axes[1] ^= axes[0];
+			axes[2] ^= axes[1];
+			std::uint32_t t = 0;
+			for (std::uint32_t q = 1u << (CurveBits - 1); q > 1; q >>= 1)
+			{
+				if (axes[2] & q)
+				{
+					t ^= q - 1;
+				}
+			}
+			// The transposed form is the Hilbert index with its bits dealt out across the axes
+			return MortonKey(axes[0] ^ t, axes[1] ^ t, axes[2] ^ t);
+		}
+		/// <summary>
+		/// Remap from old to new vertex index that sorts vertices along a space filling curve.
+		/// Vertices are quantized into the bounding cube of the mesh, ties keep their existing order
+		/// </summary>
+		template <typename IndexType>
+		inline std::vector<IndexType> CurveVertexRemap(const BasicMesh<IndexType>& mesh, VertexOrder order)
+		{
+			const std::size_t vertexCount = mesh.vertices.size() / 3;
+			const float* vertices = mesh.vertices.data();
+			// Bounding box, reduced per chunk
+			std::vector<Bounds> chunkBounds(ChunkCount(vertexCount, VertexOrderParallelChunk));
+			ParallelFor(vertexCount, VertexOrderParallelChunk, [&](std::size_t begin, std::size_t end, std::uint32_t chunk) {
+				for (std::size_t i = begin; i < end; i++)
+				{
+					chunkBounds[chunk].Add(vertices[i * 3 + 0], vertices[i * 3 + 1], vertices[i * 3 + 2]);
+				}
+			});
+			vec3 minimum = chunkBounds[0].min, maximum = chunkBounds[0].max;
+			for (const Bounds& bounds : chunkBounds)
+			{
+				minimum = vec3(std::min(minimum.x, bounds.min.x), std::min(minimum.y, bounds.min.y), std::min(minimum.z, bounds.min.z));
+				maximum = vec3(std::max(maximum.x, bounds.max.x), std::max(maximum.y, bounds.max.y), std::max(maximum.z, bounds.max.z));
+			}
+			// A cube keeps the curve cells square, so flat and long meshes are ordered the same way as round ones
+			const float extent = std::max({ maximum.x - minimum.x, maximum.y - minimum.y, maximum.z - minimum.z });
+			const float cellsPerUnit = (extent > 0.0f) ? static_cast<float>((1u << CurveBits) - 1) / extent : 0.0f;
+			auto quantize = [&](float value, float minimumValue) {
+				return static_cast<std::uint32_t>(std::clamp((value - minimumValue) * cellsPerUnit, 0.0f, static_cast<float>((1u << CurveBits) - 1)));
+			};
+			std::vector<std::uint64_t> keys(vertexCount);
+			std::vector<IndexType> sorted(vertexCount);
+			ParallelFor(vertexCount, VertexOrderParallelChunk, [&](std::size_t begin, std::size_t end, std::uint32_t) {
+				for (std::size_t i = begin; i < end; i++)
+				{
+					const std::uint32_t x = quantize(vertices[i * 3 + 0], minimum.x);
+					const std::uint32_t y = quantize(vertices[i * 3 + 1], minimum.y);
+					const std::uint32_t z = quantize(vertices[i * 3 + 2], minimum.z);
+					keys[i] = (order == VertexOrder::Hilbert) ? HilbertKey(x, y, z) : MortonKey(x, y, z);
+					sorted[i] = static_cast<IndexType>(i);
+				}
+			});
+			RadixSort(keys, sorted);
+			// Sorted holds the old index of every new vertex, invert it
+			std::vector<IndexType> remap(vertexCount);
+			ParallelFor(vertexCount, VertexOrderParallelChunk, [&](std::size_t begin, std::size_t end, std::uint32_t) {
+				for (std::size_t i = begin; i < end; i++)
+				{
+					remap[sorted[i]] = static_cast<IndexType>(i);
+				}
+			});
+			return remap;
+		}
+		/// <summary>
+		/// Remap from old to new vertex index that stores vertices in the order the indices first reference them.
+		/// Unreferenced vertices keep their existing order after every referenced one
+		/// </summary>
+		template <typename IndexType>
+		inline std::vector<IndexType> FirstUseVertexRemap(const BasicMesh<IndexType>& mesh)
+		{
+			static constexpr IndexType Unassigned = std::numeric_limits<IndexType>::max();
+			const std::size_t vertexCount = mesh.vertices.size() / 3;
+			std::vector<IndexType> remap(vertexCount, Unassigned);
+			std::size_t nextIndex = 0;
+			for (IndexType index : mesh.indices)
+			{
+				if (index != PrimitiveRestart<IndexType> && remap[index] == Unassigned)
+				{
+					remap[index] = static_cast<IndexType>(nextIndex++);
+				}
+			}
+			for (IndexType& index : remap)
+			{
+				if (index == Unassigned)
+				{
+					index = static_cast<IndexType>(nextIndex++);
+				}
+			}
+			return remap;
+		}
+		/// <summary>
+		/// Moves every vertex to its new index and remaps the indices, remap must be a permutation
+		/// </summary>
+		template <typename IndexType>
+		inline void ApplyVertexRemap(BasicMesh<IndexType>& mesh, const std::vector<IndexType>& remap)
+		{
+			const std::size_t vertexCount = remap.size();
+			// Scatters every present attribute into a new buffer, a vertex's components are contiguous so each chunk writes whole vertices
+			auto permute = [&](std::vector<float>& attribute, std::size_t components) {
+				if (attribute.empty())
+				{
+					return;
+				}
+				std::vector<float> permuted(attribute.size());
+				ParallelFor(vertexCount, VertexOrderParallelChunk, [&](std::size_t begin, std::size_t end, std::uint32_t) {
+					for (std::size_t i = begin; i < end; i++)
+					{
+						std::copy_n(&attribute[i * components], components, &permuted[static_cast<std::size_t>(remap[i]) * components]);
+					}
+				});
+				attribute.swap(permuted);
+			};
+			permute(mesh.vertices, 3);
+			permute(mesh.normals, 3);
+			permute(mesh.textureUVs, 2);
+			permute(mesh.tangents, 4);
+			ParallelFor(mesh.indices.size(), VertexOrderParallelChunk, [&](std::size_t begin, std::size_t end, std::uint32_t) {
+				for (std::size_t i = begin; i < end; i++)
+				{
+					if (mesh.indices[i] != PrimitiveRestart<IndexType>)
+					{
+						mesh.indices[i] = remap[mesh.indices[i]];
+					}
+				}
+			});
+		}
+	}
+	/// <summary>
+	/// Reorders the vertices of a mesh in place and remaps its indices, for better cache locality in spatial queries, skinning and vertex shaders.
+	/// Curve orders run in parallel on large meshes, FirstUse is a single pass over the indices.
+	/// Generators apply this through GeneratorSetting::vertexOrder, it can also be run after Merge or Weld
+	/// </summary>
+	/// <param name="mesh">Mesh to reorder</param>
+	/// <param name="order">Order to store the vertices in</param>
+	/// <returns>Remap from old vertex index to new vertex index, empty for VertexOrder::Generated</returns>
+	template <typename IndexType>
+	inline std::vector<IndexType> ReorderVertices(BasicMesh<IndexType>& mesh, VertexOrder order)
+	{
+		if (order == VertexOrder::Generated)
+		{
+			return {};
+		}
+		std::vector<IndexType> remap = (order == VertexOrder::FirstUse) ? internal::FirstUseVertexRemap(mesh) : internal::CurveVertexRemap(mesh, order);
+		internal::ApplyVertexRemap(mesh, remap);
+		return remap;
+	}
+}
@@ -0,0 +1,358 @@
+#pragma once
+
+#include "../internal/GeneratorContext.hpp"
+#include "../internal/GeneratorSetting.hpp"
+#include "../internal/Mesh.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace Construct
+{
+	/// <summary>
+	/// Mesh whose index buffer is shared with every other mesh of the same topology, only the vertex attributes are its own.
+	/// Fields match BasicMesh
+	/// </summary>
+	template <typename IndexType>
+	struct BasicSharedMesh
+	{
+		std::vector<float> vertices;
+		/// <summary>
+		/// Index buffer shared through a TopologyRegistry, freed once the last mesh using it is gone
+		/// </summary>
+		std::shared_ptr<const std::vector<IndexType>> indices;
+		std::vector<float> normals;
+		std::vector<float> textureUVs;
+		std::vector<float> tangents;
+		Topology topology = Topology::TriangleList;
+		Bounds bounds;
+	};
+	/// <summary>
+	/// Shared mesh with 32-bit indices
+	/// </summary>
+	using SharedMesh = BasicSharedMesh<std::uint32_t>;
+	/// <summary>
+	/// Everything that decides the indices of a generated mesh, so shared indices can be found before the mesh is generated.
+	/// The index type is part of the key through the buffer it is looked up in
+	/// </summary>
+	struct TopologyKey
+	{
+		/// <summary>
+		/// Name of the generator, such as "Cylinder"
+		/// </summary>
+		std::string generator;
+		/// <summary>
+		/// Parameters of the generator that change its indices, such as the sides and cap rings of a Cylinder, unused ones are 0.
+		/// Sizes that only move vertices, such as the radius, are left out
+		/// </summary>
+		std::array<std::uint64_t, 4> parameters = {};
+		Topology topology = Topology::TriangleList;
+		WindingOrder windingOrder = WindingOrder::CCW;
+		VertexOrder vertexOrder = VertexOrder::Generated;
+		/// <summary>
+		/// Key of a generator with the given parameters and the topology, winding and vertex order of a setting.
+		/// Throws std::invalid_argument for more than 4 parameters
+		/// </summary>
+		/// <param name="generator">Name of the generator</param>
+		/// <param name="parameters">Parameters of the generator that change its indices</param>
+		/// <param name="settings">Setting the mesh is generated with</param>
+		inline TopologyKey(std::string_view generator, std::initializer_list<std::uint64_t> parameters, const GeneratorSetting& settings)
+			: generator(generator), topology(settings.topology), windingOrder(settings.windingOrder), vertexOrder(settings.vertexOrder)
+		{
+			if (parameters.size() > this->parameters.size())
+			{
+				throw std::invalid_argument("Construct: a topology key holds at most 4 parameters");
+			}
+			std::copy(parameters.begin(), parameters.end(), this->parameters.begin());
+		}
+		inline bool operator<(const TopologyKey& other) const
+		{
+			return std::tie(this->generator, this->parameters, this->topology, this->windingOrder, this->vertexOrder) < std::tie(other.generator, other.parameters, other.topology, other.windingOrder, other.vertexOrder);
+		}
+	};
+	namespace internal
+	{
+		/// <summary>
+		/// Hash of an index buffer, 8 bytes at a time
+		/// </summary>
+		template <typename IndexType>
+		inline std::uint64_t HashIndices(const std::vector<IndexType>& indices)
+		{
+			const unsigned char* bytes = reinterpret_cast<const unsigned char*>(indices.data());
+			const std::size_t size = indices.size() * sizeof(IndexType);
+			std::uint64_t hash = 14695981039346656037ull ^ size;
+			auto mix = [&](std::uint64_t word) {
+				hash = (hash ^ word) * 0x9E3779B97F4A7C15ull;
+				hash ^= hash >> 29;
+			};
+			std::size_t i = 0;
+			for (; i + 8 <= size; i += 8)
+			{
+				std::uint64_t word;
+				std::memcpy(&word, bytes + i, 8);
+				mix(word);
+			}
+			if (i < size)
+			{
+				std::uint64_t word = 0;
+				std::memcpy(&word, bytes + i, size - i);
+				mix(word);
+			}
+			return hash;
+		}
+	}
+	/// <summary>
+	/// Index buffers shared between meshes, keyed by a TopologyKey and by their contents.
+	/// Generators give every Plane, UVSphere or Cylinder with the same parameters, topology, winding and vertex order the same indices,
+	/// so sharing them leaves one copy however many meshes are kept.
+	/// Generated meshes are found by key before they are generated, arbitrary meshes by a hash of their indices.
+	/// The registry only holds weak references, a buffer is freed with the last mesh using it.
+	/// Thread safe, one registry can serve every thread
+	/// </summary>
+	class TopologyRegistry
+	{
+	public:
+		inline TopologyRegistry() = default;
+		TopologyRegistry(const TopologyRegistry&) = delete;
+		TopologyRegistry& operator=(const TopologyRegistry&) = delete;
+		/// <summary>
+		/// Finds the shared buffer with the same indices, or registers these indices as a new one.
+		/// The given buffer is moved into the new shared buffer or left for the caller to recycle
+		/// </summary>
+		/// <param name="indices">Indices to share</param>
+		/// <returns>Shared buffer holding the same indices</returns>
+		template <typename IndexType>
+		inline std::shared_ptr<const std::vector<IndexType>> Share(std::vector<IndexType>& indices)
+		{
+			const std::uint64_t hash = internal::HashIndices(indices);
+			std::lock_guard<std::mutex> lock(this->mutex);
+			std::vector<std::weak_ptr<const std::vector<IndexType>>>& candidates = std::get<Buffers<IndexType>>(this->buffers)[hash];
+			// Expired buffers are dropped as they are found
+			for (std::size_t i = 0; i < candidates.size();)
+			{
+				std::shared_ptr<const std::vector<IndexType>> candidate = candidates[i].lock();
+				if (candidate == nullptr)
+				{
+					candidates[i] = std::move(candidates.back());
+					candidates.pop_back();
+					continue;
+				}
+				if (*candidate == indices)
+				{
+					return candidate;
+				}
+				i++;
+			}
+			std::shared_ptr<const std::vector<IndexType>> shared = std::make_shared<const std::vector<IndexType>>(std::move(indices));
+			indices = std::vector<IndexType>();
+			candidates.push_back(shared);
+			return shared;
+		}
+		/// <summary>
+		/// Finds the shared buffer of a generated mesh without generating it
+		/// </summary>
+		/// <param name="key">Generator, parameters and setting of the mesh</param>
+		/// <returns>Shared buffer, or null if no mesh with that key is alive</returns>
+		template <typename IndexType>
+		inline std::shared_ptr<const std::vector<IndexType>> Find(const TopologyKey& key)
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			KeyedBuffers<IndexType>& keyed = std::get<KeyedBuffers<IndexType>>(this->keyedBuffers);
+			const auto it = keyed.find(key);
+			if (it == keyed.end())
+			{
+				return nullptr;
+			}
+			std::shared_ptr<const std::vector<IndexType>> shared = it->second.lock();
+			if (shared == nullptr)
+			{
+				keyed.erase(it);
+			}
+			return shared;
+		}
+		/// <summary>
+		/// Shares the indices of a generated mesh like Share and remembers them under its key, so later meshes with the key are found by Find
+		/// </summary>
+		/// <param name="key">Generator, parameters and setting of the mesh</param>
+		/// <param name="indices">Indices to share</param>
+		/// <returns>Shared buffer holding the same indices</returns>
+		template <typename IndexType>
+		inline std::shared_ptr<const std::vector<IndexType>> Share(const TopologyKey& key, std::vector<IndexType>& indices)
+		{
+			std::shared_ptr<const std::vector<IndexType>> shared = this->Share(indices);
+			std::lock_guard<std::mutex> lock(this->mutex);
+			std::get<KeyedBuffers<IndexType>>(this->keyedBuffers)[key] = shared;
+			return shared;
+		}
+		/// <summary>
+		/// Forgets every buffer that no mesh uses anymore
+		/// </summary>
+		inline void Prune()
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			std::apply([](auto&... maps) { (PruneBuffers(maps), ...); }, this->buffers);
+			std::apply([](auto&... maps) { (std::erase_if(maps, [](const auto& entry) { return entry.second.expired(); }), ...); }, this->keyedBuffers);
+		}
+		/// <summary>
+		/// Number of index buffers still used by a mesh
+		/// </summary>
+		inline std::size_t Count()
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			std::size_t count = 0;
+			std::apply([&](const auto&... maps) { ((count += LiveBuffers(maps, nullptr)), ...); }, this->buffers);
+			return count;
+		}
+		/// <summary>
+		/// Bytes held by the index buffers still used by a mesh, each counted once however many meshes share it
+		/// </summary>
+		inline std::size_t Bytes()
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			std::size_t bytes = 0;
+			std::apply([&](const auto&... maps) { ((LiveBuffers(maps, &bytes)), ...); }, this->buffers);
+			return bytes;
+		}
+	private:
+		template <typename IndexType>
+		using Buffers = std::unordered_map<std::uint64_t, std::vector<std::weak_ptr<const std::vector<IndexType>>>>;
+		template <typename IndexType>
+		using KeyedBuffers = std::map<TopologyKey, std::weak_ptr<const std::vector<IndexType>>>;
+		template <typename Map>
+		static inline void PruneBuffers(Map& map)
+		{
+			for (auto it = map.begin(); it != map.end();)
+			{
+				std::erase_if(it->second, [](const auto& buffer) { return buffer.expired(); });
+				it = it->second.empty() ? map.erase(it) : std::next(it);
+			}
+		}
+		template <typename Map>
+		static inline std::size_t LiveBuffers(const Map& map, std::size_t* bytes)
+		{
+			std::size_t count = 0;
+			for (const auto& [hash, candidates] : map)
+			{
+				for (const auto& candidate : candidates)
+				{
+					if (const auto buffer = candidate.lock())
+					{
+						count++;
+						if (bytes != nullptr)
+						{
+							*bytes += buffer->size() * sizeof((*buffer)[0]);
+						}
+					}
+				}
+			}
+			return count;
+		}
+		std::mutex mutex;
+		std::tuple<Buffers<std::uint16_t>, Buffers<std::uint32_t>, Buffers<std::uint64_t>> buffers;
+		// Every keyed buffer is also in buffers, so it is counted once
+		std::tuple<KeyedBuffers<std::uint16_t>, KeyedBuffers<std::uint32_t>, KeyedBuffers<std::uint64_t>> keyedBuffers;
+	};
+	/// <summary>
+	/// Moves the attributes of a mesh into a shared mesh and replaces its indices with the registry's copy.
+	/// For example ShareTopology(registry, context, Cylinder(context, 32, setting)) for every prop
+	/// </summary>
+	/// <param name="registry">Registry holding the shared index buffers</param>
+	/// <param name="context">Context that gets the index buffer back if an identical one is already shared</param>
+	/// <param name="mesh">Mesh to share, left empty</param>
+	/// <returns>Mesh with its own attributes and shared indices</returns>
+	template <typename IndexType>
+	inline BasicSharedMesh<IndexType> ShareTopology(TopologyRegistry& registry, GeneratorContext& context, BasicMesh<IndexType>&& mesh)
+	{
+		BasicSharedMesh<IndexType> shared;
+		shared.indices = registry.Share(mesh.indices);
+		context.Recycle(std::move(mesh.indices));
+		shared.vertices = std::move(mesh.vertices);
+		shared.normals = std::move(mesh.normals);
+		shared.textureUVs = std::move(mesh.textureUVs);
+		shared.tangents = std::move(mesh.tangents);
+		shared.topology = mesh.topology;
+		shared.bounds = mesh.bounds;
+		mesh = BasicMesh<IndexType>();
+		return shared;
+	}
+	/// <summary>
+	/// Moves the attributes of a mesh into a shared mesh and replaces its indices with the registry's copy
+	/// </summary>
+	/// <param name="registry">Registry holding the shared index buffers</param>
+	/// <param name="mesh">Mesh to share, left empty</param>
+	/// <returns>Mesh with its own attributes and shared indices</returns>
+	template <typename IndexType>
+	inline BasicSharedMesh<IndexType> ShareTopology(TopologyRegistry& registry, BasicMesh<IndexType>&& mesh)
+	{
+		GeneratorContext context;
+		return ShareTopology(registry, context, std::move(mesh));
+	}
+	/// <summary>
+	/// Generates a mesh straight into a shared mesh, looking its indices up by key first so a mesh whose indices are already shared doesn't build or hash them again.
+	/// Curve vertex orders depend on the transform of the setting, so those meshes fall back to sharing by content.
+	/// For example ShareTopology<std::uint32_t>(registry, context, TopologyKey("Cylinder", { 32 }, setting), setting, [&](const GeneratorSetting& s) { return Cylinder(context, 32, s); })
+	/// </summary>
+	/// <param name="registry">Registry holding the shared index buffers</param>
+	/// <param name="context">Context that gets index buffers back when they are already shared</param>
+	/// <param name="key">Generator and parameters of the mesh, made with the same setting</param>
+	/// <param name="settings">Setting to generate the mesh with</param>
+	/// <param name="generator">Generates the mesh from a setting, called once</param>
+	/// <returns>Mesh with its own attributes and shared indices</returns>
+	template <typename IndexType, typename Generator>
+	inline BasicSharedMesh<IndexType> ShareTopology(TopologyRegistry& registry, GeneratorContext& context, const TopologyKey& key, const GeneratorSetting& settings, Generator&& generator)
+	{
+		const bool keyed = settings.vertexOrder != VertexOrder::Morton && settings.vertexOrder != VertexOrder::Hilbert;
+		std::shared_ptr<const std::vector<IndexType>> indices = keyed ? registry.Find<IndexType>(key) : nullptr;
+		// First use reordering follows the indices, so they are only skipped in the generated order
+		GeneratorSetting generated = settings;
+		generated.generateIndices = indices == nullptr || settings.vertexOrder != VertexOrder::Generated;
+		BasicMesh<IndexType> mesh = generator(static_cast<const GeneratorSetting&>(generated));
+		if (indices == nullptr)
+		{
+			indices = keyed ? registry.Share(key, mesh.indices) : registry.Share(mesh.indices);
+		}
+		BasicSharedMesh<IndexType> shared;
+		shared.indices = std::move(indices);
+		context.Recycle(std::move(mesh.indices));
+		shared.vertices = std::move(mesh.vertices);
+		shared.normals = std::move(mesh.normals);
+		shared.textureUVs = std::move(mesh.textureUVs);
+		shared.tangents = std::move(mesh.tangents);
+		shared.topology = mesh.topology;
+		shared.bounds = mesh.bounds;
+		return shared;
+	}
+	/// <summary>
+	/// Copies a shared mesh into a mesh with its own indices, for the utilities that edit meshes in place
+	/// </summary>
+	/// <param name="shared">Shared mesh to copy</param>
+	/// <returns>Mesh with the same buffers</returns>
+	template <typename IndexType>
+	inline BasicMesh<IndexType> UnshareTopology(const BasicSharedMesh<IndexType>& shared)
+	{
+		BasicMesh<IndexType> mesh;
+		mesh.vertices = shared.vertices;
+		if (shared.indices != nullptr)
+		{
+			mesh.indices = *shared.indices;
+		}
+		mesh.normals = shared.normals;
+		mesh.textureUVs = shared.textureUVs;
+		mesh.tangents = shared.tangents;
+		mesh.topology = shared.topology;
+		mesh.bounds = shared.bounds;
+		return mesh;
+	}
+}
@@ -0,0 +1,552 @@
+#pragma once
+
+#include "../internal/Mesh.hpp"
+#include "../internal/GeneratorContext.hpp"
+#include "../internal/Parallel.hpp"
+#include "../internal/RadixSort.hpp"
+#include "../internal/Topology.hpp"
+#include "./Compact.hpp"
+#include "./Weld.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Construct
+{
+	/// <summary>
+	/// Statistics on what Simplify removed from a mesh
+	/// </summary>
+	struct SimplifyReport
+	{
+		/// <summary>
+		/// Triangles removed by edge collapses and clean up
+		/// </summary>
+		std::size_t removedTriangles = 0;
+		/// <summary>
+		/// Largest error of any collapse, the root mean square distance of the moved vertex from the planes of the surface it replaced, in mesh units
+		/// </summary>
+		float error = 0.0f;
+	};
+	namespace internal
+	{
+		/// <summary>
+		/// Number of points or half-edges per chunk when a simplification pass is split across threads
+		/// </summary>
+		inline constexpr std::size_t SimplifyParallelChunk = 1 << 14;
+		/// <summary>
+		/// Weight of the planes that hold borders and seams in place, relative to the surface
+		/// </summary>
+		inline constexpr float SimplifyBorderWeight = 10.0f;
+		/// <summary>
+		/// Most vertices a point can have for its collapse to be checked, points with more are kept
+		/// </summary>
+		inline constexpr std::size_t SimplifyMaxPointVertices = 32;
+		/// <summary>
+		/// Floats per quadric, the symmetric 3x3 matrix (XX, YY, ZZ, XY, XZ, YZ), the linear term, the constant and the total weight
+		/// </summary>
+		inline constexpr std::size_t QuadricSize = 11;
+		/// <summary>
+		/// Adds the squared distance to the plane n . p + d = 0 to a quadric
+		/// </summary>
+		inline void AddPlaneQuadric(float* quadric, float nx, float ny, float nz, float d, float weight)
+		{
+			quadric[0] += weight * nx * nx;
+			quadric[1] += weight * ny * ny;
+			quadric[2] += weight * nz * nz;
+			quadric[3] += weight * nx * ny;
+			quadric[4] += weight * nx * nz;
+			quadric[5] += weight * ny * nz;
+			quadric[6] += weight * nx * d;
+			quadric[7] += weight * ny * d;
+			quadric[8] += weight * nz * d;
+			quadric[9] += weight * d * d;
+			quadric[10] += weight;
+		}
+		/// <summary>
+		/// Root mean square distance of a position from the planes of 2 summed quadrics
+		/// </summary>
+		inline float QuadricError(const float* a, const float* b, const float* position)
+		{
+			float q[QuadricSize];
+			for (std::size_t k = 0; k < QuadricSize; k++)
+			{
+				q[k] = a[k] + b[k];
+			}
+			const float x = position[0], y = position[1], z = position[2];
+			const float error = q[0] * x * x + q[1] * y * y + q[2] * z * z
+				+ 2.0f * (q[3] * x * y + q[4] * x * z + q[5] * y * z)
+				+ 2.0f * (q[6] * x + q[7] * y + q[8] * z) + q[9];
+			return std::sqrtf(std::max(error, 0.0f) / std::max(q[10], std::numeric_limits<float>::min()));
+		}
+		/// <summary>
+		/// Per point flags for Simplify
+		/// </summary>
+		enum SimplifyPoint : std::uint32_t
+		{
+			/// <summary>
+			/// On an edge with only one triangle, only collapses along the border
+			/// </summary>
+			SimplifyBorder = 1 << 0,
+			/// <summary>
+			/// On a non-manifold edge, never collapses
+			/// </summary>
+			SimplifyLocked = 1 << 1,
+			/// <summary>
+			/// Its triangles changed this pass, collapsing it again has to wait for the next pass
+			/// </summary>
+			SimplifyTouched = 1 << 2,
+		};
+	}
+	/// <summary>
+	/// Reduces the triangle count of any mesh by collapsing edges in order of their quadric error, in place.
+	/// Every vertex that survives keeps its position and attributes, so normals, texture UVs and tangents stay valid.
+	/// Borders only collapse along themselves and seams in the texture UVs or normals only collapse along the seam, both are held in place by extra planes.
+	/// Each pass costs every edge in parallel, sorts them and collapses as many independent edges as it can, passes repeat until a limit is reached.
+	/// Collapses that would fold a face over or break the link condition are skipped, so the surface stays manifold and closed parts stop at a tetrahedron.
+	/// Triangle strips become triangle lists and unused vertices are removed.
+	/// Points, adjacency and quadrics live in the scratch buffers of the context
+	/// </summary>
+	/// <param name="mesh">Mesh to simplify</param>
+	/// <param name="context">Context whose scratch buffers are reused</param>
+	/// <param name="targetTriangleCount">Stop once the mesh has this many triangles or fewer</param>
+	/// <param name="maxError">Stop before a collapse would move the surface further than this, in mesh units</param>
+	/// <returns>What was removed and the largest error</returns>
+	template <typename IndexType>
+	inline SimplifyReport Simplify(BasicMesh<IndexType>& mesh, GeneratorContext& context, std::size_t targetTriangleCount, float maxError = std::numeric_limits<float>::max())
+	{
+		using namespace internal;
+		SimplifyReport report;
+		if (mesh.topology == Topology::TriangleStrip)
+		{
+			mesh.indices = ToTriangleList(mesh.indices, mesh.topology);
+			mesh.topology = Topology::TriangleList;
+		}
+		mesh.indices.resize(mesh.indices.size() / 3 * 3);
+		const std::size_t initialTriangleCount = mesh.indices.size() / 3;
+		if (initialTriangleCount <= targetTriangleCount)
+		{
+			return report;
+		}
+		const std::size_t vertexCount = mesh.vertices.size() / 3;
+		IndexType* indices = mesh.indices.data();
+		// Vertices on either side of a seam share a point, adjacency and quadrics are per point
+		std::vector<std::uint64_t>& pointOf = context.Scratch<std::uint64_t>(1);
+		WeldPoints(mesh, PointTolerance, context, pointOf);
+		const auto point = [&](std::size_t corner) { return pointOf[indices[corner]]; };
+		const auto next = [](std::size_t corner) { return (corner % 3 == 2) ? corner - 2 : corner + 1; };
+		const auto prev = [](std::size_t corner) { return (corner % 3 == 0) ? corner + 2 : corner - 1; };
+		// Drop triangles that are already degenerate between points
+		std::size_t triangleCount = 0;
+		for (std::size_t t = 0; t < initialTriangleCount; t++)
+		{
+			if (point(3 * t + 0) == point(3 * t + 1) || point(3 * t + 1) == point(3 * t + 2) || point(3 * t + 0) == point(3 * t + 2))
+			{
+				continue;
+			}
+			std::copy_n(&indices[3 * t], 3, &indices[3 * triangleCount]);
+			triangleCount++;
+		}
+		// Work in the unit cube so float quadrics keep their precision
+		Bounds box;
+		box.Add(mesh.vertices);
+		const float scale = std::max({ box.max.x - box.min.x, box.max.y - box.min.y, box.max.z - box.min.z, std::numeric_limits<float>::min() });
+		std::vector<float>& positions = context.Scratch<float>(1);
+		positions.resize(3 * vertexCount);
+		ParallelFor(vertexCount, SimplifyParallelChunk, [&](std::size_t begin, std::size_t end, std::uint32_t) {
+			for (std::size_t v = begin; v < end; v++)
+			{
+				positions[v * 3 + 0] = (mesh.vertices[v * 3 + 0] - box.min.x) / scale;
+				positions[v * 3 + 1] = (mesh.vertices[v * 3 + 1] - box.min.y) / scale;
+				positions[v * 3 + 2] = (mesh.vertices[v * 3 + 2] - box.min.z) / scale;
+			}
+		});
+		// Triangles around each point, offsets[p] to offsets[p + 1] in pointTriangles
+		std::vector<std::uint64_t>& offsets = context.Scratch<std::uint64_t>(0);
+		std::vector<std::uint64_t>& pointTriangles = context.Scratch<std::uint64_t>(2);
+		const auto buildAdjacency = [&]() {
+			offsets.assign(vertexCount + 1, 0);
+			for (std::size_t corner = 0; corner < 3 * triangleCount; corner++)
+			{
+				offsets[point(corner)]++;
+			}
+			for (std::size_t p = 1; p <= vertexCount; p++)
+			{
+				offsets[p] += offsets[p - 1];
+			}
+			// Filling backwards leaves every offset at the start of its point
+			pointTriangles.resize(3 * triangleCount);
+			for (std::size_t corner = 0; corner < 3 * triangleCount; corner++)
+			{
+				pointTriangles[--offsets[point(corner)]] = corner;
+			}
+		};
+		// Number of triangles around p with a half-edge from point start to point end
+		const auto countHalfEdges = [&](std::size_t p, std::size_t start, std::size_t end) {
+			std::size_t count = 0;
+			for (std::size_t i = offsets[p]; i < offsets[p + 1]; i++)
+			{
+				const std::size_t t = pointTriangles[i] / 3 * 3;
+				for (std::size_t k = 0; k < 3; k++)
+				{
+					count += (point(t + k) == start && point(next(t + k)) == end) ? 1 : 0;
+				}
+			}
+			return count;
+		};
+		// Whether a half-edge between vertices has a twin with the same vertices, searched around the point of its start
+		const auto hasVertexTwin = [&](std::size_t corner) {
+			const IndexType start = indices[corner], end = indices[next(corner)];
+			const std::size_t p = point(corner);
+			for (std::size_t i = offsets[p]; i < offsets[p + 1]; i++)
+			{
+				const std::size_t t = pointTriangles[i] / 3 * 3;
+				for (std::size_t k = 0; k < 3; k++)
+				{
+					if (indices[t + k] == end && indices[next(t + k)] == start)
+					{
+						return true;
+					}
+				}
+			}
+			return false;
+		};
+		buildAdjacency();
+		// Classify points and accumulate quadrics of the faces, borders and seams around them
+		std::vector<std::uint32_t>& flags = context.Scratch<std::uint32_t>(0);
+		std::vector<float>& quadrics = context.Scratch<float>(0);
+		// Area weighted normal of the surface each point stands for, summed as points collapse so folds can't build up over many collapses
+		std::vector<float>& orientations = context.Scratch<float>(2);
+		flags.assign(vertexCount, 0);
+		quadrics.assign(QuadricSize * vertexCount, 0.0f);
+		orientations.assign(3 * vertexCount, 0.0f);
+		ParallelFor(vertexCount, SimplifyParallelChunk, [&](std::size_t begin, std::size_t end, std::uint32_t) {
+			for (std::size_t p = begin; p < end; p++)
+			{
+				float* quadric = &quadrics[QuadricSize * p];
+				for (std::size_t i = offsets[p]; i < offsets[p + 1]; i++)
+				{
+					const std::size_t corner = pointTriangles[i];
+					const std::size_t after = next(corner), before = prev(corner);
+					const std::size_t outgoingForward = countHalfEdges(p, p, point(after)), outgoingReverse = countHalfEdges(p, point(after), p);
+					const std::size_t incomingForward = countHalfEdges(p, point(before), p), incomingReverse = countHalfEdges(p, p, point(before));
+					if (outgoingReverse == 0 || incomingReverse == 0)
+					{
+						flags[p] |= SimplifyBorder;
+					}
+					if (outgoingForward > 1 || outgoingReverse > 1 || incomingForward > 1 || incomingReverse > 1)
+					{
+						flags[p] |= SimplifyLocked;
+					}
+					// Face plane weighted by area
+					const float* p0 = &positions[indices[corner] * 3];
+					const float* p1 = &positions[indices[after] * 3];
+					const float* p2 = &positions[indices[before] * 3];
+					const float ux = p1[0] - p0[0], uy = p1[1] - p0[1], uz = p1[2] - p0[2];
+					const float vx = p2[0] - p0[0], vy = p2[1] - p0[1], vz = p2[2] - p0[2];
+					float nx = uy * vz - uz * vy, ny = uz * vx - ux * vz, nz = ux * vy - uy * vx;
+					const float length = std::sqrtf(nx * nx + ny * ny + nz * nz);
+					if (length == 0.0f)
+					{
+						continue;
+					}
+					orientations[3 * p + 0] += nx;
+					orientations[3 * p + 1] += ny;
+					orientations[3 * p + 2] += nz;
+					nx /= length;
+					ny /= length;
+					nz /= length;
+					AddPlaneQuadric(quadric, nx, ny, nz, -(nx * p0[0] + ny * p0[1] + nz * p0[2]), 0.5f * length);
+					// Edges without a matching twin are borders or seams, held by a plane through the edge at right angles to the face
+					for (const std::size_t edge : { corner, before })
+					{
+						if (hasVertexTwin(edge))
+						{
+							continue;
+						}
+						const float* e0 = &positions[indices[edge] * 3];
+						const float* e1 = &positions[indices[next(edge)] * 3];
+						const float ex = e1[0] - e0[0], ey = e1[1] - e0[1], ez = e1[2] - e0[2];
+						float mx = ey * nz - ez * ny, my = ez * nx - ex * nz, mz = ex * ny - ey * nx;
+						const float edgeLength = std::sqrtf(mx * mx + my * my + mz * mz);
+						if (edgeLength == 0.0f)
+						{
+							continue;
+						}
+						mx /= edgeLength;
+						my /= edgeLength;
+						mz /= edgeLength;
+						AddPlaneQuadric(quadric, mx, my, mz, -(mx * e0[0] + my * e0[1] + mz * e0[2]), SimplifyBorderWeight * edgeLength * edgeLength);
+					}
+				}
+			}
+		});
+		// Collapsed vertices point to the vertex that replaced them
+		std::vector<std::uint64_t>& vertexRemap = context.Scratch<std::uint64_t>(5);
+		vertexRemap.resize(vertexCount);
+		for (std::size_t v = 0; v < vertexCount; v++)
+		{
+			vertexRemap[v] = v;
+		}
+		std::vector<std::uint64_t>& keys = context.Scratch<std::uint64_t>(3);
+		std::vector<std::uint64_t>& candidates = context.Scratch<std::uint64_t>(4);
+		static constexpr std::uint64_t NoCollapse = std::numeric_limits<std::uint64_t>::max();
+		// Whether point from can move onto point to along the edge of a half-edge
+		const auto canCollapse = [&](std::size_t from, std::size_t to, std::size_t corner) {
+			if ((flags[from] & SimplifyLocked) != 0)
+			{
+				return false;
+			}
+			// Border points stay on the border, so both ends must be on it and the edge must be a border edge
+			if ((flags[from] & SimplifyBorder) != 0)
+			{
+				return (flags[to] & SimplifyBorder) != 0 && countHalfEdges(from, point(next(corner)), point(corner)) == 0;
+			}
+			return true;
+		};
+		bool errorReached = false;
+		std::array<std::uint64_t, SimplifyMaxPointVertices> fromVertices, toVertices;
+		std::vector<std::uint32_t>& marks = context.Scratch<std::uint32_t>(1);
+		marks.assign(vertexCount, 0);
+		std::uint32_t stamp = 0;
+		while (triangleCount > targetTriangleCount && !errorReached)
+		{
+			// Cost both directions of every half-edge, keeping the cheaper one that is allowed
+			const std::size_t halfEdgeCount = 3 * triangleCount;
+			keys.resize(halfEdgeCount);
+			candidates.resize(halfEdgeCount);
+			ParallelFor(halfEdgeCount, SimplifyParallelChunk, [&](std::size_t begin, std::size_t end, std::uint32_t) {
+				for (std::size_t corner = begin; corner < end; corner++)
+				{
+					const std::size_t a = point(corner), b = point(next(corner));
+					const float* qa = &quadrics[QuadricSize * a];
+					const float* qb = &quadrics[QuadricSize * b];
+					float best = std::numeric_limits<float>::infinity();
+					std::uint64_t candidate = NoCollapse;
+					if (canCollapse(a, b, corner))
+					{
+						best = QuadricError(qa, qb, &positions[b * 3]);
+						candidate = 2 * corner + 0;
+					}
+					if (canCollapse(b, a, corner))
+					{
+						const float error = QuadricError(qa, qb, &positions[a * 3]);
+						if (error < best)
+						{
+							best = error;
+							candidate = 2 * corner + 1;
+						}
+					}
+					// Non-negative floats sort like their bits
+					keys[corner] = (candidate == NoCollapse) ? NoCollapse : std::bit_cast<std::uint32_t>(best);
+					candidates[corner] = candidate;
+				}
+			});
+			RadixSort(keys, candidates);
+			for (std::uint32_t& flag : flags)
+			{
+				flag &= ~static_cast<std::uint32_t>(SimplifyTouched);
+			}
+			std::size_t collapses = 0;
+			for (std::size_t i = 0; i < halfEdgeCount && keys[i] != NoCollapse && triangleCount > targetTriangleCount; i++)
+			{
+				const float error = std::bit_cast<float>(static_cast<std::uint32_t>(keys[i])) * scale;
+				if (error > maxError)
+				{
+					errorReached = true;
+					break;
+				}
+				const std::size_t corner = candidates[i] / 2;
+				const std::size_t from = (candidates[i] % 2 == 0) ? point(corner) : point(next(corner));
+				const std::size_t to = (candidates[i] % 2 == 0) ? point(next(corner)) : point(corner);
+				if (((flags[from] | flags[to]) & SimplifyTouched) != 0)
+				{
+					continue;
+				}
+				// Corners as they are after the collapses already made this pass, triangles that collapsed have a repeated point
+				const auto currentPoint = [&](std::size_t c) { return pointOf[vertexRemap[indices[c]]]; };
+				const auto live = [&](std::size_t t) {
+					return currentPoint(t + 0) != currentPoint(t + 1) && currentPoint(t + 1) != currentPoint(t + 2) && currentPoint(t + 0) != currentPoint(t + 2);
+				};
+				// Mark the points around the target, the point may only share the ones across the collapsing edge with it
+				if (++stamp == 0)
+				{
+					marks.assign(vertexCount, 0);
+					stamp = 1;
+				}
+				for (std::size_t j = offsets[to]; j < offsets[to + 1]; j++)
+				{
+					const std::size_t t = pointTriangles[j] / 3 * 3;
+					if (live(t))
+					{
+						marks[currentPoint(t + 0)] = marks[currentPoint(t + 1)] = marks[currentPoint(t + 2)] = stamp;
+					}
+				}
+				// Every vertex of the point must move to the vertex it shares a triangle with, so seams collapse along themselves
+				std::size_t mapped = 0, removed = 0;
+				std::array<std::uint64_t, 2> opposites;
+				bool valid = true;
+				for (std::size_t j = offsets[from]; j < offsets[from + 1] && valid; j++)
+				{
+					const std::size_t fromCorner = pointTriangles[j];
+					const std::size_t t = fromCorner / 3 * 3;
+					const std::size_t toCorner = (currentPoint(next(fromCorner)) == to) ? next(fromCorner) : (currentPoint(prev(fromCorner)) == to) ? prev(fromCorner) : NoCollapse;
+					if (toCorner == NoCollapse || !live(t))
+					{
+						continue;
+					}
+					// More than 2 triangles on the edge is non-manifold
+					if (removed == 2)
+					{
+						valid = false;
+						break;
+					}
+					opposites[removed++] = currentPoint(t + 3 - (fromCorner - t) - (toCorner - t));
+					const std::uint64_t vertex = indices[fromCorner], target = vertexRemap[indices[toCorner]];
+					const auto existing = std::find(fromVertices.begin(), fromVertices.begin() + mapped, vertex);
+					if (existing != fromVertices.begin() + mapped)
+					{
+						valid = toVertices[existing - fromVertices.begin()] == target;
+					}
+					else if (mapped < SimplifyMaxPointVertices)
+					{
+						fromVertices[mapped] = vertex;
+						toVertices[mapped] = target;
+						mapped++;
+					}
+					else
+					{
+						valid = false;
+					}
+				}
+				// Live triangles around p that also have points a and b
+				const auto sharedTriangles = [&](std::size_t p, std::size_t a, std::size_t b) {
+					std::size_t count = 0;
+					for (std::size_t j = offsets[p]; j < offsets[p + 1]; j++)
+					{
+						const std::size_t t = pointTriangles[j] / 3 * 3;
+						const std::array<std::size_t, 3> corners = { currentPoint(t + 0), currentPoint(t + 1), currentPoint(t + 2) };
+						const bool hasA = std::find(corners.begin(), corners.end(), a) != corners.end(), hasB = std::find(corners.begin(), corners.end(), b) != corners.end();
+						count += (live(t) && hasA && hasB) ? 1 : 0;
+					}
+					return count;
+				};
+				// The rest of the link condition, an edge between the opposite points on both sides is a tetrahedron that would flatten into 2 triangles back to back,
+				// and an opposite point with border edges to both ends is a lone triangle that would vanish
+				if (valid && removed == 2)
+				{
+					valid = opposites[0] != opposites[1] && (sharedTriangles(from, opposites[0], opposites[1]) == 0 || sharedTriangles(to, opposites[0], opposites[1]) == 0);
+				}
+				else if (valid && removed == 1)
+				{
+					valid = sharedTriangles(from, opposites[0], opposites[0]) > 1 || sharedTriangles(to, opposites[0], opposites[0]) > 1;
+				}
+				for (std::size_t j = offsets[from]; j < offsets[from + 1] && valid; j++)
+				{
+					const std::size_t fromCorner = pointTriangles[j];
+					const std::size_t t = fromCorner / 3 * 3;
+					const std::size_t b = currentPoint(next(fromCorner)), c = currentPoint(prev(fromCorner));
+					if (b == to || c == to || !live(t))
+					{
+						continue;
+					}
+					// Vertices of the point that don't share a triangle with the target have nowhere to go
+					valid = std::find(fromVertices.begin(), fromVertices.begin() + mapped, indices[fromCorner]) != fromVertices.begin() + mapped;
+					// Another shared neighbour would pinch the surface into a non-manifold edge
+					for (const std::size_t neighbour : { b, c })
+					{
+						const bool opposite = (removed > 0 && opposites[0] == neighbour) || (removed > 1 && opposites[1] == neighbour);
+						valid = valid && (marks[neighbour] != stamp || opposite);
+					}
+					// Moving the point must not fold the triangle over or stand it on its edge, the normal may turn up to 60 degrees
+					// and must still face the same way as the surface the points of the triangle stand for
+					const float* p0 = &positions[from * 3];
+					const float* p1 = &positions[b * 3];
+					const float* p2 = &positions[c * 3];
+					const float* p3 = &positions[to * 3];
+					const float ux = p1[0] - p0[0], uy = p1[1] - p0[1], uz = p1[2] - p0[2], vx = p2[0] - p0[0], vy = p2[1] - p0[1], vz = p2[2] - p0[2];
+					const float sx = p1[0] - p3[0], sy = p1[1] - p3[1], sz = p1[2] - p3[2], tx = p2[0] - p3[0], ty = p2[1] - p3[1], tz = p2[2] - p3[2];
+					const float before[3] = { uy * vz - uz * vy, uz * vx - ux * vz, ux * vy - uy * vx };
+					const float after[3] = { sy * tz - sz * ty, sz * tx - sx * tz, sx * ty - sy * tx };
+					const float beforeLength = before[0] * before[0] + before[1] * before[1] + before[2] * before[2];
+					const float afterLength = after[0] * after[0] + after[1] * after[1] + after[2] * after[2];
+					valid = valid && before[0] * after[0] + before[1] * after[1] + before[2] * after[2] > 0.5f * std::sqrtf(beforeLength * afterLength);
+					float reference[3];
+					for (std::size_t k = 0; k < 3; k++)
+					{
+						reference[k] = orientations[3 * from + k] + orientations[3 * to + k] + orientations[3 * b + k] + orientations[3 * c + k];
+					}
+					const float referenceLength = reference[0] * reference[0] + reference[1] * reference[1] + reference[2] * reference[2];
+					valid = valid && after[0] * reference[0] + after[1] * reference[1] + after[2] * reference[2] > 0.25f * std::sqrtf(afterLength * referenceLength);
+				}
+				if (!valid || mapped == 0)
+				{
+					continue;
+				}
+				for (std::size_t k = 0; k < mapped; k++)
+				{
+					vertexRemap[fromVertices[k]] = toVertices[k];
+				}
+				for (std::size_t k = 0; k < QuadricSize; k++)
+				{
+					quadrics[QuadricSize * to + k] += quadrics[QuadricSize * from + k];
+				}
+				for (std::size_t k = 0; k < 3; k++)
+				{
+					orientations[3 * to + k] += orientations[3 * from + k];
+				}
+				flags[from] |= SimplifyTouched;
+				flags[to] |= SimplifyTouched;
+				triangleCount -= removed;
+				report.error = std::max(report.error, error);
+				collapses++;
+			}
+			if (collapses == 0)
+			{
+				break;
+			}
+			// Remap the collapsed vertices and drop the triangles that collapsed with them
+			std::size_t writeIndex = 0;
+			for (std::size_t corner = 0; corner < halfEdgeCount; corner += 3)
+			{
+				const IndexType i1 = static_cast<IndexType>(vertexRemap[indices[corner + 0]]),
+					i2 = static_cast<IndexType>(vertexRemap[indices[corner + 1]]),
+					i3 = static_cast<IndexType>(vertexRemap[indices[corner + 2]]);
+				if (pointOf[i1] == pointOf[i2] || pointOf[i2] == pointOf[i3] || pointOf[i1] == pointOf[i3])
+				{
+					continue;
+				}
+				indices[writeIndex + 0] = i1;
+				indices[writeIndex + 1] = i2;
+				indices[writeIndex + 2] = i3;
+				writeIndex += 3;
+			}
+			triangleCount = writeIndex / 3;
+			buildAdjacency();
+		}
+		mesh.indices.resize(3 * triangleCount);
+		// Remove the vertices that collapsed
+		Compact(mesh, context, 0.0f);
+		mesh.bounds = Bounds();
+		mesh.bounds.Add(mesh.vertices);
+		report.removedTriangles = initialTriangleCount - mesh.indices.size() / 3;
+		return report;
+	}
+	/// <summary>
+	/// Reduces the triangle count of any mesh by collapsing edges in order of their quadric error, in place, using a temporary context
+	/// </summary>
+	/// <param name="mesh">Mesh to simplify</param>
+	/// <param name="targetTriangleCount">Stop once the mesh has this many triangles or fewer</param>
+	/// <param name="maxError">Stop before a collapse would move the surface further than this, in mesh units</param>
+	/// <returns>What was removed and the largest error</returns>
+	template <typename IndexType>
+	inline SimplifyReport Simplify(BasicMesh<IndexType>& mesh, std::size_t targetTriangleCount, float maxError = std::numeric_limits<float>::max())
+	{
+		GeneratorContext context;
+		return Simplify(mesh, context, targetTriangleCount, maxError);
+	}
+}
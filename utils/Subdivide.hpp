@@ -0,0 +1,46 @@
+#pragma once
+
+#include "../internal/Mesh.hpp"
+#include "../internal/GeneratorContext.hpp"
+#include "../internal/SubdivisionEngine.hpp"
+
+namespace Construct
+{
+	/// <summary>
+	/// Subdivides every triangle of a mesh into 4, levels times, in place.
+	/// The half-edge table is built once and every level after it is derived from the previous one without hashing.
+	/// Seams in the texture UVs or normals keep their vertices split but don't tear the surface.
+	/// Texture UVs are interpolated linearly, normals are smoothed after Loop levels and tangents are recalculated.
+	/// Triangle strips become triangle lists and triangles with 2 corners at one position are dropped
+	/// </summary>
+	/// <param name="mesh">Mesh to subdivide</param>
+	/// <param name="context">Context the buffers of every level are taken from</param>
+	/// <param name="levels">Number of times to subdivide, each level multiplies the triangle count by 4</param>
+	/// <param name="scheme">Whether the surface is kept (Midpoint) or smoothed (Loop)</param>
+	template <typename IndexType>
+	inline void Subdivide(BasicMesh<IndexType>& mesh, GeneratorContext& context, std::uint32_t levels, SubdivisionScheme scheme = SubdivisionScheme::Loop)
+	{
+		if (levels == 0)
+		{
+			return;
+		}
+		internal::SubdivisionEngine<IndexType> engine(context, std::move(mesh));
+		for (std::uint32_t i = 0; i < levels; i++)
+		{
+			engine.Level(scheme);
+		}
+		mesh = engine.Finish();
+	}
+	/// <summary>
+	/// Subdivides every triangle of a mesh into 4, levels times, in place, using a temporary context
+	/// </summary>
+	/// <param name="mesh">Mesh to subdivide</param>
+	/// <param name="levels">Number of times to subdivide, each level multiplies the triangle count by 4</param>
+	/// <param name="scheme">Whether the surface is kept (Midpoint) or smoothed (Loop)</param>
+	template <typename IndexType>
+	inline void Subdivide(BasicMesh<IndexType>& mesh, std::uint32_t levels, SubdivisionScheme scheme = SubdivisionScheme::Loop)
+	{
+		GeneratorContext context;
+		Subdivide(mesh, context, levels, scheme);
+	}
+}
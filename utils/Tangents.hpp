@@ -0,0 +1,25 @@
+#pragma once
+
+#include "../internal/Mesh.hpp"
+#include "../internal/CalculateTangents.hpp"
+
+#include <stdexcept>
+
+namespace Construct
+{
+	/// <summary>
+	/// Calculates tangents for a mesh from its texture UVs, replacing any existing tangents.
+	/// Generators already emit exact tangents when VertexAttribute::Tangent is set,
+	/// this is the fallback for merged, welded or imported meshes
+	/// </summary>
+	/// <param name="mesh">Mesh with texture UVs, uses its normals if it has them</param>
+	template <typename IndexType>
+	inline void GenerateTangents(BasicMesh<IndexType>& mesh)
+	{
+		if (mesh.textureUVs.size() / 2 != mesh.vertices.size() / 3)
+		{
+			throw std::invalid_argument("Construct: tangents require a texture UV for every vertex");
+		}
+		mesh.tangents = internal::CalculateTangents(mesh.vertices, mesh.normals, mesh.textureUVs, mesh.indices, mesh.topology);
+	}
+}
@@ -0,0 +1,289 @@
+#pragma once
+
+#include "../internal/GeneratorSetting.hpp"
+#include "../internal/ProcessMesh.hpp"
+#include "../internal/PlaneVertex.hpp"
+#include "../internal/UVSphereVertex.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <ranges>
+
+namespace Construct
+{
+	/// <summary>
+	/// Every attribute of one vertex, computed on demand by a view
+	/// </summary>
+	struct ViewVertex
+	{
+		std::array<float, 3> position;
+		std::array<float, 3> normal;
+		std::array<float, 2> textureUV;
+		std::array<float, 4> tangent;
+	};
+	namespace internal
+	{
+		/// <summary>
+		/// Applies ProcessMesh to one vertex, in the same order and with the same operations
+		/// </summary>
+		inline void ProcessVertex(ViewVertex& vertex, const GeneratorSetting& settings)
+		{
+			ProcessVertex(settings, vertex.position.data(), vertex.normal.data(), vertex.tangent.data());
+		}
+		/// <summary>
+		/// Applies the winding of ProcessMesh to one triangle
+		/// </summary>
+		inline std::array<std::uint64_t, 3> ProcessTriangle(const std::array<std::uint64_t, 3>& triangle, const GeneratorSetting& settings)
+		{
+			if (settings.windingOrder == WindingOrder::CW)
+			{
+				return { triangle[2], triangle[1], triangle[0] };
+			}
+			return triangle;
+		}
+		/// <summary>
+		/// Shared range and batch interface of the views, View provides VertexCount, TriangleCount, Vertex and Triangle
+		/// </summary>
+		template <typename View>
+		struct ViewRanges
+		{
+			/// <summary>
+			/// Recommended number of vertices or triangles per batch, ranges are best split across threads in multiples of it
+			/// </summary>
+			static constexpr std::size_t BatchSize = 8;
+			/// <summary>
+			/// Random access range of every vertex, computed as it is read. The view must outlive the range
+			/// </summary>
+			inline auto Vertices() const
+			{
+				const View* view = static_cast<const View*>(this);
+				return std::views::iota(std::size_t(0), view->VertexCount()) | std::views::transform([view](std::size_t index) { return view->Vertex(index); });
+			}
+			/// <summary>
+			/// Random access range of every triangle, computed as it is read. The view must outlive the range
+			/// </summary>
+			inline auto Triangles() const
+			{
+				const View* view = static_cast<const View*>(this);
+				return std::views::iota(std::size_t(0), view->TriangleCount()) | std::views::transform([view](std::size_t index) { return view->Triangle(index); });
+			}
+			/// <summary>
+			/// Writes a run of vertices in the layout of the mesh buffers, attributes with a null output are skipped.
+			/// Runs are independent, so threads can each write their own
+			/// </summary>
+			/// <param name="first">First vertex to write</param>
+			/// <param name="count">Number of vertices to write</param>
+			/// <param name="positions">Output for 3 * count floats</param>
+			/// <param name="normals">Output for 3 * count floats, or nullptr</param>
+			/// <param name="textureUVs">Output for 2 * count floats, or nullptr</param>
+			/// <param name="tangents">Output for 4 * count floats, or nullptr</param>
+			inline void WriteVertices(std::size_t first, std::size_t count, float* positions, float* normals = nullptr, float* textureUVs = nullptr, float* tangents = nullptr) const
+			{
+				const View& view = *static_cast<const View*>(this);
+				for (std::size_t batch = 0; batch < count; batch += BatchSize)
+				{
+					// Compute a whole batch before writing it out, so the attribute writes are contiguous
+					std::array<ViewVertex, BatchSize> vertices;
+					const std::size_t batchCount = (count - batch < BatchSize) ? count - batch : BatchSize;
+					for (std::size_t i = 0; i < batchCount; i++)
+					{
+						vertices[i] = view.Vertex(first + batch + i);
+					}
+					for (std::size_t i = 0; i < batchCount; i++)
+					{
+						const std::size_t index = batch + i;
+						std::copy(vertices[i].position.begin(), vertices[i].position.end(), positions + 3 * index);
+						if (normals != nullptr)
+						{
+							std::copy(vertices[i].normal.begin(), vertices[i].normal.end(), normals + 3 * index);
+						}
+						if (textureUVs != nullptr)
+						{
+							std::copy(vertices[i].textureUV.begin(), vertices[i].textureUV.end(), textureUVs + 2 * index);
+						}
+						if (tangents != nullptr)
+						{
+							std::copy(vertices[i].tangent.begin(), vertices[i].tangent.end(), tangents + 4 * index);
+						}
+					}
+				}
+			}
+			/// <summary>
+			/// Writes a run of triangles as a triangle list, the caller must make sure the index type can address every vertex
+			/// </summary>
+			/// <param name="first">First triangle to write</param>
+			/// <param name="count">Number of triangles to write</param>
+			/// <param name="indices">Output for 3 * count indices</param>
+			template <typename IndexType>
+			inline void WriteTriangles(std::size_t first, std::size_t count, IndexType* indices) const
+			{
+				const View& view = *static_cast<const View*>(this);
+				for (std::size_t i = 0; i < count; i++)
+				{
+					const std::array<std::uint64_t, 3> triangle = view.Triangle(first + i);
+					indices[3 * i + 0] = static_cast<IndexType>(triangle[0]);
+					indices[3 * i + 1] = static_cast<IndexType>(triangle[1]);
+					indices[3 * i + 2] = static_cast<IndexType>(triangle[2]);
+				}
+			}
+		};
+	}
+	/// <summary>
+	/// Lazy view of a Plane, computes vertices and triangles on the fly instead of storing them.
+	/// Matches Plane generated with the same settings as a triangle list exactly, settings.topology and settings.attributes are ignored
+	/// </summary>
+	class PlaneView : public internal::ViewRanges<PlaneView>
+	{
+	public:
+		/// <summary>
+		/// Define a view of a Plane
+		/// </summary>
+		/// <param name="widthTiles">Number of tiles along the width</param>
+		/// <param name="heightTiles">Number of tiles along the height</param>
+		/// <param name="settings">Setting that affect how the mesh is generated</param>
+		inline PlaneView(std::uint32_t widthTiles, std::uint32_t heightTiles, const GeneratorSetting& settings = GeneratorSetting())
+			: widthTiles(widthTiles), heightTiles(heightTiles), settings(settings) {}
+		/// <summary>
+		/// Number of vertices in the view
+		/// </summary>
+		inline std::size_t VertexCount() const
+		{
+			return (static_cast<std::size_t>(this->widthTiles) + 1) * (static_cast<std::size_t>(this->heightTiles) + 1);
+		}
+		/// <summary>
+		/// Number of triangles in the view
+		/// </summary>
+		inline std::size_t TriangleCount() const
+		{
+			return 2 * static_cast<std::size_t>(this->widthTiles) * this->heightTiles;
+		}
+		/// <summary>
+		/// Calculates a vertex, in the same order as the generated mesh
+		/// </summary>
+		inline ViewVertex Vertex(std::size_t index) const
+		{
+			const std::size_t stride = static_cast<std::size_t>(this->widthTiles) + 1;
+			ViewVertex vertex;
+			internal::PlaneVertex(static_cast<std::uint32_t>(index / stride), static_cast<std::uint32_t>(index % stride), this->widthTiles, this->heightTiles,
+				vertex.position.data(), vertex.normal.data(), vertex.textureUV.data(), vertex.tangent.data());
+			internal::ProcessVertex(vertex, this->settings);
+			return vertex;
+		}
+		/// <summary>
+		/// Calculates the vertex indices of a triangle, in the same order as the generated mesh
+		/// </summary>
+		inline std::array<std::uint64_t, 3> Triangle(std::size_t index) const
+		{
+			// Two triangles per quad, wound like GridIndices
+			const std::uint64_t stride = static_cast<std::uint64_t>(this->widthTiles) + 1;
+			const std::uint64_t quad = index / 2;
+			const std::uint64_t corner = (quad / this->widthTiles) * stride + quad % this->widthTiles;
+			const std::array<std::uint64_t, 3> triangle = (index % 2 == 0) ?
+				std::array<std::uint64_t, 3>{ corner, corner + 1, corner + stride } :
+				std::array<std::uint64_t, 3>{ corner + 1, corner + stride + 1, corner + stride };
+			return internal::ProcessTriangle(triangle, this->settings);
+		}
+	private:
+		std::uint32_t widthTiles;
+		std::uint32_t heightTiles;
+		GeneratorSetting settings;
+	};
+	/// <summary>
+	/// Lazy view of a UVSphere, computes vertices and triangles on the fly instead of storing them.
+	/// Matches UVSphere generated with the same settings as a triangle list exactly, settings.topology and settings.attributes are ignored.
+	/// Like the generated list, the zero area triangles at the poles and the pole vertices they leave unused are skipped.
+	/// Needs at least 2 segments, a single segment has no area
+	/// </summary>
+	class UVSphereView : public internal::ViewRanges<UVSphereView>
+	{
+	public:
+		/// <summary>
+		/// Define a view of a UVSphere
+		/// </summary>
+		/// <param name="rings">Number of longitude lines</param>
+		/// <param name="segments">Number of latitude lines</param>
+		/// <param name="settings">Settings that affect how the mesh is generated</param>
+		inline UVSphereView(std::uint32_t rings, std::uint32_t segments, const GeneratorSetting& settings = GeneratorSetting())
+			: rings(rings), segments(segments), settings(settings) {}
+		/// <summary>
+		/// Number of vertices in the view, the first and last pole vertices are unused
+		/// </summary>
+		inline std::size_t VertexCount() const
+		{
+			// A single ring only has zero area triangles
+			if (this->rings < 2)
+			{
+				return 0;
+			}
+			return (static_cast<std::size_t>(this->rings) + 1) * (static_cast<std::size_t>(this->segments) + 1) - 2;
+		}
+		/// <summary>
+		/// Number of triangles in the view, each pole ring has one triangle per segment
+		/// </summary>
+		inline std::size_t TriangleCount() const
+		{
+			if (this->rings < 2)
+			{
+				return 0;
+			}
+			return 2 * static_cast<std::size_t>(this->segments) * (this->rings - 1);
+		}
+		/// <summary>
+		/// Calculates a vertex, in the same order as the generated mesh
+		/// </summary>
+		inline ViewVertex Vertex(std::size_t index) const
+		{
+			// Skips the unused first vertex of the north pole
+			const std::size_t gridIndex = index + 1;
+			const std::size_t stride = static_cast<std::size_t>(this->segments) + 1;
+			const internal::UVSphereRing ring = internal::UVSphereRingAt(static_cast<std::uint32_t>(gridIndex / stride), this->rings);
+			ViewVertex vertex;
+			internal::UVSphereVertex(ring, static_cast<std::uint32_t>(gridIndex % stride), this->segments,
+				vertex.position.data(), vertex.normal.data(), vertex.textureUV.data(), vertex.tangent.data());
+			internal::ProcessVertex(vertex, this->settings);
+			return vertex;
+		}
+		/// <summary>
+		/// Calculates the vertex indices of a triangle, in the same order as the generated mesh
+		/// </summary>
+		inline std::array<std::uint64_t, 3> Triangle(std::size_t index) const
+		{
+			// Quads are wound like flipped GridIndices, the north pole ring only keeps the second triangle of each quad
+			// and the south pole ring only keeps the first
+			const std::uint64_t segments = this->segments;
+			const std::uint64_t stride = segments + 1;
+			std::uint64_t row, column;
+			bool second;
+			if (index < segments)
+			{
+				row = 0;
+				column = index;
+				second = true;
+			}
+			else if (index - segments < 2 * segments * (this->rings - 2))
+			{
+				const std::uint64_t middle = index - segments;
+				row = 1 + middle / (2 * segments);
+				column = (middle % (2 * segments)) / 2;
+				second = middle % 2 == 1;
+			}
+			else
+			{
+				row = this->rings - 1;
+				column = index - segments - 2 * segments * (this->rings - 2);
+				second = false;
+			}
+			// Grid indices are shifted down by the skipped first vertex
+			const std::uint64_t corner = row * stride + column - 1;
+			const std::array<std::uint64_t, 3> triangle = second ?
+				std::array<std::uint64_t, 3>{ corner + stride, corner + stride + 1, corner + 1 } :
+				std::array<std::uint64_t, 3>{ corner + stride, corner + 1, corner };
+			return internal::ProcessTriangle(triangle, this->settings);
+		}
+	private:
+		std::uint32_t rings;
+		std::uint32_t segments;
+		GeneratorSetting settings;
+	};
+}
@@ -0,0 +1,364 @@
+#pragma once
+
+#include "../internal/Mesh.hpp"
+#include "../internal/GeneratorContext.hpp"
+#include "../internal/Parallel.hpp"
+#include "../internal/RadixSort.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Construct
+{
+	namespace internal
+	{
+		/// <summary>
+		/// Vertex count above which Weld switches to the parallel sorted grid
+		/// </summary>
+		inline constexpr std::size_t WeldParallelThreshold = 1 << 20;
+		/// <summary>
+		/// Quantized grid that vertices are bucketed into for welding.
+		/// Cells are twice the weld distance wide, so every vertex within the weld distance
+		/// lies in one of the 8 cells nearest to the vertex
+		/// </summary>
+		template <typename IndexType>
+		struct WeldGrid
+		{
+			const BasicMesh<IndexType>& mesh;
+			double inverseCellSize;
+			float positionEpsilonSquared;
+			float uvEpsilon;
+			bool hasTextureUVs;
+			bool hasTangents;
+			inline WeldGrid(const BasicMesh<IndexType>& mesh, float positionEpsilon, float uvEpsilon)
+				: mesh(mesh),
+				// Keep cells from getting so small that the quantized coordinates overflow
+				inverseCellSize(1.0 / (2.0 * std::max(positionEpsilon, 1e-7f))),
+				positionEpsilonSquared(positionEpsilon * positionEpsilon),
+				uvEpsilon(uvEpsilon),
+				hasTextureUVs(!mesh.textureUVs.empty()),
+				hasTangents(!mesh.tangents.empty())
+			{
+			}
+			/// <summary>
+			/// Packs integer cell coordinates into a key, 21 bits per axis.
+			/// Distant cells can wrap onto the same key, which only adds candidates that fail Matches
+			/// </summary>
+			static inline std::uint64_t PackCell(std::int64_t x, std::int64_t y, std::int64_t z)
+			{
+				return ((static_cast<std::uint64_t>(x) & 0x1FFFFF) << 42) | ((static_cast<std::uint64_t>(y) & 0x1FFFFF) << 21) | (static_cast<std::uint64_t>(z) & 0x1FFFFF);
+			}
+			/// <summary>
+			/// Key of the cell containing a vertex
+			/// </summary>
+			inline std::uint64_t Cell(std::size_t vertex) const
+			{
+				const float* position = &this->mesh.vertices[vertex * 3];
+				return PackCell(
+					static_cast<std::int64_t>(std::floor(position[0] * this->inverseCellSize)),
+					static_cast<std::int64_t>(std::floor(position[1] * this->inverseCellSize)),
+					static_cast<std::int64_t>(std::floor(position[2] * this->inverseCellSize)));
+			}
+			/// <summary>
+			/// Keys of the 8 cells that can contain vertices within the weld distance, the vertex's own cell is first
+			/// </summary>
+			inline std::array<std::uint64_t, 8> NeighbourCells(std::size_t vertex) const
+			{
+				std::int64_t cells[3][2];
+				for (std::uint32_t k = 0; k < 3; k++)
+				{
+					const double scaled = this->mesh.vertices[vertex * 3 + k] * this->inverseCellSize;
+					const double cell = std::floor(scaled);
+					cells[k][0] = static_cast<std::int64_t>(cell);
+					// Only the neighbour on the closer side can be within half a cell
+					cells[k][1] = cells[k][0] + ((scaled - cell < 0.5) ? -1 : 1);
+				}
+				std::array<std::uint64_t, 8> keys;
+				for (std::uint32_t i = 0; i < 8; i++)
+				{
+					keys[i] = PackCell(cells[0][(i >> 0) & 1], cells[1][(i >> 1) & 1], cells[2][(i >> 2) & 1]);
+				}
+				return keys;
+			}
+			/// <summary>
+			/// Whether two vertices are close enough to be welded
+			/// </summary>
+			inline bool Matches(std::size_t a, std::size_t b) const
+			{
+				const float* vertices = this->mesh.vertices.data();
+				const float dx = vertices[a * 3 + 0] - vertices[b * 3 + 0],
+					dy = vertices[a * 3 + 1] - vertices[b * 3 + 1],
+					dz = vertices[a * 3 + 2] - vertices[b * 3 + 2];
+				if (dx * dx + dy * dy + dz * dz > this->positionEpsilonSquared)
+				{
+					return false;
+				}
+				// Never weld across a mirrored texture seam
+				if (this->hasTangents && this->mesh.tangents[a * 4 + 3] != this->mesh.tangents[b * 4 + 3])
+				{
+					return false;
+				}
+				if (this->hasTextureUVs)
+				{
+					const float* textureUVs = this->mesh.textureUVs.data();
+					return std::abs(textureUVs[a * 2 + 0] - textureUVs[b * 2 + 0]) <= this->uvEpsilon &&
+						std::abs(textureUVs[a * 2 + 1] - textureUVs[b * 2 + 1]) <= this->uvEpsilon;
+				}
+				return true;
+			}
+		};
+		/// <summary>
+		/// For every vertex, finds the lowest earlier vertex it matches (or itself) using an open addressing hash of grid cells
+		/// </summary>
+		template <typename IndexType>
+		inline std::vector<IndexType> WeldTargetsHashed(const WeldGrid<IndexType>& grid)
+		{
+			static constexpr IndexType Empty = std::numeric_limits<IndexType>::max();
+			const IndexType vertexCount = static_cast<IndexType>(grid.mesh.vertices.size() / 3);
+			// Cell key to most recently added vertex, vertices in a cell are chained through next
+			const std::size_t capacity = std::bit_ceil(2 * static_cast<std::size_t>(vertexCount) + 1);
+			const std::uint32_t shift = 64 - static_cast<std::uint32_t>(std::countr_zero(capacity));
+			std::vector<std::uint64_t> tableKeys(capacity);
+			std::vector<IndexType> tableHeads(capacity, Empty);
+			std::vector<IndexType> next(vertexCount, Empty);
+			auto slot = [&](std::uint64_t key) {
+				std::size_t index = static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ull) >> shift);
+				while (tableHeads[index] != Empty && tableKeys[index] != key)
+				{
+					index = (index + 1) & (capacity - 1);
+				}
+				return index;
+			};
+			std::vector<IndexType> targets(vertexCount);
+			for (IndexType v = 0; v < vertexCount; v++)
+			{
+				const std::array<std::uint64_t, 8> cells = grid.NeighbourCells(v);
+				IndexType target = v;
+				for (std::uint64_t cell : cells)
+				{
+					for (IndexType u = tableHeads[slot(cell)]; u != Empty; u = next[u])
+					{
+						if (u < target && grid.Matches(u, v))
+						{
+							target = u;
+						}
+					}
+				}
+				targets[v] = target;
+				// Add to its own cell
+				const std::size_t own = slot(cells[0]);
+				tableKeys[own] = cells[0];
+				next[v] = tableHeads[own];
+				tableHeads[own] = v;
+			}
+			return targets;
+		}
+		/// <summary>
+		/// Same as WeldTargetsHashed, but radix sorts vertices by cell and searches the neighbouring cells in parallel
+		/// </summary>
+		template <typename IndexType>
+		inline std::vector<IndexType> WeldTargetsSorted(const WeldGrid<IndexType>& grid)
+		{
+			const std::size_t vertexCount = grid.mesh.vertices.size() / 3;
+			std::vector<std::uint64_t> keys(vertexCount);
+			std::vector<IndexType> order(vertexCount);
+			ParallelFor(vertexCount, 1 << 14, [&](std::size_t begin, std::size_t end, std::uint32_t) {
+				for (std::size_t i = begin; i < end; i++)
+				{
+					keys[i] = grid.Cell(i);
+					order[i] = static_cast<IndexType>(i);
+				}
+			});
+			// Stable, so vertices within a cell stay in ascending order
+			RadixSort(keys, order);
+			std::vector<IndexType> targets(vertexCount);
+			ParallelFor(vertexCount, 1 << 14, [&](std::size_t begin, std::size_t end, std::uint32_t) {
+				for (std::size_t i = begin; i < end; i++)
+				{
+					const IndexType v = static_cast<IndexType>(i);
+					IndexType target = v;
+					for (std::uint64_t cell : grid.NeighbourCells(v))
+					{
+						const auto first = std::lower_bound(keys.begin(), keys.end(), cell);
+						for (std::size_t j = first - keys.begin(); j < vertexCount && keys[j] == cell && order[j] < target; j++)
+						{
+							if (grid.Matches(order[j], v))
+							{
+								target = order[j];
+								break;
+							}
+						}
+					}
+					targets[v] = target;
+				}
+			});
+			return targets;
+		}
+		/// <summary>
+		/// Default tolerance of WeldPoints, relative to the largest coordinate
+		/// </summary>
+		inline constexpr float PointTolerance = 1e-6f;
+		/// <summary>
+		/// Hash of a directed edge between 2 points
+		/// </summary>
+		inline std::uint64_t PointPairHash(std::uint64_t start, std::uint64_t end)
+		{
+			const std::uint64_t seed = (start * 0x9e3779b97f4a7c15ull + end) * 0x9e3779b97f4a7c15ull;
+			return seed ^ (seed >> 32);
+		}
+		/// <summary>
+		/// Maps every vertex to the first vertex at the same position, within tolerance times the largest coordinate (at least 1).
+		/// Generators compute the vertices on either side of a seam separately, so they can be a rounding error apart.
+		/// Uses 64-bit scratch slots 0, 2 and 3 of the context, so pointOf can be slot 1
+		/// </summary>
+		template <typename IndexType>
+		inline void WeldPoints(const BasicMesh<IndexType>& mesh, float tolerance, GeneratorContext& context, std::vector<std::uint64_t>& pointOf)
+		{
+			const std::size_t vertexCount = mesh.vertices.size() / 3;
+			float extent = 1.0f;
+			for (float value : mesh.vertices)
+			{
+				extent = std::max(extent, std::abs(value));
+			}
+			const WeldGrid<IndexType> grid(mesh, tolerance * extent, 0.0f);
+			// Open addressing table from a grid cell to its most recently added point plus one, points in a cell are chained through nextPoint
+			std::vector<std::uint64_t>& cellKeys = context.Scratch<std::uint64_t>(0);
+			std::vector<std::uint64_t>& cellHeads = context.Scratch<std::uint64_t>(2);
+			std::vector<std::uint64_t>& nextPoint = context.Scratch<std::uint64_t>(3);
+			std::size_t tableSize = 16;
+			while (tableSize < 2 * vertexCount)
+			{
+				tableSize *= 2;
+			}
+			cellKeys.resize(tableSize);
+			cellHeads.assign(tableSize, 0);
+			nextPoint.resize(vertexCount);
+			const auto slot = [&](std::uint64_t cell) {
+				std::size_t index = PointPairHash(cell, 0) & (tableSize - 1);
+				while (cellHeads[index] != 0 && cellKeys[index] != cell)
+				{
+					index = (index + 1) & (tableSize - 1);
+				}
+				return index;
+			};
+			const float* vertices = mesh.vertices.data();
+			pointOf.resize(vertexCount);
+			for (std::size_t v = 0; v < vertexCount; v++)
+			{
+				const std::array<std::uint64_t, 8> cells = grid.NeighbourCells(v);
+				std::size_t point = v;
+				for (std::uint64_t cell : cells)
+				{
+					for (std::uint64_t u = cellHeads[slot(cell)]; u != 0; u = nextPoint[u - 1])
+					{
+						const float dx = vertices[(u - 1) * 3 + 0] - vertices[v * 3 + 0],
+							dy = vertices[(u - 1) * 3 + 1] - vertices[v * 3 + 1],
+							dz = vertices[(u - 1) * 3 + 2] - vertices[v * 3 + 2];
+						if (u - 1 < point && dx * dx + dy * dy + dz * dz <= grid.positionEpsilonSquared)
+						{
+							point = u - 1;
+						}
+					}
+				}
+				pointOf[v] = point;
+				if (point == v)
+				{
+					const std::size_t own = slot(cells[0]);
+					cellKeys[own] = cells[0];
+					nextPoint[v] = cellHeads[own];
+					cellHeads[own] = v + 1;
+				}
+			}
+		}
+	}
+	/// <summary>
+	/// Welds vertices that are within positionEpsilon of each other and have texture UVs within uvEpsilon, in place.
+	/// Each vertex is welded to the lowest indexed vertex it matches, and takes on all of that vertex's attributes.
+	/// Vertices with opposite tangent handedness are never welded.
+	/// Triangles that collapse are kept, run Compact afterwards to remove them.
+	/// Large meshes are welded in parallel, both paths give identical results
+	/// </summary>
+	/// <param name="mesh">Mesh to weld</param>
+	/// <param name="positionEpsilon">Maximum distance between welded vertices</param>
+	/// <param name="uvEpsilon">Maximum difference of each texture UV component between welded vertices, ignored if the mesh has no texture UVs</param>
+	/// <returns>Remap from old vertex index to new vertex index</returns>
+	template <typename IndexType>
+	inline std::vector<IndexType> Weld(BasicMesh<IndexType>& mesh, float positionEpsilon = 1e-5f, float uvEpsilon = 1e-5f)
+	{
+		const IndexType vertexCount = static_cast<IndexType>(mesh.vertices.size() / 3);
+		const internal::WeldGrid<IndexType> grid(mesh, positionEpsilon, uvEpsilon);
+		std::vector<IndexType> remap = (vertexCount >= internal::WeldParallelThreshold && internal::HardwareThreads() > 1)
+			? internal::WeldTargetsSorted(grid)
+			: internal::WeldTargetsHashed(grid);
+		// Targets always point to an earlier vertex, so they can be resolved to new indices in one ascending pass
+		const bool hasNormals = !mesh.normals.empty();
+		const bool hasTextureUVs = !mesh.textureUVs.empty();
+		const bool hasTangents = !mesh.tangents.empty();
+		std::size_t nextIndex = 0;
+		for (IndexType v = 0; v < vertexCount; v++)
+		{
+			if (remap[v] != v)
+			{
+				remap[v] = remap[remap[v]];
+				continue;
+			}
+			remap[v] = static_cast<IndexType>(nextIndex);
+			// Move attributes down, a vertex never moves up so this is safe in place
+			for (std::uint32_t k = 0; k < 3; k++)
+			{
+				mesh.vertices[nextIndex * 3 + k] = mesh.vertices[static_cast<std::size_t>(v) * 3 + k];
+			}
+			if (hasNormals)
+			{
+				for (std::uint32_t k = 0; k < 3; k++)
+				{
+					mesh.normals[nextIndex * 3 + k] = mesh.normals[static_cast<std::size_t>(v) * 3 + k];
+				}
+			}
+			if (hasTextureUVs)
+			{
+				for (std::uint32_t k = 0; k < 2; k++)
+				{
+					mesh.textureUVs[nextIndex * 2 + k] = mesh.textureUVs[static_cast<std::size_t>(v) * 2 + k];
+				}
+			}
+			if (hasTangents)
+			{
+				for (std::uint32_t k = 0; k < 4; k++)
+				{
+					mesh.tangents[nextIndex * 4 + k] = mesh.tangents[static_cast<std::size_t>(v) * 4 + k];
+				}
+			}
+			nextIndex++;
+		}
+		mesh.vertices.resize(3 * nextIndex);
+		if (hasNormals)
+		{
+			mesh.normals.resize(3 * nextIndex);
+		}
+		if (hasTextureUVs)
+		{
+			mesh.textureUVs.resize(2 * nextIndex);
+		}
+		if (hasTangents)
+		{
+			mesh.tangents.resize(4 * nextIndex);
+		}
+		// Remap indices
+		internal::ParallelFor(mesh.indices.size(), 1 << 16, [&](std::size_t begin, std::size_t end, std::uint32_t) {
+			for (std::size_t i = begin; i < end; i++)
+			{
+				if (mesh.indices[i] != PrimitiveRestart<IndexType>)
+				{
+					mesh.indices[i] = remap[mesh.indices[i]];
+				}
+			}
+		});
+		return remap;
+	}
+}